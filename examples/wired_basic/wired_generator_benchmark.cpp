@@ -0,0 +1,77 @@
+// Copyright (C) 2025 IDA
+//
+// This file is part of a project licensed under the GNU Lesser General Public License v3.0.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+
+#include <iostream>
+#include <string>
+
+#include <rscmng/utils/log.hpp>
+#include <rscmng/utils/config_reader.hpp>
+#include <rscmng/utils/realtime_profile.hpp>
+
+#include <rscmng/generator_benchmark.hpp>
+
+
+using namespace rscmng;
+using namespace traffic_generator;
+using namespace config;
+
+
+/*
+*
+*/
+int main(int argc, char* argv[])
+{
+    RM_logInfo("Traffic generator benchmark is starting...")
+    rscmng::init_rm_file_log(std::string("generator_benchmark_"), " ");
+
+
+    // read input
+    if (argc < 2 || argc > 3)
+    {
+        std::cerr << "Require endnode ID and optionally the objects per measurement" << std::endl;
+        return 1;
+    }
+    std::string host_name = argv[1];
+
+
+    // load config
+    ConfigReader config_reader;
+    struct rscmng::config::unit_settings client_configuration = config_reader.load_unit_settings(host_name, DEFAULT_CONFIG);
+    struct rscmng::config::experiment_parameter experiment_parameter = config_reader.load_experiment_settings(DEFAULT_CONFIG);
+    config_reader.print_unit(client_configuration);
+    RM_logInfo("Load config done.")
+
+    // Lock and prefault memory before the generator and sink threads start
+    RealtimeProfile::instance().configure(client_configuration.realtime_profile);
+
+    struct benchmark_settings settings;
+    if (argc == 3)
+    {
+        settings.objects = std::stoi(argv[2]);
+    }
+    if (!client_configuration.rm_control_local_ip.empty())
+    {
+        settings.sink_ip = client_configuration.rm_control_local_ip[0];
+    }
+
+    GeneratorBenchmark benchmark(client_configuration, experiment_parameter, settings);
+    std::vector<struct benchmark_result> results = benchmark.run();
+    benchmark.report(results);
+
+    return 0;
+}
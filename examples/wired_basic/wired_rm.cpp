@@ -22,9 +22,12 @@
 #include <thread>
 #include <chrono>
 #include <memory>
+#include <csignal>
+#include <pthread.h>
 
 #include <rscmng/utils/log.hpp>
 #include <rscmng/utils/config_reader.hpp>
+#include <rscmng/utils/realtime_profile.hpp>
 #include <rscmng/attributes/demonstrator_config.hpp>
 #include <rscmng/abstraction/socket_endpoint.hpp>
 
@@ -102,6 +105,15 @@ int main(int argc, char* argv[])
     network_configuration.endnode_configuration_map = endnode_configuration_map;
     //network_configuration.scenario_config = 1;
 
+    // SIGUSR1 logs a snapshot of the sink statistics, blocked before any thread starts so only the statistics thread takes it
+    sigset_t statistics_signal;
+    sigemptyset(&statistics_signal);
+    sigaddset(&statistics_signal, SIGUSR1);
+    pthread_sigmask(SIG_BLOCK, &statistics_signal, nullptr);
+
+    // Lock and prefault memory before the handler, timer and sink threads start
+    RealtimeProfile::instance().configure(local_rm_configuration.realtime_profile);
+
     SafeQueue<rscmng::wired::RMMessage> aRM_nRM_queue;
     SafeQueue<rscmng::wired::RMMessage> nRM_aRM_queue;
 
@@ -118,31 +130,84 @@ int main(int argc, char* argv[])
     );
     RM_logInfo("NetRM running.")
 
+    traffic_sink_parameter sink_parameter;
+    sink_parameter.receive_backend = receive_backend_from_string(local_rm_configuration.receive_backend);
+    sink_parameter.batch_size = local_rm_configuration.receive_batch_size;
+    sink_parameter.gro = local_rm_configuration.receive_gro;
+    sink_parameter.rx_timestamp = rx_timestamp_mode_from_string(local_rm_configuration.receive_timestamping);
+    sink_parameter.shards = local_rm_configuration.receive_shards;
+    sink_parameter.shard_steering = local_rm_configuration.receive_shard_steering;
+    sink_parameter.kernel_poll_interval = local_rm_configuration.receive_kernel_poll_interval;
+    // The KERNEL backend has no readable sockets, its ports keep a sleeping poll thread each
+    if (local_rm_configuration.receive_event_loop && sink_parameter.receive_backend != RECEIVE_KERNEL)
+    {
+        // One epoll pool for the ports of all sinks instead of a blocking thread per port
+        sink_parameter.event_loop = std::make_shared<SinkEventLoop>(local_rm_configuration.receive_event_threads);
+    }
+    for (const auto& service_modes : service_configuration_map)
+    {
+        for (const auto& mode : service_modes.second)
+        {
+            // Every mode may send under its own service id, modes sharing one are tracked with the longest deadline
+            int64_t deadline_ns = static_cast<int64_t>(mode.second.deadline) * 1000000L;
+            auto deadline_entry = sink_parameter.service_deadlines_ns.find(mode.second.service_id);
+            if (deadline_entry == sink_parameter.service_deadlines_ns.end() || deadline_entry->second < deadline_ns)
+            {
+                sink_parameter.service_deadlines_ns[mode.second.service_id] = deadline_ns;
+            }
+
+            const struct rscmng::config::traffic_model_settings& traffic_model = mode.second.traffic_model;
+            if (traffic_model.type == "TRACE" || traffic_model.size_distribution != "CONSTANT")
+            {
+                sink_parameter.variable_size_services.insert(mode.second.service_id);
+            }
+        }
+    }
+
 
     TrafficSink sink_ip1(
         local_rm_configuration.service_local_ip[0], 
         local_rm_configuration.service_local_port, 
-        cv_traffic_sink_notification);
+        cv_traffic_sink_notification,
+        sink_parameter);
 
     TrafficSink sink_ip2(   
         local_rm_configuration.service_local_ip[1], 
         local_rm_configuration.service_local_port, 
-        cv_traffic_sink_notification);
+        cv_traffic_sink_notification,
+        sink_parameter);
 
     TrafficSink sink_ip3(   
         local_rm_configuration.service_local_ip[2], 
         local_rm_configuration.service_local_port, 
-        cv_traffic_sink_notification);
+        cv_traffic_sink_notification,
+        sink_parameter);
  
     TrafficSink sink_ip4(   
         local_rm_configuration.service_local_ip[3], 
         local_rm_configuration.service_local_port, 
-        cv_traffic_sink_notification);
+        cv_traffic_sink_notification,
+        sink_parameter);
 
     TrafficSink sink_ip5(   
         local_rm_configuration.service_local_ip[4], 
         local_rm_configuration.service_local_port, 
-        cv_traffic_sink_notification);
+        cv_traffic_sink_notification,
+        sink_parameter);
+
+    std::thread statistics_thread([&]()
+    {
+        int signal_number;
+        while (sigwait(&statistics_signal, &signal_number) == 0)
+        {
+            sink_ip1.print_statistics();
+            sink_ip2.print_statistics();
+            sink_ip3.print_statistics();
+            sink_ip4.print_statistics();
+            sink_ip5.print_statistics();
+        }
+    });
+    statistics_thread.detach();
 
     // join threads
     //aRM.join();
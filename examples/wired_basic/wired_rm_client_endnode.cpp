@@ -25,15 +25,20 @@
 #include <unistd.h>
 #include <mutex>
 #include <condition_variable>
+#include <vector>
+#include <map>
+#include <memory>
 
 
 #include <rscmng/utils/log.hpp>
 #include <rscmng/utils/config_reader.hpp>
+#include <rscmng/utils/realtime_profile.hpp>
 #include <rscmng/rm_communication.hpp>
 #include <rscmng/rm_abstraction.hpp>
 #include <rscmng/protocols/rm_wired_payload.hpp>
 
 #include <rscmng/traffic_generator.hpp>
+#include <rscmng/transmit_scheduler.hpp>
 
 
 using namespace std::chrono;
@@ -46,6 +51,8 @@ using namespace config;
 
 bool active = true;
 bool init_done = false;
+// services that have not received their exit message yet
+uint32_t running_services = 0;
 
 // CV for rm communication
 std::condition_variable cv_rm_notification;
@@ -53,19 +60,87 @@ std::condition_variable cv_traffic_generator_notification;
 std::mutex cv_mutex;
 
 
+/**
+ * @brief Notifies one service, either its own traffic generator thread or its entry in the shared transmit scheduler
+ *
+ */
+class ServiceTransmitter
+{
+    public:
+
+    explicit ServiceTransmitter(TrafficGenerator* generator)
+    :
+        generator(generator),
+        scheduler(nullptr),
+        service_index(0)
+    {
+    }
+
+    ServiceTransmitter(TransmitScheduler* scheduler, uint32_t service_index)
+    :
+        generator(nullptr),
+        scheduler(scheduler),
+        service_index(service_index)
+    {
+    }
+
+    void notify_generator(TrafficSourceControl state)
+    {
+        if (generator)
+        {
+            generator->notify_generator(state);
+        }
+        else
+        {
+            scheduler->notify_service(service_index, state);
+        }
+    }
+
+    void notify_generator_mode_change(TrafficSourceControl state, uint32_t mode)
+    {
+        if (generator)
+        {
+            generator->notify_generator_mode_change(state, mode);
+        }
+        else
+        {
+            scheduler->notify_service_mode_change(service_index, state, mode);
+        }
+    }
+
+    void notify_generator_timestamp(TrafficSourceControl state, struct timespec timestamp, uint32_t mode, bool update_period)
+    {
+        if (generator)
+        {
+            generator->notify_generator_timestamp(state, timestamp, mode, update_period);
+        }
+        else
+        {
+            scheduler->notify_service_timestamp(service_index, state, timestamp, mode, update_period);
+        }
+    }
+
+    private:
+
+    TrafficGenerator* generator;
+    TransmitScheduler* scheduler;
+    uint32_t service_index;
+};
+
+
 void handle_message(MessageNet_t received_payload);
-void handle_start_message(MessageNet_t received_payload, TrafficGenerator &traffic_generator, uint32_t mode);
-void handle_stop_message(MessageNet_t received_payload, TrafficGenerator &traffic_generator);
-void handle_reconfigure_message(MessageNet_t received_payload, TrafficGenerator &traffic_generator, uint32_t mode);
-void handle_exit_message(MessageNet_t received_payload, TrafficGenerator &traffic_generator);
-void handle_sync_reconfigure_hw_message(MessageNet_t received_payload, TrafficGenerator &traffic_generator, uint32_t mode);
-void handle_sync_reconfigure_sw_message(MessageNet_t received_payload, TrafficGenerator &traffic_generator, uint32_t mode);
-
-void handle_sync_start_message(MessageNet_t received_payload, TrafficGenerator &traffic_generator, uint32_t mode);
-void handle_sync_stop_message(MessageNet_t received_payload, TrafficGenerator &traffic_generator);
-void handle_sync_exit_message(MessageNet_t received_payload, TrafficGenerator &traffic_generator);
-void handle_sync_reconfigure_sync_object_hw_message(MessageNet_t received_payload, TrafficGenerator &traffic_generator, uint32_t mode);
-void handle_sync_reconfigure_sync_object_sw_message(MessageNet_t received_payload, TrafficGenerator &traffic_generator, uint32_t mode);
+void handle_start_message(MessageNet_t received_payload, ServiceTransmitter &traffic_generator, uint32_t mode);
+void handle_stop_message(MessageNet_t received_payload, ServiceTransmitter &traffic_generator);
+void handle_reconfigure_message(MessageNet_t received_payload, ServiceTransmitter &traffic_generator, uint32_t mode);
+void handle_exit_message(MessageNet_t received_payload, ServiceTransmitter &traffic_generator);
+void handle_sync_reconfigure_hw_message(MessageNet_t received_payload, ServiceTransmitter &traffic_generator, uint32_t mode);
+void handle_sync_reconfigure_sw_message(MessageNet_t received_payload, ServiceTransmitter &traffic_generator, uint32_t mode);
+
+void handle_sync_start_message(MessageNet_t received_payload, ServiceTransmitter &traffic_generator, uint32_t mode);
+void handle_sync_stop_message(MessageNet_t received_payload, ServiceTransmitter &traffic_generator);
+void handle_sync_exit_message(MessageNet_t received_payload, ServiceTransmitter &traffic_generator);
+void handle_sync_reconfigure_sync_object_hw_message(MessageNet_t received_payload, ServiceTransmitter &traffic_generator, uint32_t mode);
+void handle_sync_reconfigure_sync_object_sw_message(MessageNet_t received_payload, ServiceTransmitter &traffic_generator, uint32_t mode);
 
 std::chrono::steady_clock::time_point timespec_to_steady(const struct timespec& timestamp);
 
@@ -96,28 +171,42 @@ int main(int argc, char* argv[])
 
 
     // read input
-    if (argc != 3)
+    if (argc < 3)
     {
-        std::cerr << "Require endnode ID and service ID" << std::endl;
+        std::cerr << "Require endnode ID and at least one service ID" << std::endl;
         return 1;
     }
     std::string host_name = argv[1];
-    uint32_t service_id_int = std::stoi(argv[2]);
+    std::vector<uint32_t> service_ids;
+    for (int argument = 2; argument < argc; ++argument)
+    {
+        service_ids.push_back(std::stoi(argv[argument]));
+    }
 
 
     // load config
     ConfigReader config_reader;
     struct rscmng::config::unit_settings client_configuration  = config_reader.load_unit_settings(host_name, DEFAULT_CONFIG);
-    std::map<uint32_t, struct rscmng::config::service_settings> service_configuration = config_reader.load_service_settings(service_id_int, DEFAULT_CONFIG);
+    // service ID <mode, settings>
+    std::map<uint32_t, std::map<uint32_t, struct rscmng::config::service_settings>> service_configurations;
+    for (const auto& service_id_int : service_ids)
+    {
+        service_configurations[service_id_int] = config_reader.load_service_settings(service_id_int, DEFAULT_CONFIG);
+    }
     struct rscmng::config::experiment_parameter experiment_parameter = config_reader.load_experiment_settings(DEFAULT_CONFIG);
 
     config_reader.print_unit(client_configuration);
-    config_reader.print_service(service_configuration);
+    for (auto& service_configuration : service_configurations)
+    {
+        config_reader.print_service(service_configuration.second);
+    }
     RM_logInfo("Load config done.") 
 
+    // Lock and prefault memory before the generator thread starts
+    RealtimeProfile::instance().configure(client_configuration.realtime_profile);
+
     // initialize variables
     uint32_t client_id = client_configuration.client_id;
-    serviceID_t service_id = static_cast<serviceID_t>(service_id_int);
     // Storage for payload sent to RM
     MessageNet_t rm_payload_sendout;
     // payload
@@ -128,29 +217,65 @@ int main(int argc, char* argv[])
     // Initialize RM client
     RMAbstraction rm_client(client_configuration, cv_rm_notification);
 
-    traffic_generator_parameter traffic_pattern;
-    traffic_pattern.info_flag = false;
-    traffic_pattern.period = std::chrono::milliseconds(service_configuration[0].deadline);
-    traffic_pattern.object_size_kb = service_configuration[0].object_size;
-    traffic_pattern.inter_object_gap = service_configuration[0].inter_object_gap;
-    traffic_pattern.inter_packet_gap = service_configuration[0].inter_packet_gap;
-
-    TrafficSourceType traffic_source_type = TrafficSourceType::OBJECT_BURST_DYNAMIC_CHANGE;
-    TrafficGenerator traffic_generator(service_configuration, client_configuration, experiment_parameter, traffic_source_type, traffic_pattern);
-
-    struct rscmng::config::service_settings service_setting_mode_0 = service_configuration[0];
-    rscmng::rm_wired_basic_protocol::RMPayload::network_resource_request client_resources_request_mode_0;
-    client_resources_request_mode_0.client_id = client_configuration.client_id;
-    client_resources_request_mode_0.service_id = service_setting_mode_0.service_id;
-    client_resources_request_mode_0.data_path = service_setting_mode_0.data_path;
-    client_resources_request_mode_0.priority = service_setting_mode_0.service_priority;
-    client_resources_request_mode_0.bandwidth = service_setting_mode_0.object_size;
-    client_resources_request_mode_0.deadline = std::chrono::milliseconds(service_setting_mode_0.deadline);
+    // Transmit settings shared by all services
+    traffic_generator_parameter transmit_pattern;
+    transmit_pattern.info_flag = false;
+    transmit_pattern.pacing_strategy = rscmng::PACING_SLEEP_SPIN;
+    transmit_pattern.pacing_spin_margin = client_configuration.pacing_spin_margin;
+    transmit_pattern.transmit_backend = transmit_backend_from_string(client_configuration.transmit_backend);
+    transmit_pattern.batch_size = client_configuration.transmit_batch_size;
+    transmit_pattern.txtime_lead = client_configuration.txtime_lead;
+    transmit_pattern.txtime_log_only = client_configuration.txtime_log_only;
+    transmit_pattern.tx_timestamping = client_configuration.tx_timestamping;
+    transmit_pattern.message_version = rscmng::data_message_version_from_number(client_configuration.data_message_version);
+
+    // Either one traffic generator thread per service or all services on the workers of one transmit scheduler
+    std::vector<std::unique_ptr<TrafficGenerator>> traffic_generators;
+    std::unique_ptr<TransmitScheduler> transmit_scheduler;
+    std::map<serviceID_t, ServiceTransmitter> service_transmitters;
+    if (client_configuration.transmit_scheduler > 0)
+    {
+        transmit_scheduler.reset(new TransmitScheduler(
+            client_configuration,
+            experiment_parameter,
+            client_configuration.transmit_scheduler,
+            transmit_pattern
+        ));
+        for (auto& service_configuration : service_configurations)
+        {
+            uint32_t service_index = transmit_scheduler->add_service(service_configuration.second);
+            service_transmitters.emplace(static_cast<serviceID_t>(service_configuration.first), ServiceTransmitter(transmit_scheduler.get(), service_index));
+        }
+    }
+    else
+    {
+        for (auto& service_configuration : service_configurations)
+        {
+            struct rscmng::config::service_settings& service_setting = service_configuration.second[0];
+            traffic_generator_parameter traffic_pattern = transmit_pattern;
+            traffic_pattern.period = std::chrono::milliseconds(service_setting.deadline);
+            traffic_pattern.object_size_kb = service_setting.object_size;
+            traffic_pattern.inter_object_gap = service_setting.inter_object_gap;
+            traffic_pattern.inter_packet_gap = service_setting.inter_packet_gap;
+
+            TrafficSourceType traffic_source_type = TrafficSourceType::OBJECT_BURST_DYNAMIC_CHANGE;
+            traffic_generators.emplace_back(new TrafficGenerator(service_configuration.second, client_configuration, experiment_parameter, traffic_source_type, traffic_pattern));
+            service_transmitters.emplace(static_cast<serviceID_t>(service_configuration.first), ServiceTransmitter(traffic_generators.back().get()));
+        }
+    }
+    running_services = static_cast<uint32_t>(service_transmitters.size());
 
     rm_client.rm_handler_start();
     RM_logInfo("RM client started ...")
 
-    traffic_generator.start();
+    if (transmit_scheduler)
+    {
+        transmit_scheduler->start();
+    }
+    for (auto& traffic_generator : traffic_generators)
+    {
+        traffic_generator->start();
+    }
     RM_logInfo("Traffic source started ...")
 
     init_done = true;    
@@ -158,21 +283,32 @@ int main(int argc, char* argv[])
 
     sleep(2);
     
-    rscmng::rm_wired_basic_protocol::RMPayload resource_request_payload(
-        2000, 
-        std::chrono::microseconds(100000), 
-        client_configuration.client_priority,
-        0,
-        RMCommand::IDLE,
-        {0,0},
-        {0,0},
-        {0,0},
-        client_resources_request_mode_0        
-        );
-
-    resource_request_payload.serialize(&rm_payload_sendout);
-    rm_client.sync_request(&rm_payload_sendout, service_id);
-
+    for (auto& service_configuration : service_configurations)
+    {
+        struct rscmng::config::service_settings service_setting_mode_0 = service_configuration.second[0];
+        rscmng::rm_wired_basic_protocol::RMPayload::network_resource_request client_resources_request_mode_0;
+        client_resources_request_mode_0.client_id = client_configuration.client_id;
+        client_resources_request_mode_0.service_id = service_setting_mode_0.service_id;
+        client_resources_request_mode_0.data_path = service_setting_mode_0.data_path;
+        client_resources_request_mode_0.priority = service_setting_mode_0.service_priority;
+        client_resources_request_mode_0.bandwidth = service_setting_mode_0.object_size;
+        client_resources_request_mode_0.deadline = std::chrono::milliseconds(service_setting_mode_0.deadline);
+
+        rscmng::rm_wired_basic_protocol::RMPayload resource_request_payload(
+            2000, 
+            std::chrono::microseconds(100000), 
+            client_configuration.client_priority,
+            0,
+            RMCommand::IDLE,
+            {0,0},
+            {0,0},
+            {0,0},
+            client_resources_request_mode_0        
+            );
+
+        resource_request_payload.serialize(&rm_payload_sendout);
+        rm_client.sync_request(&rm_payload_sendout, static_cast<serviceID_t>(service_configuration.first));
+    }
 
     while(active)
     {
@@ -188,6 +324,20 @@ int main(int argc, char* argv[])
                 rm_payload_received.add(recieved_control_message.payload, recieved_control_message.payload_size);
                 rm_payload_received.reset();
 
+                // A single service endnode takes every control message
+                auto transmitter = service_transmitters.find(recieved_control_message.service_id);
+                if (transmitter == service_transmitters.end())
+                {
+                    if (service_transmitters.size() != 1)
+                    {
+                        RM_logWarning("RM client message for unknown service: " << recieved_control_message.service_id)
+                        continue;
+                    }
+                    transmitter = service_transmitters.begin();
+                }
+                serviceID_t service_id = transmitter->first;
+                ServiceTransmitter& traffic_generator = transmitter->second;
+
                 switch(recieved_control_message.message_type)
                 {                
                     case MessageTypes::RM_CLIENT_START:
@@ -268,7 +418,15 @@ int main(int argc, char* argv[])
         }
     }
     RM_logInfo("RMClient release resources")
-    rm_client.resource_release(service_id);
+    for (const auto& service_transmitter : service_transmitters)
+    {
+        rm_client.resource_release(service_transmitter.first);
+    }
+    if (transmit_scheduler)
+    {
+        transmit_scheduler->stop();
+        transmit_scheduler->print_statistics();
+    }
     rm_client.close();
 
     RM_logInfo("RMClient shutdown bye.")
@@ -307,7 +465,7 @@ void handle_message(MessageNet_t received_payload)
 /*
 *
 */
-void handle_start_message(MessageNet_t received_payload, TrafficGenerator &traffic_generator, uint32_t mode)
+void handle_start_message(MessageNet_t received_payload, ServiceTransmitter &traffic_generator, uint32_t mode)
 {
     rscmng::rm_wired_basic_protocol::RMPayload rm_client_protocol_payload;
     struct timespec time_now = {0,0};
@@ -327,7 +485,7 @@ void handle_start_message(MessageNet_t received_payload, TrafficGenerator &traff
 /*
 *
 */
-void handle_stop_message(MessageNet_t received_payload, TrafficGenerator &traffic_generator)
+void handle_stop_message(MessageNet_t received_payload, ServiceTransmitter &traffic_generator)
 {
     rscmng::rm_wired_basic_protocol::RMPayload rm_client_protocol_payload;
     received_payload.reset();
@@ -342,7 +500,7 @@ void handle_stop_message(MessageNet_t received_payload, TrafficGenerator &traffi
 /*
 *
 */
-void handle_reconfigure_message(MessageNet_t received_payload, TrafficGenerator &traffic_generator, uint32_t mode)
+void handle_reconfigure_message(MessageNet_t received_payload, ServiceTransmitter &traffic_generator, uint32_t mode)
 {
     struct timespec time_now = {0,0};
     struct timespec timestamp_target_stop = {0,0};
@@ -364,7 +522,7 @@ void handle_reconfigure_message(MessageNet_t received_payload, TrafficGenerator
 /*
 *
 */
-void handle_exit_message(MessageNet_t received_payload, TrafficGenerator &traffic_generator)
+void handle_exit_message(MessageNet_t received_payload, ServiceTransmitter &traffic_generator)
 {
     rscmng::rm_wired_basic_protocol::RMPayload rm_client_protocol_payload;
     received_payload.reset();
@@ -372,7 +530,8 @@ void handle_exit_message(MessageNet_t received_payload, TrafficGenerator &traffi
 
     traffic_generator.notify_generator(THREAD_STOP);
 
-    active = false;
+    running_services -= std::min<uint32_t>(running_services, 1);
+    active = running_services > 0;
 
     return;
 }
@@ -381,7 +540,7 @@ void handle_exit_message(MessageNet_t received_payload, TrafficGenerator &traffi
 /*
 *
 */
-void handle_sync_reconfigure_hw_message(MessageNet_t received_payload, TrafficGenerator &traffic_generator, uint32_t mode)
+void handle_sync_reconfigure_hw_message(MessageNet_t received_payload, ServiceTransmitter &traffic_generator, uint32_t mode)
 {
     struct timespec time_now = {0,0};
     struct timespec timestamp_target_stop = {0,0};
@@ -451,7 +610,7 @@ void handle_sync_reconfigure_hw_message(MessageNet_t received_payload, TrafficGe
 /*
 *
 */
-void handle_sync_reconfigure_sw_message(MessageNet_t received_payload, TrafficGenerator &traffic_generator, uint32_t mode)
+void handle_sync_reconfigure_sw_message(MessageNet_t received_payload, ServiceTransmitter &traffic_generator, uint32_t mode)
 {
     struct timespec time_now = {0,0};
     struct timespec timestamp_target_stop = {0,0};
@@ -503,7 +662,7 @@ void handle_sync_reconfigure_sw_message(MessageNet_t received_payload, TrafficGe
 /*
 *
 */
-void handle_sync_start_message(MessageNet_t received_payload, TrafficGenerator &traffic_generator, uint32_t mode)
+void handle_sync_start_message(MessageNet_t received_payload, ServiceTransmitter &traffic_generator, uint32_t mode)
 {
     struct timespec time_now = {0,0};
     struct timespec timestamp_target_restart = {0,0};
@@ -554,7 +713,7 @@ void handle_sync_start_message(MessageNet_t received_payload, TrafficGenerator &
 /*
 *
 */
-void handle_sync_stop_message(MessageNet_t received_payload, TrafficGenerator &traffic_generator)
+void handle_sync_stop_message(MessageNet_t received_payload, ServiceTransmitter &traffic_generator)
 {
     struct timespec time_now = {0,0};
     struct timespec timestamp_target_stop = {0,0};
@@ -603,7 +762,7 @@ void handle_sync_stop_message(MessageNet_t received_payload, TrafficGenerator &t
 /*
 *
 */
-void handle_sync_exit_message(MessageNet_t received_payload, TrafficGenerator &traffic_generator)
+void handle_sync_exit_message(MessageNet_t received_payload, ServiceTransmitter &traffic_generator)
 {
     struct timespec time_now = {0,0};
     struct timespec timestamp_target_stop = {0,0};
@@ -634,7 +793,8 @@ void handle_sync_exit_message(MessageNet_t received_payload, TrafficGenerator &t
                     //rm_client.send_ack_start();
                     //sendRMMessage(sender_ID, std::ref(socket), destination_endpoint, RECONFDONE, content, mode, iterator);
                     stopped = true;
-                    active = false;
+                    running_services -= std::min<uint32_t>(running_services, 1);
+                    active = running_services > 0;
                     break;
                 }
             }
@@ -653,7 +813,7 @@ void handle_sync_exit_message(MessageNet_t received_payload, TrafficGenerator &t
 /*
 *
 */
-void handle_sync_reconfigure_sync_object_hw_message(MessageNet_t received_payload, TrafficGenerator &traffic_generator, uint32_t mode)
+void handle_sync_reconfigure_sync_object_hw_message(MessageNet_t received_payload, ServiceTransmitter &traffic_generator, uint32_t mode)
 {
     struct timespec time_now = {0,0};
     struct timespec timestamp_target_stop = {0,0};
@@ -678,7 +838,7 @@ void handle_sync_reconfigure_sync_object_hw_message(MessageNet_t received_payloa
 /*
 *
 */
-void handle_sync_reconfigure_sync_object_sw_message(MessageNet_t received_payload, TrafficGenerator &traffic_generator, uint32_t mode)
+void handle_sync_reconfigure_sync_object_sw_message(MessageNet_t received_payload, ServiceTransmitter &traffic_generator, uint32_t mode)
 {
     struct timespec time_now = {0,0};
     struct timespec timestamp_target_stop = {0,0};
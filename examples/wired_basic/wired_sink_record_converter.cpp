@@ -0,0 +1,49 @@
+// Copyright (C) 2025 IDA
+//
+// This file is part of a project licensed under the GNU Lesser General Public License v3.0.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+
+#include <iostream>
+#include <string>
+
+#include <rscmng/utils/log.hpp>
+#include <rscmng/traffic_sink_statistic.hpp>
+
+
+using namespace traffic_statistic;
+
+
+/*
+*
+*/
+int main(int argc, char* argv[])
+{
+    // read input
+    if (argc < 2)
+    {
+        std::cerr << "Require sink record files (" << FILENAME_LOG << "_<ip>_<port>" << SINK_RECORD_FILE_EXTENSION << ")" << std::endl;
+        return 1;
+    }
+
+    // Text logs are appended in the format the sink wrote before, next to the working directory
+    bool complete = true;
+    for (int argument = 1; argument < argc; argument++)
+    {
+        complete = SinkRecordWriter::convert_to_text(argv[argument], FILENAME_LOG) && complete;
+    }
+
+    return complete ? 0 : 1;
+}
@@ -68,7 +68,11 @@ namespace demonstrator {
 
     const int NUMBER_PRIORITY_LEVEL = 4;
 
-    const int MAX_PROTOCOL_MESSAGE_LENGTH = 1427; // 1458
+    // UDP payload of an unfragmented datagram on a 1500 byte MTU (20 byte IPv4 and 8 byte UDP header)
+    const int MAX_DATAGRAM_LENGTH = 1472;
+
+    // Payload of a full fragment: MAX_DATAGRAM_LENGTH minus the 49 byte data message header
+    const int MAX_PROTOCOL_MESSAGE_LENGTH = 1423; // 1458
     
 };
 
@@ -0,0 +1,179 @@
+// Copyright (C) 2025 IDA
+//
+// This file is part of a project licensed under the GNU Lesser General Public License v3.0.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+
+#ifndef GENERATOR_BENCHMARK_h
+#define GENERATOR_BENCHMARK_h
+
+
+#include <vector>
+#include <string>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <cstdint>
+
+#include <rscmng/utils/log.hpp>
+#include <rscmng/utils/config_reader.hpp>
+#include <rscmng/utils/pacing_engine.hpp>
+#include <rscmng/traffic_generator.hpp>
+
+
+namespace traffic_generator
+{
+
+    /**
+     * @brief Sweep of a generator benchmark, every combination is measured once
+     *
+     */
+    struct benchmark_settings
+    {
+        std::vector<uint32_t> object_sizes_kb = {10, 100, 1000};
+        std::vector<std::chrono::microseconds> inter_packet_gaps = {
+            std::chrono::microseconds(0), std::chrono::microseconds(10), std::chrono::microseconds(50)
+        };
+        std::vector<TransmitBackend> transmit_backends = {
+            TRANSMIT_SOCKET, TRANSMIT_BATCH, TRANSMIT_GSO, TRANSMIT_TXTIME, TRANSMIT_PACKET_RING
+        };
+        std::vector<rscmng::PacingStrategy> pacing_strategies = {
+            rscmng::PACING_BUSY_SPIN, rscmng::PACING_SLEEP_SPIN, rscmng::PACING_SLEEP
+        };
+        // objects per measurement
+        uint32_t objects = 50;
+        // period of the objects, objects longer than a period are sent back to back
+        std::chrono::milliseconds period = std::chrono::milliseconds(1);
+        // local discard sink
+        std::string sink_ip = "127.0.0.1";
+        uint32_t sink_port = 29999;
+        std::string result_file = "generator_benchmark.csv";
+    };
+
+    /**
+     * @brief Percentiles of a latency histogram in ns
+     *
+     */
+    struct benchmark_percentiles
+    {
+        uint64_t p50;
+        uint64_t p90;
+        uint64_t p99;
+        uint64_t p999;
+        uint64_t max;
+    };
+
+    /**
+     * @brief Result of one measurement
+     *
+     */
+    struct benchmark_result
+    {
+        TransmitBackend transmit_backend;
+        rscmng::PacingStrategy pacing_strategy;
+        uint32_t object_size_kb;
+        std::chrono::microseconds inter_packet_gap;
+        uint64_t fragments_sent;
+        uint64_t fragments_received;
+        double duration_s;
+        double packets_per_second;
+        double gbit_per_second;
+        double cpu_utilization;
+        struct benchmark_percentiles gap_error;
+        struct benchmark_percentiles start_lateness;
+    };
+
+    /**
+     * @brief Runs the traffic generator against a local discard sink for every combination of object size,
+     * inter packet gap, transmit backend and pacing strategy and reports throughput, CPU load of the sending
+     * thread and percentiles of the inter packet gap error and the object start lateness.
+     *
+     */
+    class GeneratorBenchmark
+    {
+        public:
+
+        /**
+         * @brief Construct a new Generator Benchmark object
+         *
+         * @param unit_configuration local unit, provides local address, spin margin and backend options
+         * @param experiment_parameter experiment settings, provide the timeline clock
+         * @param settings sweep
+         */
+        GeneratorBenchmark(
+            const struct rscmng::config::unit_settings& unit_configuration,
+            const struct rscmng::config::experiment_parameter& experiment_parameter,
+            const struct benchmark_settings& settings
+        );
+
+        /**
+         * @brief Run the sweep
+         *
+         * @return std::vector<struct benchmark_result> one result per combination
+         */
+        std::vector<struct benchmark_result> run();
+
+        /**
+         * @brief Log the results and write them to the result file (CSV)
+         *
+         */
+        void report(const std::vector<struct benchmark_result>& results) const;
+
+        private:
+
+        /**
+         * @brief Measure one combination
+         *
+         */
+        struct benchmark_result measure(TransmitBackend backend, rscmng::PacingStrategy pacing, uint32_t object_size_kb, std::chrono::microseconds inter_packet_gap);
+
+        /**
+         * @brief Receive and drop datagrams until stopped
+         *
+         */
+        void discard_sink(int socket_fd);
+
+        /**
+         * @brief Percentiles of a histogram
+         *
+         */
+        static struct benchmark_percentiles percentiles_of(const rscmng::LogLinearHistogram& histogram);
+
+        struct rscmng::config::unit_settings unit_configuration;
+
+        struct rscmng::config::experiment_parameter experiment_parameter;
+
+        struct benchmark_settings settings;
+
+        std::atomic<bool> sink_active;
+
+        std::atomic<uint64_t> sink_received;
+    };
+
+    /**
+     * @brief Name of a transmit backend (inverse of transmit_backend_from_string)
+     *
+     */
+    std::string transmit_backend_name(TransmitBackend backend);
+
+    /**
+     * @brief Name of a pacing strategy
+     *
+     */
+    std::string pacing_strategy_name(rscmng::PacingStrategy strategy);
+
+};
+
+#endif
@@ -0,0 +1,144 @@
+// Copyright (C) 2025 IDA
+//
+// This file is part of a project licensed under the GNU Lesser General Public License v3.0.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+
+#ifndef GENERATOR_CONTROL_h
+#define GENERATOR_CONTROL_h
+
+
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <cstdint>
+#include <ctime>
+
+
+namespace traffic_generator
+{
+    enum TrafficSourceControl
+    {
+        THREAD_START = 0,
+        THREAD_STOP,
+        THREAD_PAUSED,
+        THREAD_TRANSMISSION,
+        THREAD_TRANSMISSION_FINISH_OBJECT,
+        THREAD_RECONFIGURE
+    };
+
+    /**
+     * @brief Consistent copy of the generator control block
+     *
+     */
+    struct control_snapshot
+    {
+        TrafficSourceControl state;
+        uint32_t mode;
+        struct timespec period_timestamp;
+        uint64_t period_version;
+        uint64_t version;
+    };
+
+    /**
+     * @brief Versioned control block shared between the RM client (writer) and the sending thread (reader).
+     * Writers are serialized by a mutex and publish state, mode and period timestamp under a sequence counter.
+     * The sending thread reads without locking and only blocks on the condition variable while it is paused.
+     * A new period timestamp is detected by its version, so it is not lost if a mode change follows before
+     * the sending thread picked it up.
+     *
+     */
+    class GeneratorControl
+    {
+        public:
+
+        /**
+         * @brief Construct a new Generator Control object in THREAD_START with mode 0
+         *
+         */
+        GeneratorControl();
+
+        /**
+         * @brief Publish a new state
+         *
+         */
+        void publish_state(TrafficSourceControl state);
+
+        /**
+         * @brief Publish a new state and mode
+         *
+         */
+        void publish_mode(TrafficSourceControl state, uint32_t mode);
+
+        /**
+         * @brief Publish a new state and mode, update_period additionally publishes a new period timestamp
+         *
+         */
+        void publish_timestamp(TrafficSourceControl state, struct timespec timestamp, uint32_t mode, bool update_period);
+
+        /**
+         * @brief Current state, single atomic load
+         *
+         */
+        TrafficSourceControl state() const;
+
+        /**
+         * @brief Consistent copy of all fields, retries while a writer is active
+         *
+         */
+        control_snapshot snapshot() const;
+
+        /**
+         * @brief Return as soon as the state permits transmission (or is THREAD_STOP), block only while paused
+         *
+         * @param finish_object_allowed THREAD_TRANSMISSION_FINISH_OBJECT permits transmission as well
+         * @return TrafficSourceControl state that released the caller
+         */
+        TrafficSourceControl await_transmission(bool finish_object_allowed);
+
+        private:
+
+        /**
+         * @brief True if the state releases a waiting sending thread
+         *
+         */
+        static bool releases(TrafficSourceControl state, bool finish_object_allowed);
+
+        /**
+         * @brief Write all fields under the sequence counter, caller holds writer_mutex
+         *
+         */
+        void write(TrafficSourceControl state, uint32_t mode, const struct timespec* timestamp);
+
+        std::atomic<uint64_t> sequence;
+
+        std::atomic<int> control_state;
+
+        std::atomic<uint32_t> control_mode;
+
+        std::atomic<int64_t> period_seconds;
+
+        std::atomic<int64_t> period_nanoseconds;
+
+        std::atomic<uint64_t> period_version;
+
+        std::mutex writer_mutex;
+
+        std::condition_variable resume_condition;
+    };
+
+};
+
+#endif
@@ -22,6 +22,9 @@
 
 #include <string>
 #include <chrono>
+#include <cstring>
+
+#include <sys/uio.h>
 
 #include <rscmng/data_sharing/message_net.hpp>
 #include <rscmng/protocols/protocols.hpp>
@@ -445,6 +448,289 @@ namespace rscmng {
     };
 
 
+    /**
+     * @brief Wire format of a data message
+     * 
+     */
+    enum DataMessageVersion
+    {
+        // DataMessage::dataToNet layout, 49 byte header in host byte order
+        DATA_MESSAGE_V1 = 1,
+        // DataMessageHeaderV2, 40 byte header
+        DATA_MESSAGE_V2 = 2,
+        // DataMessageHeaderV3, v2 with the mode of the service
+        DATA_MESSAGE_V3 = 3
+    };
+
+
+    /**
+     * @brief Map the DATA_MESSAGE_VERSION config value to the wire format, unknown versions fall back to v1
+     * 
+     */
+    DataMessageVersion data_message_version_from_number(uint32_t version_number);
+
+
+    /**
+     * @brief Layout of the v2 header. All fields are little endian at naturally aligned offsets, the send
+     * time is carried once as ns since the epoch. A v1 header starts with the priority, which is always below
+     * NUMBER_PRIORITY_LEVEL, so the marker byte tells the formats apart.
+     *
+     *  0 uint8  marker         1 uint8  version        2 uint8  priority       3 uint8  header length
+     *  4 uint32 source id      8 uint64 service id    16 uint32 object number
+     * 20 uint32 fragment number                       24 uint32 total fragments
+     * 28 uint16 payload length                        30 uint16 reserved      32 uint64 send time ns
+     * 
+     */
+    struct DataMessageHeaderV2
+    {
+        static const uint8_t MARKER = 0xD2;
+        static const uint8_t VERSION = DATA_MESSAGE_V2;
+        static const size_t MARKER_OFFSET = 0;
+        static const size_t VERSION_OFFSET = 1;
+        static const size_t PRIORITY_OFFSET = 2;
+        static const size_t HEADER_LENGTH_OFFSET = 3;
+        static const size_t SOURCE_ID_OFFSET = 4;
+        static const size_t SERVICE_ID_OFFSET = 8;
+        static const size_t OBJECT_NUMBER_OFFSET = 16;
+        static const size_t FRAGMENT_NUMBER_OFFSET = 20;
+        static const size_t TOTAL_FRAGMENTS_OFFSET = 24;
+        static const size_t PAYLOAD_LENGTH_OFFSET = 28;
+        static const size_t TIMESTAMP_OFFSET = 32;
+        static const size_t HEADER_LENGTH = 40;
+    };
+
+
+    /**
+     * @brief Layout of the v3 header, the v2 layout with the mode of the service in the reserved field.
+     *
+     * 30 uint16 mode + 1, 0 if the sender did not set the mode of the service
+     * 
+     */
+    struct DataMessageHeaderV3 : DataMessageHeaderV2
+    {
+        static const uint8_t VERSION = DATA_MESSAGE_V3;
+        static const size_t MODE_OFFSET = 30;
+    };
+
+
+    /**
+     * @brief Serialized DataMessage header of one object in v1 (byte compatible with DataMessage::dataToNet)
+     * or v2/v3 format. The constant fields are written once per object, per fragment only fragment_number, the
+     * timestamp and in v2/v3 the payload length are patched in place. The payload is not copied but referenced
+     * next to the header in a scatter-gather list.
+     *
+     */
+    class DataMessageTemplate
+    {
+        public:
+
+        static const size_t FRAGMENT_NUMBER_OFFSET = sizeof(uint8_t) + sizeof(uint32_t) + sizeof(serviceID_t) + sizeof(uint32_t);
+        static const size_t TIMESTAMP_OFFSET = FRAGMENT_NUMBER_OFFSET + 2 * sizeof(uint32_t);
+        static const size_t TIME_STAMP_OFFSET = TIMESTAMP_OFFSET + sizeof(struct timespec);
+        static const size_t HEADER_LENGTH = TIME_STAMP_OFFSET + sizeof(std::chrono::system_clock::time_point);
+
+        /**
+         * @brief Construct a new (empty) Data Message Template object
+         * 
+         */
+        DataMessageTemplate();
+
+        /**
+         * @brief Serialize the fields that are constant for all fragments of an object
+         * 
+         * @param priority traffic priority
+         * @param client_id ID of the transmitting application
+         * @param service_id ID of the application
+         * @param object_number sequence number of the object
+         * @param total_fragments total fragments of the object
+         * @param version wire format
+         * @param mode mode of the service, carried by v3 headers only, -1 leaves it unset
+         */
+        void prepare(
+            uint8_t priority, 
+            uint32_t client_id, 
+            serviceID_t service_id, 
+            uint32_t object_number, 
+            uint32_t total_fragments,
+            DataMessageVersion version = DATA_MESSAGE_V1,
+            int32_t mode = -1
+        );
+
+        /**
+         * @brief Start the next object on a prepared template, patches object number, total fragments and the object time stamp
+         * 
+         */
+        void begin_object(uint32_t object_number, uint32_t total_fragments);
+
+        /**
+         * @brief Patch fragment number and timestamp in place
+         * 
+         */
+        void patch(uint32_t fragment_number, const struct timespec& timestamp, size_t payload_length);
+
+        /**
+         * @brief Serialized header
+         * 
+         */
+        const char* data() const;
+
+        /**
+         * @brief Header length
+         * 
+         */
+        size_t size() const;
+
+        /**
+         * @brief Wire format of the header
+         * 
+         */
+        DataMessageVersion version() const;
+
+        /**
+         * @brief Payload of a full fragment, the bytes a shorter header saves are payload
+         * 
+         */
+        size_t max_payload() const;
+
+        /**
+         * @brief Payload of a full fragment of a wire format, all formats share the same datagram size
+         * 
+         */
+        static size_t max_payload(DataMessageVersion version);
+
+        /**
+         * @brief Fill two iovecs with header and payload
+         * 
+         * @param message_iovec array of at least two iovecs
+         * @param payload payload, must stay valid until the datagram is sent
+         * @param payload_length payload length
+         */
+        void scatter(struct iovec* message_iovec, const char* payload, size_t payload_length) const;
+
+        private:
+
+        char header[HEADER_LENGTH];
+
+        DataMessageVersion header_version;
+
+        size_t header_length;
+    };
+
+
+    /**
+     * @brief Non-owning view of a received data message. The wire format is detected per datagram, the
+     * header fields are decoded from the receive buffer, the payload is referenced in place and its length
+     * is taken from the received length. The buffer must outlive the view.
+     *
+     */
+    class DataMessageView
+    {
+        public:
+
+        static const size_t SOURCE_ID_OFFSET = sizeof(uint8_t);
+        static const size_t SERVICE_ID_OFFSET = SOURCE_ID_OFFSET + sizeof(uint32_t);
+        static const size_t OBJECT_NUMBER_OFFSET = SERVICE_ID_OFFSET + sizeof(serviceID_t);
+        static const size_t TOTAL_FRAGMENTS_OFFSET = DataMessageTemplate::FRAGMENT_NUMBER_OFFSET + sizeof(uint32_t);
+
+        /**
+         * @brief Construct a new (invalid) Data Message View object
+         * 
+         */
+        DataMessageView();
+
+        /**
+         * @brief Decode a received datagram
+         * 
+         * @param message receive buffer
+         * @param size received length
+         * @return true if the datagram carries a complete v1 or v2 header with a valid timestamp
+         */
+        bool parse(const char* message, size_t size);
+
+        /**
+         * @brief Result of the last parse
+         * 
+         */
+        bool valid() const;
+
+        /**
+         * @brief Wire format of the last parsed datagram
+         * 
+         */
+        DataMessageVersion version() const;
+
+        uint8_t priority() const;
+
+        uint32_t source_id() const;
+
+        serviceID_t service_id() const;
+
+        uint32_t object_number() const;
+
+        uint32_t fragment_number() const;
+
+        uint32_t total_fragments() const;
+
+        /**
+         * @brief Mode of the service, -1 if the header carries none (v1, v2 or a v3 sender without mode)
+         * 
+         */
+        int32_t mode() const;
+
+        /**
+         * @brief Send timestamp of the fragment
+         * 
+         */
+        const struct timespec& timestamp() const;
+
+        /**
+         * @brief Payload in the receive buffer
+         * 
+         */
+        const char* payload() const;
+
+        /**
+         * @brief Received length minus header length
+         * 
+         */
+        size_t payload_length() const;
+
+        private:
+
+        /**
+         * @brief Decode a datagram with a v2 or v3 header, rejected unless the payload length matches
+         * 
+         */
+        bool parse_v2();
+
+        const char* message;
+
+        size_t message_size;
+
+        bool header_valid;
+
+        DataMessageVersion header_version;
+
+        size_t header_length;
+
+        uint8_t message_priority;
+
+        uint32_t source;
+
+        serviceID_t service;
+
+        uint32_t object;
+
+        uint32_t fragment;
+
+        uint32_t fragments;
+
+        int32_t service_mode;
+
+        struct timespec send_timestamp;
+    };
+
+
     /**
      * @brief Data structure for nRM mesages (allocation request, deallocation request, slot adaption request)
      * 
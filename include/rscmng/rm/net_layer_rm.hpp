@@ -36,6 +36,8 @@
 #include <rscmng/attributes/uuid.hpp>
 #include <rscmng/utils/config_reader.hpp>
 #include <rscmng/utils/timer_events.hpp>
+#include <rscmng/utils/hyperperiod_timeline.hpp>
+#include <rscmng/utils/realtime_profile.hpp>
 #include <rscmng/messages.hpp>
 #include <rscmng/rm_communication.hpp>
 #include <rscmng/abstraction/socket_endpoint.hpp>
@@ -185,6 +187,12 @@ class NetLayerRM
      */
     struct timespec get_round_timestamp();
 
+    /**
+     * @brief First hyperperiod start after the distribution phase (CLOCK_REALTIME for the clients)
+     * 
+     */
+    struct timespec next_reconfiguration_hyperperiod();
+
     /**
      * @brief 
      * 
@@ -357,6 +365,7 @@ class NetLayerRM
     struct timespec rm_active_timestamp_last;
 
     std::chrono::milliseconds hyperperiod_duration;
+    rscmng::HyperperiodTimeline hyperperiod_timeline;
     uint32_t number_slots_per_hyperperiod;
     std::chrono::milliseconds slot_duration;
 
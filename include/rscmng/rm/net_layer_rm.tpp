@@ -61,6 +61,11 @@ NetLayerRM<T>::NetLayerRM
 
     hyperperiod_duration = experiment_parameter_struct.hyperperiod_duration;
     RM_logInfo("NetRM hyperperiod_duration  : " << hyperperiod_duration.count() << " ms")
+    hyperperiod_timeline = rscmng::HyperperiodTimeline(
+        rscmng::timeline_clock_from_string(experiment_parameter_struct.timeline_clock),
+        std::chrono::duration_cast<std::chrono::nanoseconds>(hyperperiod_duration).count()
+    );
+    RM_logInfo("NetRM timeline clock        : " << experiment_parameter_struct.timeline_clock)
 
 
     start_timer.start();
@@ -79,6 +84,7 @@ NetLayerRM<T>::NetLayerRM
 template<class T>
 void NetLayerRM<T>::receive_message()
 {
+    RealtimeProfile::instance().apply(RT_THREAD_RM_RECEIVE);
     RM_logInfo("NetRM Receiving Handler active: " << control_channel.address()  << " " << control_channel.port())
 
     // AppAbstraction app_attr;
@@ -108,6 +114,7 @@ void NetLayerRM<T>::receive_message()
 template<class T>
 void NetLayerRM<T>::handle_message()
 {    
+    RealtimeProfile::instance().apply(RT_THREAD_RM_HANDLER);
     RM_logInfo("NetRM Message Handler active");
 
     // Pair for request cache
@@ -237,6 +244,8 @@ void NetLayerRM<T>::start_network_traffic_synchronous()
     RM_logInfo("Timestamp now               : " << time_now.tv_sec << "s " << time_now.tv_nsec << " ns")
     RM_logInfo("Timestamp for sync start is : " << target_time_client_start.tv_sec << "s " << target_time_client_start.tv_nsec << " ns")
     rm_active_timestamp_last = target_time_client_start;
+    // Anchored once, every later reconfiguration starts a whole number of hyperperiods after the sync start
+    hyperperiod_timeline.anchor(hyperperiod_timeline.from_realtime(target_time_client_start), hyperperiod_timeline.period());
     uint32_t startup_mode = experiment_parameter_struct.startup_mode;
 
     rscmng::wired::RMMessage data_message;
@@ -357,26 +366,9 @@ udp::endpoint NetLayerRM<T>::get_client_address(uint32_t endnode_id)
 template<class T>
 struct timespec NetLayerRM<T>::prepare_timestamp_add(struct timespec time_stamp, std::chrono::milliseconds delay)
 {
-    struct timespec target_time = {0, 0};
-
-    // Convert delay to nanoseconds
-    auto delay_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(delay);
-
-    // Get the count of nanoseconds as an integer
-    long delay_ns_count = delay_ns.count();
-
-    if (delay_ns_count / 1000000000L < 1)
-    {
-        target_time.tv_sec = time_stamp.tv_sec;
-        target_time.tv_nsec = delay_ns_count;
-    }
-    else
-    {
-        target_time.tv_sec = time_stamp.tv_sec + (delay_ns_count / 1000000000L);
-        target_time.tv_nsec = delay_ns_count % 1000000000L; // Remainder for nanoseconds
-    }
-
-    return target_time;
+    // Integer nanoseconds, keeps the sub second part of timestamps that are not on a full second
+    int64_t delay_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(delay).count();
+    return rscmng::HyperperiodTimeline::to_timespec(rscmng::HyperperiodTimeline::to_ns(time_stamp) + delay_ns);
 }
 
 
@@ -450,6 +442,25 @@ struct timespec NetLayerRM<T>::get_round_timestamp()
 }
 
 
+/*
+*
+*/
+template<class T>
+struct timespec NetLayerRM<T>::next_reconfiguration_hyperperiod()
+{
+    if (!hyperperiod_timeline.anchored())
+    {
+        // No synchronous start was sent, the hyperperiods start now
+        hyperperiod_timeline.anchor(hyperperiod_timeline.now(), hyperperiod_timeline.period());
+    }
+
+    // Slot k of the timeline starts at anchor + k * hyperperiod, the distribution phase has to fit before it
+    int64_t distribution_end = hyperperiod_timeline.now() + std::chrono::duration_cast<std::chrono::nanoseconds>(experiment_parameter_struct.mc_distribution_phase_duration).count();
+    uint64_t target_slot = hyperperiod_timeline.next_slot(distribution_end);
+    return hyperperiod_timeline.to_realtime(hyperperiod_timeline.slot_start(target_slot));
+}
+
+
 /*
 *
 */
@@ -756,20 +767,7 @@ void NetLayerRM<T>::experiment_mode_change_time_triggered_synchronous_objects_hw
         {
             network_mode = mode_order_iterator;
             // calculate next reconfiguration window
-            struct timespec current_time = {0, 0};
-            clock_gettime(CLOCK_REALTIME, &current_time);
-            
-            struct timespec time_diff = subtract_timespec(current_time, rm_active_timestamp_last);
-
-            // Calculate number of hyperperiods
-            uint32_t number_hyperperiods_past = (time_diff.tv_sec * 1000 + time_diff.tv_nsec / 1000000) / hyperperiod_duration.count() + 1; //ms
-            uint32_t number_hyperperiod_distribution = experiment_parameter_struct.mc_distribution_phase_duration.count() / hyperperiod_duration.count() + 1; //ms //calculate number hyperperiods for gap to next
-
-            // Update target_hyperperiod based on hyperperiods
-            struct timespec target_hyperperiod;
-            target_hyperperiod.tv_sec  = rm_active_timestamp_last.tv_sec  + ((number_hyperperiods_past + number_hyperperiod_distribution) * 100) / 1000;
-            target_hyperperiod.tv_nsec = rm_active_timestamp_last.tv_nsec + ((number_hyperperiods_past + number_hyperperiod_distribution) * 100) % 1000 * 1000000;
-
+            struct timespec target_hyperperiod = next_reconfiguration_hyperperiod();
             rm_active_timestamp_last = target_hyperperiod;
         
             auto list_iterator = service_list.begin();
@@ -848,20 +846,7 @@ void NetLayerRM<T>::experiment_mode_change_time_triggered_synchronous_objects_sw
         {
             network_mode = mode_order_iterator;
             // calculate next reconfiguration window
-            struct timespec current_time = {0, 0};
-            clock_gettime(CLOCK_REALTIME, &current_time);
-            
-            struct timespec time_diff = subtract_timespec(current_time, rm_active_timestamp_last);
-
-            // Calculate number of hyperperiods
-            uint32_t number_hyperperiods_past = (time_diff.tv_sec * 1000 + time_diff.tv_nsec / 1000000) / hyperperiod_duration.count() + 1; //ms
-            uint32_t number_hyperperiod_distribution = experiment_parameter_struct.mc_distribution_phase_duration.count() / hyperperiod_duration.count() + 1; //ms //calculate number hyperperiods for gap to next
-
-            // Update target_hyperperiod based on hyperperiods
-            struct timespec target_hyperperiod;
-            target_hyperperiod.tv_sec  = rm_active_timestamp_last.tv_sec  + ((number_hyperperiods_past + number_hyperperiod_distribution) * 100) / 1000;
-            target_hyperperiod.tv_nsec = rm_active_timestamp_last.tv_nsec + ((number_hyperperiods_past + number_hyperperiod_distribution) * 100) % 1000 * 1000000;
-
+            struct timespec target_hyperperiod = next_reconfiguration_hyperperiod();
             rm_active_timestamp_last = target_hyperperiod;
 
             RM_logInfo("NetRM target hyperperiod for mode change " << target_hyperperiod.tv_sec << " s " << target_hyperperiod.tv_nsec << " ns" )
@@ -0,0 +1,148 @@
+// Copyright (C) 2025 IDA
+//
+// This file is part of a project licensed under the GNU Lesser General Public License v3.0.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+
+#ifndef BATCH_RECEIVER_h
+#define BATCH_RECEIVER_h
+
+
+#include <vector>
+#include <string>
+#include <cstring>
+#include <cstdint>
+
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <netinet/in.h>
+
+#include <rscmng/utils/log.hpp>
+#include <rscmng/sink/rx_timestamp.hpp>
+
+
+#ifndef SOL_UDP
+#define SOL_UDP 17
+#endif
+
+#ifndef UDP_GRO
+#define UDP_GRO 104
+#endif
+
+
+namespace traffic_statistic
+{
+
+    /**
+     * @brief One datagram as sent by the generator, a coalesced GRO super packet yields several
+     *
+     */
+    struct received_datagram
+    {
+        const char* data;
+        size_t length;
+        // IPv4 source address and port in host byte order
+        uint32_t source_address;
+        uint16_t source_port;
+        // kernel receive timestamp, shared by all datagrams of a super packet
+        bool kernel_timestamped;
+        struct timespec kernel_timestamp;
+    };
+
+    /**
+     * @brief Receives up to batch_size datagrams per recvmmsg call into preallocated slots. With UDP GRO
+     * the kernel may coalesce consecutive datagrams of a flow into one super packet, which is split back
+     * into the original datagrams using the segment size reported in the control message.
+     *
+     */
+    class BatchReceiver
+    {
+        public:
+
+        /**
+         * @brief Construct a new Batch Receiver object
+         *
+         * @param socket_fd native handle of a bound UDP socket
+         * @param batch_size maximum number of datagrams (or super packets) per recvmmsg call
+         * @param datagram_size maximum length of a single datagram
+         * @param gro enable UDP GRO on the socket
+         */
+        BatchReceiver(int socket_fd, uint32_t batch_size, size_t datagram_size, bool gro);
+
+        BatchReceiver(const BatchReceiver&) = delete;
+
+        BatchReceiver& operator=(const BatchReceiver&) = delete;
+
+        /**
+         * @brief Block until at least one datagram is available and receive all available up to the batch size,
+         * a non-blocking socket returns immediately
+         *
+         * @return uint32_t number of datagrams after splitting super packets, 0 on error or if none was available
+         */
+        uint32_t receive();
+
+        /**
+         * @brief Datagram of the last receive call
+         *
+         * @param index index below the value returned by receive
+         */
+        const struct received_datagram& datagram(uint32_t index) const;
+
+        /**
+         * @brief True if UDP GRO is active on the socket
+         *
+         */
+        bool gro_enabled() const;
+
+        /**
+         * @brief Print number of syscalls, datagrams, super packets and errors
+         *
+         */
+        void print_statistics(std::string name) const;
+
+        private:
+
+        int socket_fd;
+
+        uint32_t batch_size;
+
+        size_t slot_size;
+
+        bool gro_active;
+
+        std::vector<char> slot_buffer;
+
+        std::vector<char> slot_control;
+
+        std::vector<struct iovec> slot_iovec;
+
+        std::vector<struct sockaddr_in> slot_source;
+
+        std::vector<struct mmsghdr> slot_header;
+
+        std::vector<struct received_datagram> datagrams;
+
+        uint64_t syscall_count;
+
+        uint64_t datagram_count;
+
+        uint64_t super_packet_count;
+
+        uint64_t error_count;
+    };
+
+};
+
+#endif
@@ -0,0 +1,143 @@
+// Copyright (C) 2025 IDA
+//
+// This file is part of a project licensed under the GNU Lesser General Public License v3.0.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+
+#ifndef SINK_EVENT_LOOP_h
+#define SINK_EVENT_LOOP_h
+
+
+#include <vector>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <functional>
+#include <cstdint>
+
+#include <rscmng/utils/log.hpp>
+
+
+namespace traffic_statistic
+{
+
+    // Ready events handled per epoll_wait call
+    #define SINK_EVENT_MAX_EVENTS 64
+
+    /**
+     * @brief Pool of epoll threads shared by the sink ports of one host. Every socket is registered with
+     * exactly one epoll instance (the one with the fewest sockets), so a socket is never drained by two
+     * threads at once and the callbacks need no locking. Sockets are level triggered, a callback that
+     * leaves data in the socket is called again after the other ready sockets of its thread.
+     *
+     */
+    class SinkEventLoop
+    {
+        public:
+
+        /**
+         * @brief Construct a new Sink Event Loop object and start its threads
+         *
+         * @param thread_count number of epoll threads, 0 for a quarter of the cores (at least one)
+         */
+        SinkEventLoop(uint32_t thread_count);
+
+        SinkEventLoop(const SinkEventLoop&) = delete;
+
+        SinkEventLoop& operator=(const SinkEventLoop&) = delete;
+
+        /**
+         * @brief Stop and join the threads
+         *
+         */
+        ~SinkEventLoop();
+
+        /**
+         * @brief Register a non-blocking socket, on_readable is called from a loop thread while it has data
+         *
+         * @param socket_fd native handle of the socket, must stay open until it is removed or the loop is stopped
+         * @param on_readable receive callback
+         * @return true if the socket was registered
+         */
+        bool add(int socket_fd, std::function<void()> on_readable);
+
+        /**
+         * @brief Deregister a socket, its callback is not called after remove returns. The other sockets
+         * keep being served. Must not be called from a callback of the loop.
+         *
+         * @param socket_fd native handle passed to add
+         */
+        void remove(int socket_fd);
+
+        /**
+         * @brief Number of epoll threads
+         *
+         */
+        uint32_t thread_count() const;
+
+        /**
+         * @brief Wait until the loop is stopped
+         *
+         */
+        void join();
+
+        /**
+         * @brief Stop the threads, no callback runs after stop returns
+         *
+         */
+        void stop();
+
+        private:
+
+        struct event_thread
+        {
+            int epoll_fd;
+            uint32_t socket_count;
+            std::thread thread;
+            // held while the callbacks of one epoll_wait are called
+            std::mutex dispatch_mutex;
+        };
+
+        struct event_handler
+        {
+            int socket_fd;
+            std::function<void()> on_readable;
+            struct event_thread* loop;
+            // set under the dispatch mutex, the handler is kept since a pending batch may still reference it
+            bool removed;
+        };
+
+        /**
+         * @brief Wait for ready sockets of one epoll instance and call their callbacks
+         *
+         */
+        void run(struct event_thread& loop);
+
+        std::atomic<bool> active;
+
+        // eventfd registered with every epoll instance to wake the threads on stop
+        int stop_fd;
+
+        std::mutex loop_mutex;
+
+        std::vector<std::unique_ptr<struct event_thread>> loops;
+
+        std::vector<std::unique_ptr<struct event_handler>> handlers;
+    };
+
+};
+
+#endif
@@ -0,0 +1,148 @@
+// Copyright (C) 2025 IDA
+//
+// This file is part of a project licensed under the GNU Lesser General Public License v3.0.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef SINK_KERNEL_COUNTER_h
+#define SINK_KERNEL_COUNTER_h
+
+
+#include <map>
+#include <vector>
+#include <string>
+#include <cstdint>
+
+#include <linux/bpf.h>
+
+#include <rscmng/utils/log.hpp>
+
+
+#ifndef SO_ATTACH_BPF
+#define SO_ATTACH_BPF 50
+#endif
+
+
+namespace traffic_statistic
+{
+
+    // Services a kernel counter map can hold
+    #define KERNEL_COUNTER_MAX_SERVICES 256
+    // The filter of a UDP socket sees the datagram from the UDP header on
+    #define KERNEL_COUNTER_PAYLOAD_OFFSET 8
+    // Map key of the datagrams without data message header, only packets and bytes are counted
+    #define KERNEL_COUNTER_REJECTED_KEY 0xFFFFFFFFFFFFFFFFULL
+
+    /**
+     * @brief Counters of one service, per CPU in the map and summed over the CPUs in a snapshot
+     *
+     */
+    struct kernel_service_counters
+    {
+        uint64_t packets;
+        // UDP payload bytes
+        uint64_t bytes;
+        // highest object number seen and the last fragment received of it
+        uint32_t last_object;
+        uint32_t last_fragment;
+        // fragments with number 0, one per object that was not lost entirely
+        uint64_t first_fragments;
+    };
+
+    /**
+     * @brief eBPF socket filter that accounts the data messages of a socket per service id in a per CPU hash map
+     * and drops them, so a sink measures multi Gbit flows without copying a single datagram to user space.
+     * The program detects the v1 and v2/v3 header like DataMessageView (marker, version and header length),
+     * datagrams that carry neither are dropped and counted under KERNEL_COUNTER_REJECTED_KEY.
+     * The map is read with the bpf syscall, no library is needed.
+     *
+     */
+    class KernelServiceCounter
+    {
+        public:
+
+        /**
+         * @brief Create the map and attach the program to a bound socket, needs CAP_BPF (or root)
+         *
+         * @param socket_fd socket of the sink port
+         */
+        KernelServiceCounter(int socket_fd);
+
+        KernelServiceCounter(const KernelServiceCounter&) = delete;
+
+        KernelServiceCounter& operator=(const KernelServiceCounter&) = delete;
+
+        /**
+         * @brief Detach the program and release map and program
+         *
+         */
+        ~KernelServiceCounter();
+
+        /**
+         * @brief True if the program is attached
+         *
+         */
+        bool valid() const;
+
+        /**
+         * @brief Counters of all services seen so far, summed over the CPUs, safe while the program runs.
+         * Rejected datagrams are reported under KERNEL_COUNTER_REJECTED_KEY.
+         *
+         */
+        std::map<uint64_t, struct kernel_service_counters> snapshot() const;
+
+        /**
+         * @brief Log the totals of a snapshot
+         *
+         */
+        void print(std::string name) const;
+
+        private:
+
+        /**
+         * @brief Instructions of the accounting program
+         *
+         */
+        std::vector<struct bpf_insn> program() const;
+
+        /**
+         * @brief Encode one instruction
+         *
+         */
+        static struct bpf_insn instruction(uint8_t code, uint8_t dst_reg, uint8_t src_reg, int16_t off, int32_t imm);
+
+        /**
+         * @brief bpf syscall
+         *
+         */
+        static long bpf_call(int command, union bpf_attr& attributes);
+
+        /**
+         * @brief Number of possible CPUs, the size of a per CPU map value
+         *
+         */
+        static uint32_t possible_cpus();
+
+        int socket_fd;
+
+        int map_fd;
+
+        int program_fd;
+
+        uint32_t cpu_count;
+    };
+
+};
+
+#endif
@@ -0,0 +1,166 @@
+// Copyright (C) 2025 IDA
+//
+// This file is part of a project licensed under the GNU Lesser General Public License v3.0.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+
+#ifndef REASSEMBLY_TRACKER_h
+#define REASSEMBLY_TRACKER_h
+
+
+#include <vector>
+#include <cstdint>
+
+
+namespace traffic_statistic
+{
+
+    // Objects of one service that can be in reception at the same time, power of two
+    #define REASSEMBLY_WINDOW 8
+    // Timeout of objects of services without deadline
+    #define REASSEMBLY_DEFAULT_TIMEOUT_NS 1000000000L
+
+    /**
+     * @brief Object and fragment counters of one service
+     *
+     */
+    struct reassembly_counters
+    {
+        uint64_t objects_complete = 0;
+        // not complete at the deadline (timeout) or pushed out of the window by newer objects
+        uint64_t objects_lost = 0;
+        // lost objects that were in reception while the service changed its mode
+        uint64_t objects_interrupted = 0;
+        // lost objects of a service with deadline
+        uint64_t deadline_misses = 0;
+        // changes of the header mode between consecutive objects, without header mode changes of the fragment count
+        uint64_t mode_changes = 0;
+        // fragments never received of lost objects
+        uint64_t fragments_missing = 0;
+        uint64_t fragments_duplicate = 0;
+        // fragments received after a higher fragment of the same object or a newer object
+        uint64_t fragments_reordered = 0;
+        // fragments of objects that were already declared lost or left the window
+        uint64_t fragments_late = 0;
+        // fragment number not below the fragment count
+        uint64_t fragments_invalid = 0;
+    };
+
+    /**
+     * @brief Reassembly state of the objects of one service. Every object in reception keeps a bitmap of
+     * its received fragments in one of REASSEMBLY_WINDOW slots indexed by the object number. An object is
+     * complete with its last missing fragment and lost if it is still incomplete at its deadline, measured
+     * from the send time of its first fragment. Not thread safe, the caller serializes all calls.
+     *
+     */
+    class ReassemblyTracker
+    {
+        public:
+
+        /**
+         * @brief Construct a new Reassembly Tracker object
+         *
+         */
+        ReassemblyTracker();
+
+        /**
+         * @brief Set the object deadline
+         *
+         * @param deadline_ns deadline relative to the send time of the first fragment, 0 uses REASSEMBLY_DEFAULT_TIMEOUT_NS
+         */
+        void set_deadline(int64_t deadline_ns);
+
+        /**
+         * @brief Object deadline, 0 for none
+         *
+         */
+        int64_t deadline() const;
+
+        /**
+         * @brief Infer mode changes from a change of the fragment count if the headers carry no mode, only
+         * valid for services with a constant object size
+         *
+         */
+        void set_fragment_count_mode_changes(bool enabled);
+
+        /**
+         * @brief Record a received fragment, objects past their deadline are declared lost first
+         *
+         * @param object_number object number
+         * @param fragment_number fragment number (0 based)
+         * @param total_fragments fragments of the object
+         * @param send_ns send timestamp of the fragment
+         * @param receive_ns receive timestamp of the fragment
+         * @param mode mode of the service from the header, -1 if not carried
+         * @return int64_t completion time (receive of this fragment - first send of the object) if the fragment
+         * completed its object, -1 otherwise
+         */
+        int64_t record(uint32_t object_number, uint32_t fragment_number, uint32_t total_fragments, int64_t send_ns, int64_t receive_ns, int32_t mode = -1);
+
+        /**
+         * @brief Declare all objects lost whose deadline passed before now
+         *
+         */
+        void expire(int64_t now_ns);
+
+        /**
+         * @brief Counters of all closed objects and received fragments
+         *
+         */
+        const struct reassembly_counters& counters() const;
+
+        private:
+
+        struct object_state
+        {
+            bool used = false;
+            bool open = false;
+            bool complete = false;
+            bool interrupted = false;
+            uint32_t object_number = 0;
+            uint32_t total_fragments = 0;
+            uint32_t received = 0;
+            uint32_t highest_fragment = 0;
+            int64_t first_send_ns = 0;
+            // one bit per fragment, only grows
+            std::vector<uint64_t> bitmap;
+        };
+
+        /**
+         * @brief Declare an open object lost
+         *
+         */
+        void close_lost(struct object_state& object);
+
+        struct object_state objects[REASSEMBLY_WINDOW];
+
+        int64_t deadline_ns;
+
+        bool newest_valid;
+
+        uint32_t newest_object;
+
+        uint32_t newest_total;
+
+        int32_t newest_mode;
+
+        bool fragment_count_mode_changes;
+
+        struct reassembly_counters counter;
+    };
+
+};
+
+#endif
@@ -0,0 +1,232 @@
+// Copyright (C) 2025 IDA
+//
+// This file is part of a project licensed under the GNU Lesser General Public License v3.0.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+
+#ifndef SINK_RECORD_WRITER_h
+#define SINK_RECORD_WRITER_h
+
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <cstdio>
+#include <cstdint>
+
+#include <rscmng/utils/log.hpp>
+
+
+namespace traffic_statistic
+{
+
+    // Records per sink thread ring, must be a power of two
+    #define SINK_RECORD_RING_SIZE 16384
+    // Records per write of the writer thread
+    #define SINK_RECORD_WRITE_BATCH 8192
+    // Interval the writer thread flushes buffered records to the file
+    #define SINK_RECORD_FLUSH_INTERVAL_MS 100
+    #define SINK_RECORD_FILE_MAGIC "RMSINK01"
+    #define SINK_RECORD_FILE_EXTENSION ".rec"
+
+    /**
+     * @brief Fixed size binary record of a received fragment. Fields are only appended, the record size
+     * in the file header tells the converter which fields a file contains.
+     *
+     */
+    struct sink_record
+    {
+        uint64_t service_id;
+        uint32_t object_number;
+        uint32_t fragment_number;
+        int64_t send_sec;
+        int64_t send_nsec;
+        // time the sink thread got the datagram (after receive)
+        int64_t receive_sec;
+        int64_t receive_nsec;
+        // IPv4 source address in host byte order
+        uint32_t source_address;
+        uint16_t source_port;
+        uint16_t reserved;
+        // kernel receive timestamp, 0 if not available
+        int64_t kernel_receive_sec;
+        int64_t kernel_receive_nsec;
+    };
+
+    /**
+     * @brief Header at the start of a record file
+     *
+     */
+    struct sink_record_file_header
+    {
+        char magic[8];
+        uint32_t record_size;
+        // IPv4 sink address in host byte order
+        uint32_t local_address;
+        uint32_t local_port;
+        uint32_t reserved;
+    };
+
+    /**
+     * @brief Preallocated single producer single consumer ring of records. The sink thread pushes,
+     * the writer thread pops, neither blocks. Records are dropped and counted if the ring is full.
+     *
+     */
+    class SinkRecordRing
+    {
+        public:
+
+        /**
+         * @brief Construct a new Sink Record Ring object and prefault its storage
+         *
+         * @param capacity number of records, power of two
+         */
+        explicit SinkRecordRing(size_t capacity);
+
+        SinkRecordRing(const SinkRecordRing&) = delete;
+
+        SinkRecordRing& operator=(const SinkRecordRing&) = delete;
+
+        /**
+         * @brief Append a record (producer)
+         *
+         * @return false if the ring is full and the record was dropped
+         */
+        bool push(const struct sink_record& record);
+
+        /**
+         * @brief Remove up to max_records records in order (consumer)
+         *
+         * @return size_t number of records copied to records
+         */
+        size_t pop(struct sink_record* records, size_t max_records);
+
+        /**
+         * @brief Number of records dropped because the ring was full
+         *
+         */
+        uint64_t dropped() const;
+
+        private:
+
+        std::vector<struct sink_record> records;
+
+        size_t mask;
+
+        std::atomic<uint64_t> head;
+
+        // keeps producer and consumer index on separate cache lines
+        char padding[64];
+
+        std::atomic<uint64_t> tail;
+
+        std::atomic<uint64_t> dropped_count;
+    };
+
+    /**
+     * @brief Drains the record rings of the sink threads with one background thread into one binary
+     * record file per sink port (<prefix>_<ip>_<port>.rec) using large buffered sequential writes.
+     *
+     */
+    class SinkRecordWriter
+    {
+        public:
+
+        /**
+         * @brief Construct a new Sink Record Writer object
+         *
+         * @param file_prefix prefix of the record files
+         */
+        explicit SinkRecordWriter(std::string file_prefix);
+
+        /**
+         * @brief Destroy the Sink Record Writer object, writes all pending records
+         *
+         */
+        ~SinkRecordWriter();
+
+        SinkRecordWriter(const SinkRecordWriter&) = delete;
+
+        SinkRecordWriter& operator=(const SinkRecordWriter&) = delete;
+
+        /**
+         * @brief Create the ring and record file of a sink port, starts the writer thread with the first ring
+         *
+         * @param local_ip_address sink address
+         * @param local_port sink port
+         * @param file_suffix appended to the file name, separates several sockets of one port
+         * @return std::shared_ptr<SinkRecordRing> ring to be filled by the sink thread, nullptr if the file could not be opened
+         */
+        std::shared_ptr<SinkRecordRing> create_ring(std::string local_ip_address, uint32_t local_port, std::string file_suffix = "");
+
+        /**
+         * @brief Stop the writer thread after writing all pending records
+         *
+         */
+        void stop();
+
+        /**
+         * @brief Convert a record file to the text logs of the sink (<prefix>_<ip>.log and <prefix>_<ip>_all.log).
+         * The receive time is the kernel receive timestamp if the record has one.
+         *
+         * @param record_file_name record file
+         * @param text_prefix prefix of the text logs
+         * @return true if the file was converted completely
+         */
+        static bool convert_to_text(std::string record_file_name, std::string text_prefix);
+
+        private:
+
+        struct record_stream
+        {
+            std::shared_ptr<SinkRecordRing> ring;
+            FILE* file;
+            std::string file_name;
+            std::vector<char> file_buffer;
+            uint64_t written;
+        };
+
+        /**
+         * @brief Writer thread, drains all rings and flushes periodically
+         *
+         */
+        void run();
+
+        /**
+         * @brief Write all records currently in the ring of a stream
+         *
+         * @return size_t number of records written
+         */
+        size_t drain(struct record_stream& stream);
+
+        std::string file_prefix;
+
+        std::vector<std::shared_ptr<struct record_stream>> streams;
+
+        std::mutex stream_mutex;
+
+        std::thread writer;
+
+        std::atomic<bool> active;
+
+        std::vector<struct sink_record> write_buffer;
+    };
+
+};
+
+#endif
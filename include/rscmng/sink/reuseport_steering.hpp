@@ -0,0 +1,69 @@
+// Copyright (C) 2025 IDA
+//
+// This file is part of a project licensed under the GNU Lesser General Public License v3.0.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+
+#ifndef REUSEPORT_STEERING_h
+#define REUSEPORT_STEERING_h
+
+
+#include <vector>
+#include <cstdint>
+
+#include <linux/filter.h>
+
+#include <rscmng/utils/log.hpp>
+
+
+#ifndef SO_ATTACH_REUSEPORT_CBPF
+#define SO_ATTACH_REUSEPORT_CBPF 51
+#endif
+
+
+namespace traffic_statistic
+{
+
+    // Offset of the service id in the v1 data message header (after priority and source id)
+    #define STEERING_SERVICE_ID_OFFSET 5
+    // Instructions of the steering block of one header format
+    #define STEERING_BLOCK_LENGTH 15
+
+    /**
+     * @brief Shard a service is steered to, the lower 32 bits of the service id modulo the shard count
+     *
+     */
+    uint32_t service_shard(uint64_t service_id, uint32_t shard_count);
+
+    /**
+     * @brief Attach a classic BPF program to a SO_REUSEPORT group that selects the socket by service_shard
+     * of the data message, v1 headers and the compact v2/v3 headers are told apart by the marker byte. The program returns the index of the socket in the group, which is the order in
+     * which the sockets were bound. Datagrams too short to carry a service id go to the first socket.
+     *
+     * @param socket_fd any socket of the group
+     * @param shard_count number of sockets in the group
+     * @return true if the program was attached, the kernel hashes the 4-tuple otherwise
+     */
+    bool attach_service_steering(int socket_fd, uint32_t shard_count);
+
+    /**
+     * @brief Append the instructions that return service_shard of the service id at an offset
+     *
+     */
+    void append_steering_block(std::vector<struct sock_filter>& steering_code, uint32_t service_id_offset, uint32_t shard_count);
+
+};
+
+#endif
@@ -0,0 +1,78 @@
+// Copyright (C) 2025 IDA
+//
+// This file is part of a project licensed under the GNU Lesser General Public License v3.0.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+
+#ifndef RX_TIMESTAMP_h
+#define RX_TIMESTAMP_h
+
+
+#include <string>
+#include <ctime>
+
+#include <sys/socket.h>
+#include <linux/net_tstamp.h>
+
+#include <rscmng/utils/log.hpp>
+
+
+namespace traffic_statistic
+{
+
+    // Control message space of a receive timestamp (SCM_TIMESTAMPING carries three timespecs)
+    #define RX_TIMESTAMP_CONTROL_SIZE CMSG_SPACE(3 * sizeof(struct timespec))
+
+    /**
+     * @brief Source of the kernel receive timestamp of the sink
+     *
+     */
+    enum RxTimestampMode
+    {
+        RX_TIMESTAMP_NONE = 0,
+        // SO_TIMESTAMPNS, taken when the datagram enters the stack
+        RX_TIMESTAMP_SOFTWARE,
+        // SO_TIMESTAMPING raw hardware timestamp, software timestamp for datagrams without one.
+        // The NIC must be configured to timestamp all received packets and its clock synchronized to CLOCK_REALTIME.
+        RX_TIMESTAMP_HARDWARE
+    };
+
+    /**
+     * @brief Map the RECEIVE_TIMESTAMPING config value (NONE, SOFTWARE, HARDWARE) to the mode
+     *
+     */
+    RxTimestampMode rx_timestamp_mode_from_string(std::string mode_name);
+
+    /**
+     * @brief Enable receive timestamps on a socket, falls back from HARDWARE to SOFTWARE to NONE
+     *
+     * @param socket_fd native handle of a bound UDP socket
+     * @param mode requested mode
+     * @return RxTimestampMode mode that is active on the socket
+     */
+    RxTimestampMode enable_rx_timestamps(int socket_fd, RxTimestampMode mode);
+
+    /**
+     * @brief Read the kernel receive timestamp from the control messages of a received datagram
+     *
+     * @param message message header filled by recvmsg or recvmmsg
+     * @param timestamp receive timestamp (CLOCK_REALTIME or NIC clock)
+     * @return true if the message carried a timestamp
+     */
+    bool read_rx_timestamp(const struct msghdr& message, struct timespec& timestamp);
+
+};
+
+#endif
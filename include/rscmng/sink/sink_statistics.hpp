@@ -0,0 +1,190 @@
+// Copyright (C) 2025 IDA
+//
+// This file is part of a project licensed under the GNU Lesser General Public License v3.0.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+
+#ifndef SINK_STATISTICS_h
+#define SINK_STATISTICS_h
+
+
+#include <map>
+#include <vector>
+#include <string>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <cstdint>
+
+#include <rscmng/utils/log.hpp>
+#include <rscmng/utils/histogram.hpp>
+#include <rscmng/sink/reassembly_tracker.hpp>
+
+
+namespace traffic_statistic
+{
+
+    // Number of services a sink can track, power of two
+    #define SINK_STATISTICS_MAX_SERVICES 256
+    // Smallest service table, room for services that are seen but not configured
+    #define SINK_STATISTICS_MIN_SERVICES 16
+
+    /**
+     * @brief Percentiles of a latency histogram in ns
+     *
+     */
+    struct latency_percentiles
+    {
+        uint64_t count;
+        uint64_t min;
+        uint64_t p50;
+        uint64_t p90;
+        uint64_t p99;
+        uint64_t p999;
+        uint64_t max;
+    };
+
+    /**
+     * @brief Statistics of one service at the time of the snapshot
+     *
+     */
+    struct service_statistics_snapshot
+    {
+        uint64_t service_id;
+        int64_t deadline_ns;
+        uint64_t fragments;
+        struct reassembly_counters reassembly;
+        // send timestamp to receive timestamp of every fragment
+        struct latency_percentiles fragment_delay;
+        // send timestamp of the first fragment to the receive timestamp of the last fragment of an object
+        struct latency_percentiles object_completion;
+    };
+
+    /**
+     * @brief Online statistics of the sink keyed by service id. Services live in a fixed open addressing
+     * table sized to the configured services that is only ever appended with compare and swap, all counters
+     * and histograms are relaxed atomics. Receive threads record without locks, only the object reassembly of
+     * a service is serialized on a per service mutex that is held for a few bitmap operations. A blocked
+     * receive thread sleeps instead of spinning, so a preempted snapshot thread cannot starve it.
+     * Snapshots read without stopping the receive threads.
+     *
+     */
+    class SinkStatistics
+    {
+        public:
+
+        /**
+         * @brief Construct a new Sink Statistics object
+         *
+         * @param service_count configured services, the table holds twice as many (at least
+         * SINK_STATISTICS_MIN_SERVICES, at most SINK_STATISTICS_MAX_SERVICES)
+         */
+        explicit SinkStatistics(uint32_t service_count = SINK_STATISTICS_MAX_SERVICES);
+
+        SinkStatistics(const SinkStatistics&) = delete;
+
+        SinkStatistics& operator=(const SinkStatistics&) = delete;
+
+        /**
+         * @brief Register a service with its deadline, services not registered are tracked without deadline
+         *
+         * @param service_id service id
+         * @param deadline_ns object deadline relative to the send time of its first fragment, 0 for none
+         * @param constant_size false disables mode changes inferred from the fragment count
+         */
+        void register_service(uint64_t service_id, int64_t deadline_ns, bool constant_size = true);
+
+        /**
+         * @brief Record a received fragment
+         *
+         * @param service_id service id
+         * @param object_number object number
+         * @param fragment_number fragment number (0 based)
+         * @param total_fragments fragments of the object
+         * @param send_ns send timestamp of the fragment (CLOCK_REALTIME)
+         * @param receive_ns receive timestamp of the fragment (CLOCK_REALTIME)
+         * @param mode mode of the service from the header, -1 if not carried
+         */
+        void record_fragment(uint64_t service_id, uint32_t object_number, uint32_t fragment_number, uint32_t total_fragments, int64_t send_ns, int64_t receive_ns, int32_t mode = -1);
+
+        /**
+         * @brief Statistics of all services seen or registered so far, objects past their deadline are declared lost
+         *
+         */
+        std::vector<struct service_statistics_snapshot> snapshot();
+
+        /**
+         * @brief Statistics of several shards merged per service: counters are summed, histograms merged
+         *
+         */
+        static std::vector<struct service_statistics_snapshot> snapshot(const std::vector<SinkStatistics*>& shards);
+
+        /**
+         * @brief Log a snapshot
+         *
+         */
+        void print(std::string name);
+
+        /**
+         * @brief Log a merged snapshot of several shards
+         *
+         */
+        static void print(std::string name, const std::vector<SinkStatistics*>& shards);
+
+        private:
+
+        struct service_slot
+        {
+            // service id + 1, 0 marks a free slot
+            std::atomic<uint64_t> key;
+            std::atomic<int64_t> deadline_ns;
+            std::atomic<uint64_t> fragments;
+            rscmng::LogLinearHistogram fragment_delay;
+            rscmng::LogLinearHistogram object_completion;
+            // guards reassembly
+            std::mutex object_mutex;
+            ReassemblyTracker reassembly;
+        };
+
+        /**
+         * @brief Find or insert the slot of a service
+         *
+         * @return service_slot* nullptr if the table is full
+         */
+        struct service_slot* slot(uint64_t service_id);
+
+        /**
+         * @brief Percentiles of a histogram
+         *
+         */
+        static struct latency_percentiles percentiles_of(const rscmng::LogLinearHistogram& histogram);
+
+        /**
+         * @brief Add the counters of a shard to a sum
+         *
+         */
+        static void add_counters(struct reassembly_counters& sum, const struct reassembly_counters& counters);
+
+        // table size, power of two
+        uint32_t capacity;
+
+        std::unique_ptr<struct service_slot[]> slots;
+
+        std::atomic<uint64_t> dropped_services;
+    };
+
+};
+
+#endif
@@ -30,9 +30,12 @@
 #include <sstream>
 #include <vector>
 #include <map>
+#include <set>
 #include <chrono>
 #include <csignal>
 #include <ctime>
+#include <memory>
+#include <array>
 
 #include <boost/bind/bind.hpp>
 #include <boost/asio.hpp>
@@ -50,9 +53,20 @@
 
 #include <rscmng/utils/log.hpp>
 #include <rscmng/utils/config_reader.hpp>
+#include <rscmng/utils/pacing_engine.hpp>
+#include <rscmng/utils/hyperperiod_timeline.hpp>
+#include <rscmng/utils/realtime_profile.hpp>
 #include <rscmng/attributes/demonstrator_config.hpp>
 #include <rscmng/messages.hpp>
 #include <rscmng/rm_abstraction.hpp>
+#include <rscmng/generator_control.hpp>
+#include <rscmng/transmit/batch_sender.hpp>
+#include <rscmng/transmit/gso_sender.hpp>
+#include <rscmng/transmit/txtime_sender.hpp>
+#include <rscmng/transmit/packet_ring_sender.hpp>
+#include <rscmng/transmit/tx_timestamp_collector.hpp>
+#include <rscmng/transmit/payload_source.hpp>
+#include <rscmng/traffic_model.hpp>
 
 
 namespace traffic_generator 
@@ -63,14 +77,13 @@ namespace traffic_generator
         NORMAL_BURST
     };
 
-    enum TrafficSourceControl
+    enum TransmitBackend
     {
-        THREAD_START = 0,
-        THREAD_STOP,
-        THREAD_PAUSED,
-        THREAD_TRANSMISSION,
-        THREAD_TRANSMISSION_FINISH_OBJECT,
-        THREAD_RECONFIGURE
+        TRANSMIT_SOCKET = 0,
+        TRANSMIT_BATCH,
+        TRANSMIT_GSO,
+        TRANSMIT_TXTIME,
+        TRANSMIT_PACKET_RING
     };
 
 
@@ -85,37 +98,311 @@ namespace traffic_generator
         u_int32_t number_packets = 2000;
         long auto_traffic_termination = 5000;
         long slack_factor = 0.75;
+        rscmng::PacingStrategy pacing_strategy = rscmng::PACING_SLEEP_SPIN;
+        std::chrono::microseconds pacing_spin_margin = std::chrono::microseconds(50);
+        TransmitBackend transmit_backend = TRANSMIT_SOCKET;
+        uint32_t batch_size = 32;
+        std::chrono::microseconds txtime_lead = std::chrono::microseconds(500);
+        bool txtime_log_only = false;
+        bool tx_timestamping = false;
+        rscmng::DataMessageVersion message_version = rscmng::DATA_MESSAGE_V1;
     };
 
 
-    class TrafficGenerator
+    /**
+     * @brief Immutable transmission parameters of one mode, compiled at construction so a mode switch
+     * in the sending thread only swaps the plan pointer
+     * 
+     */
+    struct transmission_plan
+    {
+        uint32_t mode;
+        const struct rscmng::config::service_settings* settings;
+        udp::endpoint destination;
+        uint32_t number_packets;
+        rscmng::DataMessageTemplate header_template;
+        // payload of a full fragment, limited by the route MTU with segmentation offload
+        size_t max_payload;
+        int64_t inter_packet_gap_ns;
+        int64_t deadline_ns;
+        double estimated_transmission_time_ms;
+        std::shared_ptr<PayloadSource> payload_source;
+        std::shared_ptr<const TrafficSchedule> schedule;
+    };
+
+
+    /**
+     * @brief State of the sending thread, the current plan, the position on the object timeline and the running object
+     * 
+     */
+    struct transmission_state
     {
+        uint32_t mode = static_cast<uint32_t>(-1);
+        const struct transmission_plan* plan = nullptr;
+        uint64_t period_version = 0;
+        // Objects are released at offsets into the slots of the object timeline, as compiled in the traffic schedule
+        uint64_t object_slot = 0;
+        uint32_t schedule_entry = 0;
+        bool release_pending = true;
+        // Notification time of a switch whose first fragment is still pending, -1 if none
+        int64_t switch_notify_ns = -1;
+        long object_number = 1;
+        struct payload_object payload = {nullptr, 0, 0, 0};
+        rscmng::DataMessageTemplate header_template;
+        uint32_t fragment_number = 0;
+        uint64_t remaining_bytes = 0;
+        // payload of a full fragment of the running object, fixed at its release
+        size_t fragment_payload = 0;
+        size_t payload_size = 0;
+        struct timespec object_launch_time = {0,0};
+        struct timespec fragment_deadline = {0,0};
+        struct timespec previous_send = {0,0};
+    };
+
+
+    /**
+     * @brief Map the TRANSMIT_BACKEND config value (SOCKET, BATCH, GSO, TXTIME, PACKET_RING) to the backend
+     * 
+     */
+    TransmitBackend transmit_backend_from_string(std::string backend_name);
+
+
+    /**
+     * @brief Socket and transmit backend of one sending thread. Fragments go to the backend selected by
+     * TRANSMIT_BACKEND, the TX timestamps of the socket are collected if enabled. A path is used by a single thread.
+     * 
+     */
+    class TransmitPath
+    {
+        public:
+
+        /**
+         * @brief Open and bind the socket and set up the transmit backend
+         * 
+         * @param local_endpoint local address of the socket
+         * @param traffic_pattern backend, batch size, launch time and timestamping settings
+         * @param name log prefix
+         */
+        TransmitPath(const udp::endpoint& local_endpoint, const traffic_generator_parameter& traffic_pattern, std::string name);
+
+        /**
+         * @brief Prepare the backend for a destination of a plan. The packet ring resolves its next hop,
+         * an unresolved destination is sent through the UDP socket.
+         * 
+         */
+        void prepare_destination(const udp::endpoint& destination);
+
+        /**
+         * @brief Payload of a full fragment towards a destination, limited by the route MTU with segmentation offload
+         * 
+         */
+        size_t max_payload(const rscmng::DataMessageTemplate& header_template, const udp::endpoint& destination);
+
+        /**
+         * @brief Hand a serialized fragment to the transmit backend
+         * 
+         * @param header_template object header with patched fragment number and timestamp
+         * @param payload fragment payload, referenced until the fragment is on the wire
+         * @param payload_size payload length
+         * @param destination target endpoint
+         * @param last_fragment forces a flush of a pending batch
+         * @param launch_time intended launch time of the fragment (CLOCK_REALTIME), used by the launch time backend
+         * @return uint32_t number of fragments put on the wire by this call
+         */
+        uint32_t transmit_fragment(const rscmng::DataMessageTemplate& header_template, const char* payload, size_t payload_size, const udp::endpoint& destination, bool last_fragment, const struct timespec& launch_time);
+
+        /**
+         * @brief Transmit fragments still pending in the batch backend
+         * 
+         * @return uint32_t number of fragments put on the wire
+         */
+        uint32_t flush();
+
+        /**
+         * @brief Register the next fragment for TX timestamping, no-op without timestamping
+         * 
+         */
+        void register_fragment(rscmng::serviceID_t service_id, uint32_t object_number, uint32_t fragment_number, const struct timespec& send_time);
+
+        /**
+         * @brief Read TX timestamps once enough fragments are in flight, called per fragment
+         * 
+         */
+        void poll_timestamps();
+
+        /**
+         * @brief Read all pending TX timestamps, called per object
+         * 
+         */
+        void drain_timestamps();
+
+        /**
+         * @brief Backend in use, SOCKET if the configured backend is not available
+         * 
+         */
+        TransmitBackend backend() const;
+
+        /**
+         * @brief Time a fragment is handed to the kernel ahead of its launch time, 0 without SO_TXTIME
+         * 
+         */
+        int64_t launch_lead_ns() const;
+
+        /**
+         * @brief Flush pending fragments and close the socket
+         * 
+         */
+        void close();
+
+        /**
+         * @brief Print backend and TX timestamping statistics
+         * 
+         */
+        void print_statistics();
+
         private:
 
-        std::mutex global_mutex;
+        std::string path_name;
+
+        boost::asio::io_context transmit_context;
+
+        udp::socket transmit_socket;
+
+        udp::endpoint transmit_endpoint_local;
+
+        int64_t txtime_lead_ns;
+
+        std::unique_ptr<BatchSender> batch_sender;
 
-        std::condition_variable generator_conditioning_variable;
+        std::unique_ptr<GsoSender> gso_sender;
 
-        TrafficSourceControl traffic_generator_control;
+        std::unique_ptr<TxTimeSender> txtime_sender;
+
+        std::unique_ptr<PacketRingSender> packet_ring_sender;
+
+        // destinations of the packet ring without resolved next hop, sent through the socket
+        std::set<udp::endpoint> socket_destinations;
+
+        std::unique_ptr<TxTimestampCollector> tx_timestamps;
+    };
+
+
+    /**
+     * @brief Resolve endpoints, map payload sources, compile the traffic schedules and serialize the header of every mode
+     * 
+     * @param service_settings modes of a service, number of packets and estimated transmission time are filled in
+     * @param client_id ID of the transmitting application
+     * @param message_version wire format
+     * @param transmit_path path the plans are sent on, limits the fragment payload
+     * @return std::map<uint32_t, struct transmission_plan> plan per mode, modes with an unresolvable destination are missing
+     */
+    std::map<uint32_t, struct transmission_plan> compile_transmission_plans(
+        std::map<uint32_t, struct rscmng::config::service_settings>& service_settings,
+        uint32_t client_id,
+        rscmng::DataMessageVersion message_version,
+        TransmitPath& transmit_path
+    );
+
+
+    /**
+     * @brief Payload of the next object of a plan, a mapped frame or the dummy payload with the scheduled object size
+     * 
+     * @param plan transmission plan of the current mode
+     * @param size_bytes scheduled object size, ignored for mapped frames
+     * @param dummy_payload fragment sized buffer reused for every fragment
+     * @return struct payload_object object payload and its fragment count
+     */
+    struct payload_object next_payload(const struct transmission_plan& plan, uint64_t size_bytes, const std::vector<char>& dummy_payload);
+
+
+    /**
+     * @brief Continue the running object after a mode switch within the object. Payload and fragmentation were
+     * fixed at the release of the object, header fields and destination follow the plan of the new mode.
+     * 
+     */
+    void resume_object(struct transmission_state& state);
+
+
+    class TrafficGenerator
+    {
+        private:
 
-        uint32_t mode_global;
+        GeneratorControl generator_control;
 
-        bool stop_thread;
+        std::atomic<bool> stop_thread;
 
         std::string log_prefix = "";
 
+        std::unique_ptr<TransmitPath> transmit_path;
 
-        public:
+        std::map<uint32_t, struct transmission_plan> transmission_plans;
 
-        uint32_t sender_id;
+        std::atomic<int64_t> mode_notify_ns;
 
-        uint32_t thread_id;
+        rscmng::LogLinearHistogram mode_switch_latency;
+
+        rscmng::LogLinearHistogram packet_gap_error;
+
+        uint64_t sent_fragment_count;
+
+        uint64_t sent_byte_count;
+
+        int64_t thread_cpu_ns;
+
+        /**
+         * @brief Plan of a mode, nullptr for an unknown mode
+         * 
+         */
+        const struct transmission_plan* plan_for(uint32_t mode) const;
+
+        /**
+         * @brief Remember the notification time of a mode change (CLOCK_MONOTONIC)
+         * 
+         */
+        void stamp_mode_notification();
+
+        /**
+         * @brief Record notify to first fragment latency of a mode switch
+         * 
+         */
+        void record_mode_switch(const struct transmission_plan& plan, int64_t notify_ns, const struct timespec& period_start);
 
-        boost::asio::io_context traffic_context;
+        /**
+         * @brief Advance to the next scheduled release (skipping periods without objects) and wait for it
+         * 
+         * @param schedule traffic schedule of the current mode
+         * @param object_slot slot of the object timeline, advanced past empty periods
+         * @param schedule_entry object of the slot, reset when the slot advances
+         * @param wait_slot_start false to wait only for releases with an offset into their slot
+         * @return int64_t lateness of the wait in ns, negative if interrupted by a change
+         */
+        int64_t wait_for_release(const TrafficSchedule& schedule, uint64_t& object_slot, uint32_t& schedule_entry, bool wait_slot_start);
 
-        udp::socket traffic_socket;
+        /**
+         * @brief Switch to the plan of a published mode and re-anchor the object timeline on a new period
+         * 
+         * @return false for an unknown mode
+         */
+        bool apply_control(const control_snapshot& control, struct transmission_state& state);
 
-        udp::endpoint traffic_endpoint_local;
+        /**
+         * @brief Wait for the release of the next object and prepare its payload and header
+         * 
+         */
+        void begin_object(struct transmission_state& state, const std::vector<char>& dummy_payload);
+
+        /**
+         * @brief Send the next fragment of the running object and pace the following one
+         * 
+         */
+        void send_fragment(struct transmission_state& state);
+
+
+        public:
+
+        uint32_t sender_id;
+
+        uint32_t thread_id;
 
         std::map<uint32_t, struct rscmng::config::service_settings> service_settings_struct;
 
@@ -125,13 +412,15 @@ namespace traffic_generator
 
         traffic_generator_parameter traffic_pattern;
 
+        rscmng::PacingEngine packet_pacing;
+
+        rscmng::HyperperiodTimeline object_timeline;
+
+        rscmng::PacingEngine object_pacing;
+
         TrafficSourceType traffic_source_type;
 
         std::thread traffic_generator;
-       
-        struct timespec global_period_timestamp;
-        
-        bool global_update_period;
 
         
         /**
@@ -164,6 +453,12 @@ namespace traffic_generator
          */
         void stop();
 
+        /**
+         * @brief Wait until the sending thread finished (e.g. after auto traffic termination)
+         * 
+         */
+        void join();
+
         /**
          * @brief Notify shared transmission state for mutex
          * 
@@ -189,28 +484,54 @@ namespace traffic_generator
         void precise_wait_us(double microseconds);
 
         /**
-         * @brief Main send function
+         * @brief Print lateness statistics of the packet and object pacing and the mode switch latency
          * 
          */
-        void send_objects_dynamic_change();
+        void print_pacing_statistics();
 
         /**
-         * @brief Main send function
+         * @brief Histogram of |achieved - configured| gap between consecutive fragments of an object
          * 
          */
-        void send_objects_dynamic_change_asynchron();
+        const rscmng::LogLinearHistogram& inter_packet_gap_error() const;
 
         /**
-         * @brief Select send function
+         * @brief Histogram of the lateness of the object starts
          * 
          */
-        void thread_type_select ();
+        const rscmng::LogLinearHistogram& object_start_lateness() const;
 
         /**
-         * @brief Join threads
+         * @brief Number of fragments handed to the transmit backend
          * 
          */
-        void join();
+        uint64_t fragments_sent() const;
+
+        /**
+         * @brief Number of UDP payload bytes (header + fragment payload) handed to the transmit backend
+         * 
+         */
+        uint64_t bytes_sent() const;
+
+        /**
+         * @brief CPU time of the sending thread, valid once the thread finished
+         * 
+         */
+        int64_t thread_cpu_time_ns() const;
+
+        /**
+         * @brief Main send function
+         * 
+         * @param mode_change_within_object apply mode changes to the running object (asynchronous start mode)
+         */
+        void send_objects(bool mode_change_within_object);
+
+        /**
+         * @brief Select send function
+         * 
+         */
+        void thread_type_select ();
+
 
     };
 
@@ -0,0 +1,293 @@
+// Copyright (C) 2025 IDA
+//
+// This file is part of a project licensed under the GNU Lesser General Public License v3.0.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+
+#ifndef TRAFFIC_MODEL_h
+#define TRAFFIC_MODEL_h
+
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <random>
+#include <cstdint>
+
+#include <rscmng/utils/log.hpp>
+#include <rscmng/utils/config_reader.hpp>
+
+
+namespace traffic_generator
+{
+
+    // Draws of a size outside [SIZE_MIN, SIZE_MAX] before the sample is clamped to the bounds
+    #define SIZE_DISTRIBUTION_MAX_REDRAWS 16
+
+    /**
+     * @brief Release of one object, relative to the start of its period
+     *
+     */
+    struct object_release
+    {
+        int64_t offset_ns;
+        uint32_t size_bytes;
+    };
+
+    /**
+     * @brief Object size distribution of a traffic model
+     *
+     */
+    class SizeDistribution
+    {
+        public:
+
+        /**
+         * @brief Construct a new Size Distribution object
+         *
+         * @param settings traffic model settings (SIZE_DISTRIBUTION, SIZE_MIN, SIZE_MAX, SIZE_STDDEV), the bounds default to [1 byte, 2 x mean],
+         * SIZE_STDDEV of a NORMAL distribution defaults to mean / 4
+         * @param mean_bytes mean object size (the configured OBJECT_SIZE)
+         */
+        SizeDistribution(const struct rscmng::config::traffic_model_settings& settings, uint64_t mean_bytes);
+
+        /**
+         * @brief Draw one object size, at least one byte. Draws outside [SIZE_MIN, SIZE_MAX] are redrawn,
+         * so the sizes follow the distribution truncated to the bounds instead of piling up at them
+         *
+         */
+        uint32_t sample(std::mt19937_64& generator) const;
+
+        /**
+         * @brief True if every object has the mean size
+         *
+         */
+        bool constant() const;
+
+        private:
+
+        enum DistributionType
+        {
+            SIZE_CONSTANT = 0,
+            SIZE_UNIFORM,
+            SIZE_NORMAL,
+            SIZE_EXPONENTIAL
+        };
+
+        DistributionType distribution_type;
+
+        double mean_bytes;
+
+        double min_bytes;
+
+        double max_bytes;
+
+        double stddev_bytes;
+    };
+
+    /**
+     * @brief Traffic model, generates the object releases of a stream of periods.
+     * Models are only evaluated when the schedule is compiled, never in the send loop.
+     *
+     */
+    class TrafficModel
+    {
+        public:
+
+        virtual ~TrafficModel() {}
+
+        /**
+         * @brief Generate the releases of periods [0, periods), ordered by time
+         *
+         * @param period_ns period length
+         * @param periods number of periods
+         * @param generator random generator of the schedule
+         * @param releases output, offsets relative to the start of period 0
+         */
+        virtual void generate(int64_t period_ns, uint32_t periods, std::mt19937_64& generator, std::vector<struct object_release>& releases) const = 0;
+
+        /**
+         * @brief Number of periods the model needs to be represented, 0 for the configured schedule length
+         *
+         */
+        virtual uint32_t natural_periods(int64_t period_ns) const;
+
+        /**
+         * @brief Model name for logging
+         *
+         */
+        virtual std::string name() const = 0;
+    };
+
+    /**
+     * @brief One object at the start of every period (the classic periodic sensor)
+     *
+     */
+    class PeriodicModel : public TrafficModel
+    {
+        public:
+
+        PeriodicModel(const SizeDistribution& sizes);
+
+        void generate(int64_t period_ns, uint32_t periods, std::mt19937_64& generator, std::vector<struct object_release>& releases) const override;
+
+        uint32_t natural_periods(int64_t period_ns) const override;
+
+        std::string name() const override;
+
+        private:
+
+        SizeDistribution sizes;
+    };
+
+    /**
+     * @brief Poisson arrivals with a mean rate, i.e. exponential inter arrival times
+     *
+     */
+    class PoissonModel : public TrafficModel
+    {
+        public:
+
+        PoissonModel(double rate_per_second, const SizeDistribution& sizes);
+
+        void generate(int64_t period_ns, uint32_t periods, std::mt19937_64& generator, std::vector<struct object_release>& releases) const override;
+
+        std::string name() const override;
+
+        private:
+
+        double rate_per_second;
+
+        SizeDistribution sizes;
+    };
+
+    /**
+     * @brief On/off bursts, exponentially distributed on and off phases with a constant arrival rate while on
+     *
+     */
+    class OnOffModel : public TrafficModel
+    {
+        public:
+
+        OnOffModel(double rate_per_second, uint32_t mean_on_ms, uint32_t mean_off_ms, const SizeDistribution& sizes);
+
+        void generate(int64_t period_ns, uint32_t periods, std::mt19937_64& generator, std::vector<struct object_release>& releases) const override;
+
+        std::string name() const override;
+
+        private:
+
+        double rate_per_second;
+
+        double mean_on_ns;
+
+        double mean_off_ns;
+
+        SizeDistribution sizes;
+    };
+
+    /**
+     * @brief Replay of a recorded trace, one "time[ms] size[byte]" pair per line ('#' starts a comment).
+     * Times are relative to the first record, the trace repeats after its last period.
+     *
+     */
+    class TraceModel : public TrafficModel
+    {
+        public:
+
+        TraceModel(std::string trace_path);
+
+        bool valid() const;
+
+        void generate(int64_t period_ns, uint32_t periods, std::mt19937_64& generator, std::vector<struct object_release>& releases) const override;
+
+        uint32_t natural_periods(int64_t period_ns) const override;
+
+        std::string name() const override;
+
+        private:
+
+        std::string trace_path;
+
+        std::vector<struct object_release> records;
+    };
+
+    /**
+     * @brief Releases of a model compiled for a fixed number of periods, repeated cyclically.
+     * Period p of the stream uses compiled period p % periods, entries of a period are contiguous.
+     *
+     */
+    class TrafficSchedule
+    {
+        public:
+
+        /**
+         * @brief Compile a model
+         *
+         * @param model traffic model
+         * @param period_ns period length
+         * @param periods schedule length if the model has no natural length
+         * @param seed seed of the random generator, equal seeds give equal schedules
+         */
+        TrafficSchedule(const TrafficModel& model, int64_t period_ns, uint32_t periods, uint32_t seed);
+
+        /**
+         * @brief Number of objects released in a period
+         *
+         */
+        uint32_t objects_in_period(uint64_t period) const;
+
+        /**
+         * @brief Release of an object of a period
+         *
+         */
+        const struct object_release& release(uint64_t period, uint32_t index) const;
+
+        /**
+         * @brief Number of compiled periods
+         *
+         */
+        uint32_t period_count() const;
+
+        /**
+         * @brief Number of compiled releases
+         *
+         */
+        uint64_t release_count() const;
+
+        /**
+         * @brief Sum of all compiled object sizes
+         *
+         */
+        uint64_t total_bytes() const;
+
+        private:
+
+        std::vector<struct object_release> releases;
+
+        std::vector<uint32_t> period_begin;
+
+        uint64_t compiled_bytes;
+    };
+
+    /**
+     * @brief Build the model configured for a service (TRAFFIC_MODEL TYPE: PERIODIC, POISSON, ON_OFF, TRACE)
+     *
+     */
+    std::unique_ptr<TrafficModel> make_traffic_model(const struct rscmng::config::service_settings& settings);
+
+};
+
+#endif
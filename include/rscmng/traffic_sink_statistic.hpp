@@ -30,6 +30,7 @@
 #include <sstream>
 #include <vector>
 #include <map>
+#include <set>
 #include <chrono>
 #include <csignal>
 #include <ctime>
@@ -49,6 +50,15 @@
 #include <boost/log/sources/severity_logger.hpp>
 #include <boost/log/sources/record_ostream.hpp>
 
+#include <rscmng/utils/realtime_profile.hpp>
+#include <rscmng/sink/record_writer.hpp>
+#include <rscmng/sink/batch_receiver.hpp>
+#include <rscmng/sink/rx_timestamp.hpp>
+#include <rscmng/sink/sink_statistics.hpp>
+#include <rscmng/sink/event_loop.hpp>
+#include <rscmng/sink/reuseport_steering.hpp>
+#include <rscmng/sink/kernel_counter.hpp>
+#include <rscmng/utils/histogram.hpp>
 #include <rscmng/messages.hpp>
 #include <rscmng/rm_abstraction.hpp>
 #include <rscmng/attributes/demonstrator_config.hpp>
@@ -56,16 +66,150 @@
 
 #define FILENAME_LOG "timestamps_object"
 #define LOGGING true
+// Batches received from a ready socket per event loop wakeup
+#define SINK_EVENT_DRAIN_BATCHES 8
 
 
 namespace traffic_statistic
 {
+    enum ReceiveBackend
+    {
+        RECEIVE_SOCKET = 0,
+        RECEIVE_BATCH,
+        // eBPF accounting per service in the kernel, no datagram reaches user space
+        RECEIVE_KERNEL
+    };
+
+    struct traffic_sink_parameter
+    {
+        ReceiveBackend receive_backend = RECEIVE_SOCKET;
+        uint32_t batch_size = 32;
+        bool gro = false;
+        RxTimestampMode rx_timestamp = RX_TIMESTAMP_SOFTWARE;
+        // service id <object deadline in ns>, services without entry are tracked without deadline
+        std::map<uint64_t, int64_t> service_deadlines_ns;
+        // services whose object size varies within a mode, their fragment count does not signal a mode change
+        std::set<uint64_t> variable_size_services;
+        // shared epoll threads of all sinks of the host, nullptr for one blocking thread per port
+        std::shared_ptr<SinkEventLoop> event_loop;
+        // SO_REUSEPORT sockets per port, each with its own pinned thread (or event loop registration)
+        uint32_t shards = 1;
+        // steer datagrams to the shard of their service id, the kernel hashes the 4-tuple otherwise
+        bool shard_steering = true;
+        // interval the KERNEL backend reads and logs the counters of a port
+        std::chrono::milliseconds kernel_poll_interval = std::chrono::milliseconds(1000);
+    };
+
+    /**
+     * @brief Map the RECEIVE_BACKEND config value (SOCKET, BATCH, KERNEL) to the backend
+     * 
+     */
+    ReceiveBackend receive_backend_from_string(std::string backend_name);
+
 
     class TrafficSink
     {
         private:
 
-        
+        traffic_sink_parameter sink_parameter;
+
+        std::string local_ip_address;
+
+        /**
+         * @brief Receive state of one sink port
+         * 
+         */
+        struct sink_port
+        {
+            std::string name;
+            uint32_t shard;
+            SinkStatistics* statistics;
+            // owned by the port in event loop mode, by the port thread otherwise
+            std::unique_ptr<udp::socket> socket;
+            std::shared_ptr<SinkRecordRing> record_ring;
+            // recvmmsg receiver, nullptr for the blocking SOCKET backend
+            std::unique_ptr<BatchReceiver> receiver;
+            rscmng::LogLinearHistogram receive_delay;
+            struct timespec time_statistics;
+        };
+
+        // ports registered with the event loop
+        std::vector<std::unique_ptr<struct sink_port>> event_ports;
+
+        // sockets of the shard threads
+        std::vector<std::unique_ptr<udp::socket>> shard_sockets;
+
+        // one per shard, merged for snapshots
+        std::vector<std::unique_ptr<SinkStatistics>> shard_statistics;
+
+        // counters of the KERNEL backend ports, added by the port threads
+        std::vector<std::pair<std::string, std::unique_ptr<KernelServiceCounter>>> kernel_counters;
+
+        std::mutex kernel_counter_mutex;
+
+        /**
+         * @brief Create the record ring and enable RX timestamps of a bound socket
+         * 
+         * @param batch_size datagrams per recvmmsg call, 0 for the blocking SOCKET backend without receiver
+         * @param shard shard of the socket
+         */
+        std::unique_ptr<struct sink_port> prepare_port(udp::socket &traffic_socket, uint32_t batch_size, uint32_t shard);
+
+        /**
+         * @brief Open and bind one socket per shard, in shard order, and attach the service steering
+         * 
+         * @return std::vector<std::unique_ptr<udp::socket>> sockets, empty on error
+         */
+        std::vector<std::unique_ptr<udp::socket>> open_port_sockets(std::string local_ip_address, uint32_t local_port, bool non_blocking);
+
+        /**
+         * @brief Thread of one shard of a port
+         * 
+         */
+        void run_shard(udp::socket* traffic_socket, uint32_t shard);
+
+        /**
+         * @brief Open a non-blocking socket and register it with the event loop
+         * 
+         */
+        void register_event_port(std::string local_ip_address, uint32_t local_port);
+
+        /**
+         * @brief Attach the kernel counter to the socket and log the per service throughput every poll interval,
+         * falls back to receive_single if the program can not be loaded
+         * 
+         */
+        void receive_kernel(udp::socket &traffic_socket, uint32_t shard);
+
+        /**
+         * @brief Receive one datagram per call
+         * 
+         */
+        void receive_single(udp::socket &traffic_socket, struct sink_port& port);
+
+        /**
+         * @brief Receive up to batch size datagrams with one recvmmsg call, optionally coalesced with UDP GRO
+         * 
+         * @return uint32_t number of received datagrams
+         */
+        uint32_t receive_batch(struct sink_port& port);
+
+        /**
+         * @brief Event loop callback, receive batches of a ready socket until it is empty or SINK_EVENT_DRAIN_BATCHES 
+         * were received to keep the other sockets of the thread responsive
+         * 
+         */
+        void drain_port(struct sink_port& port);
+
+        /**
+         * @brief Parse the header of a received datagram and append its record, the delay between kernel
+         * receive timestamp and time_received (wakeup and scheduling of the sink) is added to the receive delay of the port
+         * 
+         */
+        void record_datagram(struct sink_port& port, const char* data, size_t length, 
+            uint32_t source_address, uint16_t source_port, const struct timespec& time_received, 
+            const struct timespec* kernel_received);
+
         public:
 
 
@@ -89,6 +233,8 @@ namespace traffic_statistic
 
         std::condition_variable &traffic_generator_notify;
 
+        SinkRecordWriter record_writer;
+
         std::vector<std::thread> traffic_generator_list;
          
 
@@ -100,7 +246,8 @@ namespace traffic_statistic
         TrafficSink(
             std::string local_ip_address,
             std::vector<uint32_t> client_local_port,
-            std::condition_variable &traffic_generator_notify
+            std::condition_variable &traffic_generator_notify,
+            traffic_sink_parameter sink_parameter = traffic_sink_parameter()
         );
 
         /**
@@ -118,9 +265,15 @@ namespace traffic_statistic
         /**
          * @brief Handle incomming data messages 
          * 
+         * @param shard shard of the socket, 0 without sharding
          */
-        void handle_message(udp::socket &traffic_socket);
+        void handle_message(udp::socket &traffic_socket, uint32_t shard = 0);
 
+        /**
+         * @brief Log per service latency and object completion statistics, safe while receiving
+         * 
+         */
+        void print_statistics();
 
         /**
          * @brief Join Threads
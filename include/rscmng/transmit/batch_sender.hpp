@@ -0,0 +1,132 @@
+// Copyright (C) 2025 IDA
+//
+// This file is part of a project licensed under the GNU Lesser General Public License v3.0.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+
+#ifndef BATCH_SENDER_h
+#define BATCH_SENDER_h
+
+
+#include <vector>
+#include <string>
+#include <cstring>
+#include <algorithm>
+#include <cstdint>
+
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <netinet/in.h>
+
+#include <boost/asio.hpp>
+
+#include <rscmng/utils/log.hpp>
+
+
+using boost::asio::ip::udp;
+
+
+namespace traffic_generator
+{
+
+    /**
+     * @brief Collects datagrams in preallocated slots and transmits them with a single sendmmsg call.
+     * A slot holds a copy of the (small) header and references the payload, so the payload is not copied.
+     * Every slot keeps its own destination, so a mode change in the middle of a batch does not require a flush.
+     *
+     */
+    class BatchSender
+    {
+        public:
+
+        /**
+         * @brief Construct a new Batch Sender object
+         *
+         * @param socket_fd native handle of a bound UDP socket
+         * @param batch_size maximum number of datagrams per sendmmsg call
+         * @param header_size maximum header length of a single datagram
+         */
+        BatchSender(int socket_fd, uint32_t batch_size, size_t header_size);
+
+        /**
+         * @brief Queue a datagram, the header is copied into the slot, the payload is referenced
+         *
+         * @param header serialized header
+         * @param header_length header length
+         * @param payload payload, must stay valid until flush
+         * @param payload_length payload length
+         * @param destination target endpoint of the datagram
+         */
+        void queue(const char* header, size_t header_length, const char* payload, size_t payload_length, const udp::endpoint& destination);
+
+        /**
+         * @brief Transmit all queued datagrams
+         *
+         * @return uint32_t number of datagrams handed to the kernel
+         */
+        uint32_t flush();
+
+        /**
+         * @brief True if no further datagram can be queued
+         *
+         */
+        bool full() const;
+
+        /**
+         * @brief Number of queued datagrams
+         *
+         */
+        uint32_t pending() const;
+
+        /**
+         * @brief Maximum number of datagrams per sendmmsg call
+         *
+         */
+        uint32_t capacity() const;
+
+        /**
+         * @brief Print number of syscalls, datagrams and send errors
+         *
+         */
+        void print_statistics(std::string name) const;
+
+        private:
+
+        int socket_fd;
+
+        uint32_t batch_size;
+
+        size_t header_size;
+
+        uint32_t queued;
+
+        std::vector<char> slot_buffer;
+
+        std::vector<struct iovec> slot_iovec;
+
+        std::vector<struct sockaddr_storage> slot_destination;
+
+        std::vector<struct mmsghdr> slot_header;
+
+        uint64_t syscall_count;
+
+        uint64_t datagram_count;
+
+        uint64_t error_count;
+    };
+
+};
+
+#endif
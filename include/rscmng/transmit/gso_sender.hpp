@@ -0,0 +1,201 @@
+// Copyright (C) 2025 IDA
+//
+// This file is part of a project licensed under the GNU Lesser General Public License v3.0.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+
+#ifndef GSO_SENDER_h
+#define GSO_SENDER_h
+
+
+#include <map>
+#include <vector>
+#include <string>
+#include <cstring>
+#include <cstdint>
+
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <netinet/in.h>
+
+#include <boost/asio.hpp>
+
+#include <rscmng/utils/log.hpp>
+
+
+using boost::asio::ip::udp;
+
+
+#ifndef SOL_UDP
+#define SOL_UDP 17
+#endif
+
+#ifndef UDP_SEGMENT
+#define UDP_SEGMENT 103
+#endif
+
+
+namespace traffic_generator
+{
+
+    /**
+     * @brief Queues consecutive fragments of an object as equally sized segments (header copy + payload reference)
+     * and submits them with a single sendmsg carrying a UDP_SEGMENT control message. The kernel splits the
+     * concatenated iovecs into datagrams. All segments but the last one must have the full segment size.
+     * The segment size of a destination is limited by its route MTU, the kernel rejects larger segments.
+     * Without GSO support the same iovecs are sent with sendmmsg.
+     *
+     */
+    class GsoSender
+    {
+        public:
+
+        /**
+         * @brief Maximum number of segments the kernel accepts per call
+         *
+         */
+        static const uint32_t GSO_MAX_SEGMENTS = 64;
+
+        /**
+         * @brief Maximum UDP payload per call
+         *
+         */
+        static const size_t GSO_MAX_BYTES = 65507;
+
+        /**
+         * @brief IPv4 and UDP header of a segment
+         *
+         */
+        static const size_t UDP_IPV4_OVERHEAD = 28;
+
+        /**
+         * @brief Construct a new Gso Sender object, probes the socket for UDP_SEGMENT support
+         *
+         * @param socket_fd native handle of a bound UDP socket
+         * @param segment_size maximum length of a full fragment (header + payload)
+         * @param header_size maximum header length of a fragment
+         */
+        GsoSender(int socket_fd, size_t segment_size, size_t header_size);
+
+        /**
+         * @brief Segment size towards a destination, the configured size limited by the route MTU minus
+         * UDP_IPV4_OVERHEAD. The MTU is queried once per destination on a connected probe socket.
+         *
+         */
+        size_t segment_size_for(const udp::endpoint& destination);
+
+        /**
+         * @brief Queue a segment, the header is copied, the payload is referenced
+         *
+         * @param header serialized header
+         * @param header_length header length
+         * @param payload payload, must stay valid until flush
+         * @param payload_length payload length, at most segment_size_for(destination) minus header length,
+         * a short segment closes the buffer
+         * @param destination target endpoint of all queued segments
+         */
+        void queue(const char* header, size_t header_length, const char* payload, size_t payload_length, const udp::endpoint& destination);
+
+        /**
+         * @brief Transmit all queued segments
+         *
+         * @return uint32_t number of datagrams handed to the kernel
+         */
+        uint32_t flush();
+
+        /**
+         * @brief True if the buffer can not take a further segment
+         *
+         */
+        bool full() const;
+
+        /**
+         * @brief Number of queued segments
+         *
+         */
+        uint32_t pending() const;
+
+        /**
+         * @brief Destination of the queued segments
+         *
+         */
+        const udp::endpoint& destination() const;
+
+        /**
+         * @brief True if segmentation offload is used
+         *
+         */
+        bool offload_active() const;
+
+        /**
+         * @brief Print number of syscalls, datagrams and fallbacks
+         *
+         */
+        void print_statistics(std::string name) const;
+
+        private:
+
+        /**
+         * @brief Send the queued segments with one sendmsg and UDP_SEGMENT
+         *
+         */
+        int send_offload();
+
+        /**
+         * @brief Send the queued segments as individual datagrams with sendmmsg
+         *
+         */
+        uint32_t send_fallback();
+
+        int socket_fd;
+
+        size_t segment_size;
+
+        size_t header_size;
+
+        uint32_t max_segments;
+
+        // segment size of the queued segments
+        size_t queued_segment_size;
+
+        // destination <segment size>
+        std::map<udp::endpoint, size_t> route_segment_size;
+
+        bool gso_available;
+
+        bool short_segment_queued;
+
+        uint32_t queued;
+
+        size_t queued_bytes;
+
+        udp::endpoint queued_destination;
+
+        std::vector<char> header_buffer;
+
+        std::vector<struct iovec> segment_iovec;
+
+        std::vector<struct mmsghdr> fallback_header;
+
+        uint64_t syscall_count;
+
+        uint64_t datagram_count;
+
+        uint64_t fallback_count;
+    };
+
+};
+
+#endif
@@ -0,0 +1,239 @@
+// Copyright (C) 2025 IDA
+//
+// This file is part of a project licensed under the GNU Lesser General Public License v3.0.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+
+#ifndef PACKET_RING_SENDER_h
+#define PACKET_RING_SENDER_h
+
+
+#include <map>
+#include <array>
+#include <chrono>
+#include <string>
+#include <cstring>
+#include <cstdint>
+
+#include <boost/asio.hpp>
+
+#include <rscmng/utils/log.hpp>
+
+
+using boost::asio::ip::udp;
+
+
+namespace traffic_generator
+{
+
+    /**
+     * @brief Writes complete Ethernet/IPv4/UDP frames around the fragment header and payload into an
+     * AF_PACKET PACKET_TX_RING (TPACKET_V2) of the interface owning the local address and kicks the
+     * kernel once per batch. Datagrams larger than the interface MTU are split into IPv4 fragments.
+     * Needs CAP_NET_RAW, valid() is false if the ring could not be set up.
+     *
+     */
+    class PacketRingSender
+    {
+        public:
+
+        /**
+         * @brief Construct a new Packet Ring Sender object
+         *
+         * @param source local endpoint, selects the interface and fills source address and port
+         * @param batch_size frames per kick
+         * @param max_datagram_size largest UDP payload (header + fragment payload)
+         */
+        PacketRingSender(const udp::endpoint& source, uint32_t batch_size, size_t max_datagram_size);
+
+        /**
+         * @brief Destroy the Packet Ring Sender object, unmaps the ring
+         *
+         */
+        ~PacketRingSender();
+
+        PacketRingSender(const PacketRingSender&) = delete;
+
+        PacketRingSender& operator=(const PacketRingSender&) = delete;
+
+        /**
+         * @brief True if the ring is mapped and bound
+         *
+         */
+        bool valid() const;
+
+        /**
+         * @brief Resolve the next hop of a destination before sending, probes the neighbour and waits
+         * up to a second for the entry. Called when the transmission plans are compiled.
+         *
+         * @return true if frames to the destination can be addressed
+         */
+        bool resolve(const boost::asio::ip::address_v4& destination);
+
+        /**
+         * @brief Build the frame(s) of a datagram in the ring, header and payload are copied. Datagrams to an
+         * unresolved next hop are dropped and counted, never sent to broadcast.
+         *
+         * @param header serialized header
+         * @param header_length header length
+         * @param payload payload
+         * @param payload_length payload length
+         * @param destination target endpoint
+         * @return uint32_t number of earlier datagrams transmitted by a kick of the full ring
+         */
+        uint32_t queue(const char* header, size_t header_length, const char* payload, size_t payload_length, const udp::endpoint& destination);
+
+        /**
+         * @brief Hand all queued frames to the kernel
+         *
+         * @return uint32_t number of datagrams transmitted
+         */
+        uint32_t flush();
+
+        /**
+         * @brief True if a batch is complete
+         *
+         */
+        bool full() const;
+
+        /**
+         * @brief Number of queued datagrams
+         *
+         */
+        uint32_t pending() const;
+
+        /**
+         * @brief Name of the interface the ring is bound to
+         *
+         */
+        const std::string& interface() const;
+
+        /**
+         * @brief Print number of kicks, frames, fragmented datagrams, errors and datagrams to unresolved next hops
+         *
+         */
+        void print_statistics(std::string name) const;
+
+        private:
+
+        /**
+         * @brief Find interface, its index, MAC address and MTU of the local address
+         *
+         */
+        bool resolve_interface(const boost::asio::ip::address_v4& address);
+
+        /**
+         * @brief MAC address of the next hop of a destination (neighbour table or gateway). An unresolved
+         * next hop is probed and looked up again after the retry interval, nullptr until then.
+         *
+         */
+        const uint8_t* next_hop_mac(const boost::asio::ip::address_v4& destination);
+
+        /**
+         * @brief Trigger address resolution of a next hop with an empty datagram from a connected UDP socket
+         *
+         */
+        void probe_neighbour(uint32_t address) const;
+
+        /**
+         * @brief Look up a complete entry of the neighbour table
+         *
+         */
+        bool neighbour_mac(uint32_t address, uint8_t* mac) const;
+
+        /**
+         * @brief Default gateway of the interface from the routing table in network byte order, 0 if none or not on-link
+         *
+         */
+        uint32_t interface_gateway() const;
+
+        /**
+         * @brief Reserve the next frames of the ring for one datagram, kicks the kernel if the ring is full.
+         * False if they are still in use, then no frame of the datagram is written.
+         *
+         * @param frame_number frames of the datagram
+         * @param datagrams_sent incremented by the datagrams transmitted by the kick
+         */
+        bool claim_frames(uint32_t frame_number, uint32_t& datagrams_sent);
+
+        /**
+         * @brief Next reserved frame
+         *
+         */
+        char* claimed_frame() const;
+
+        /**
+         * @brief Mark the claimed frame for transmission
+         *
+         */
+        void commit_frame(char* frame, size_t frame_length);
+
+        int packet_socket;
+
+        char* ring;
+
+        size_t ring_size;
+
+        size_t frame_size;
+
+        uint32_t frame_count;
+
+        uint32_t frame_index;
+
+        uint32_t batch_size;
+
+        uint32_t queued;
+
+        uint32_t queued_frames;
+
+        std::string interface_name;
+
+        int interface_index;
+
+        bool interface_loopback;
+
+        uint32_t interface_mtu;
+
+        uint32_t interface_address;
+
+        uint32_t interface_netmask;
+
+        uint8_t source_mac[6];
+
+        uint16_t source_port;
+
+        uint16_t ip_identification;
+
+        std::map<uint32_t, std::array<uint8_t, 6>> next_hop_cache;
+
+        // destination <next lookup of the unresolved next hop>
+        std::map<uint32_t, std::chrono::steady_clock::time_point> next_hop_retry;
+
+        uint64_t kick_count;
+
+        uint64_t frame_sent_count;
+
+        uint64_t datagram_count;
+
+        uint64_t fragmented_count;
+
+        uint64_t error_count;
+
+        uint64_t unresolved_count;
+    };
+
+};
+
+#endif
@@ -0,0 +1,142 @@
+// Copyright (C) 2025 IDA
+//
+// This file is part of a project licensed under the GNU Lesser General Public License v3.0.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+
+#ifndef PAYLOAD_SOURCE_h
+#define PAYLOAD_SOURCE_h
+
+
+#include <vector>
+#include <string>
+#include <cstring>
+#include <cstdint>
+
+#include <rscmng/utils/log.hpp>
+
+
+namespace traffic_generator
+{
+
+    /**
+     * @brief Payload of one object, fragment i starts at data + i * fragment_stride
+     *
+     */
+    struct payload_object
+    {
+        const char* data;
+        uint64_t size;
+        size_t fragment_stride;
+        uint32_t fragment_count;
+    };
+
+    /**
+     * @brief Replays recorded objects (e.g. camera or lidar frames) from memory mapped files.
+     * A regular file is one object, a directory holds one object per file in lexical order.
+     * Objects are handed out round robin and fragmented directly from the read only mapping,
+     * the mappings stay valid for the lifetime of the source so no payload is ever copied.
+     *
+     */
+    class PayloadSource
+    {
+        public:
+
+        /**
+         * @brief Construct a new Payload Source object and map all frames
+         *
+         * @param source_path file or directory of frame files
+         * @param fragment_payload_size payload bytes per fragment
+         */
+        PayloadSource(std::string source_path, size_t fragment_payload_size);
+
+        /**
+         * @brief Destroy the Payload Source object, unmaps all frames
+         *
+         */
+        ~PayloadSource();
+
+        PayloadSource(const PayloadSource&) = delete;
+
+        PayloadSource& operator=(const PayloadSource&) = delete;
+
+        /**
+         * @brief True if at least one non empty frame is mapped
+         *
+         */
+        bool valid() const;
+
+        /**
+         * @brief Number of mapped frames
+         *
+         */
+        uint32_t object_count() const;
+
+        /**
+         * @brief Size of the largest frame in bytes
+         *
+         */
+        uint64_t largest_object() const;
+
+        /**
+         * @brief File or directory the frames are mapped from
+         *
+         */
+        const std::string& path() const;
+
+        /**
+         * @brief Next frame, wraps around after the last one
+         *
+         */
+        struct payload_object next_object();
+
+        /**
+         * @brief Number of fragments of an object of the given size, at least one
+         *
+         */
+        uint32_t fragment_count(uint64_t object_size) const;
+
+        private:
+
+        /**
+         * @brief Mapping of one frame file
+         *
+         */
+        struct mapped_frame
+        {
+            void* address;
+            size_t length;
+        };
+
+        /**
+         * @brief Map one file read only, empty files are skipped
+         *
+         */
+        bool map_file(const std::string& file_path);
+
+        std::string source_path;
+
+        size_t fragment_payload_size;
+
+        std::vector<struct mapped_frame> frames;
+
+        uint32_t next_frame;
+
+        uint64_t largest_frame;
+    };
+
+};
+
+#endif
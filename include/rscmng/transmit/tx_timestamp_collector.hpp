@@ -0,0 +1,164 @@
+// Copyright (C) 2025 IDA
+//
+// This file is part of a project licensed under the GNU Lesser General Public License v3.0.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+
+#ifndef TX_TIMESTAMP_COLLECTOR_h
+#define TX_TIMESTAMP_COLLECTOR_h
+
+
+#include <vector>
+#include <string>
+#include <cstring>
+#include <cstdint>
+#include <functional>
+#include <algorithm>
+
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <linux/net_tstamp.h>
+#include <linux/errqueue.h>
+
+#include <rscmng/utils/log.hpp>
+#include <rscmng/utils/histogram.hpp>
+#include <rscmng/utils/pacing_engine.hpp>
+#include <rscmng/attributes/demonstrator_config.hpp>
+
+
+namespace traffic_generator
+{
+
+    /**
+     * @brief Fragment waiting for its TX completion
+     *
+     */
+    struct pending_fragment
+    {
+        uint32_t timestamp_key;
+        rscmng::serviceID_t service_id;
+        uint32_t object_number;
+        uint32_t fragment_number;
+        struct timespec send_time;
+        bool valid;
+    };
+
+    /**
+     * @brief Enables SO_TIMESTAMPING software TX timestamps with OPT_ID on a UDP socket. Every datagram is
+     * registered in send order, the kernel numbers its completions in the same order, so a completion from the
+     * error queue is matched back to (service, object, fragment). The delay between the header timestamp
+     * (taken before the send call) and the kernel TX timestamp is the host stack delay of the fragment.
+     * The collector owns the error queue, reports of other origins (e.g. SO_EE_ORIGIN_TXTIME) are forwarded.
+     *
+     */
+    class TxTimestampCollector
+    {
+        public:
+
+        /**
+         * @brief Construct a new Tx Timestamp Collector object and enable timestamping on the socket
+         *
+         * @param socket_fd native handle of a UDP socket
+         * @param capacity maximum number of fragments in flight
+         */
+        TxTimestampCollector(int socket_fd, uint32_t capacity = 4096);
+
+        /**
+         * @brief True if the socket reports TX timestamps
+         *
+         */
+        bool active() const;
+
+        /**
+         * @brief Register the next datagram handed to the kernel
+         *
+         */
+        void register_fragment(rscmng::serviceID_t service_id, uint32_t object_number, uint32_t fragment_number, const struct timespec& send_time);
+
+        /**
+         * @brief Read all completions from the error queue
+         *
+         * @return uint32_t number of matched completions
+         */
+        uint32_t drain();
+
+        /**
+         * @brief Drain once drain_interval fragments were registered since the last drain, called from the
+         * fragment loop so the error queue and the pending ring do not fill up during a large object
+         *
+         * @return uint32_t number of matched completions
+         */
+        uint32_t poll();
+
+        /**
+         * @brief Handler for error queue reports that are not TX timestamps
+         *
+         */
+        void set_foreign_error_handler(std::function<void(const struct sock_extended_err&)> handler);
+
+        /**
+         * @brief Send delay histogram (kernel TX timestamp - header timestamp)
+         *
+         */
+        const rscmng::LogLinearHistogram& send_delay() const;
+
+        /**
+         * @brief Print send delay and matching statistics
+         *
+         */
+        void print_statistics(std::string name);
+
+        /**
+         * @brief Log (service, object, fragment) and send delay of every completion
+         *
+         */
+        bool log_each_completion = false;
+
+        private:
+
+        /**
+         * @brief Match one completion to its fragment, false if the fragment is unknown
+         *
+         */
+        bool complete(uint32_t timestamp_key, const struct timespec& kernel_time);
+
+        int socket_fd;
+
+        bool timestamping_enabled;
+
+        uint32_t next_key;
+
+        std::vector<struct pending_fragment> pending;
+
+        uint32_t drain_interval;
+
+        uint32_t registered_since_drain;
+
+        std::function<void(const struct sock_extended_err&)> foreign_error_handler;
+
+        rscmng::LogLinearHistogram send_delay_histogram;
+
+        uint64_t registered_count;
+
+        uint64_t matched_count;
+
+        uint64_t unmatched_count;
+
+        uint64_t overflow_count;
+    };
+
+};
+
+#endif
@@ -0,0 +1,173 @@
+// Copyright (C) 2025 IDA
+//
+// This file is part of a project licensed under the GNU Lesser General Public License v3.0.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+
+#ifndef TXTIME_SENDER_h
+#define TXTIME_SENDER_h
+
+
+#include <string>
+#include <cstring>
+#include <cstdint>
+#include <chrono>
+
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <netinet/in.h>
+#include <linux/net_tstamp.h>
+#include <linux/errqueue.h>
+
+#include <boost/asio.hpp>
+
+#include <rscmng/utils/log.hpp>
+#include <rscmng/utils/histogram.hpp>
+#include <rscmng/utils/pacing_engine.hpp>
+
+
+using boost::asio::ip::udp;
+
+
+#ifndef SO_TXTIME
+#define SO_TXTIME 61
+#define SCM_TXTIME SO_TXTIME
+#endif
+
+
+namespace traffic_generator
+{
+
+    /**
+     * @brief Attaches a SCM_TXTIME launch time (CLOCK_TAI) to every datagram, so an ETF qdisc releases it on time
+     * while the sending thread works up to lead_time ahead. Launch times are passed in CLOCK_REALTIME, the domain
+     * of the RM hyperperiod timestamps, and converted with the current TAI offset.
+     * If SO_TXTIME is not available, no ETF qdisc is configured on the egress interface (without it the kernel
+     * ignores launch times and sends at once) or log_only is set, the sender paces in user space up to the launch
+     * time and records the difference between intended launch time and actual send time.
+     *
+     */
+    class TxTimeSender
+    {
+        public:
+
+        /**
+         * @brief Construct a new TxTime Sender object and enable SO_TXTIME on the socket
+         *
+         * @param socket_fd native handle of a bound UDP socket
+         * @param log_only do not use SO_TXTIME, only log launch time versus send time
+         * @param lead_time maximum time a datagram is handed to the kernel before its launch time
+         * @param strategy wait strategy used for the lead time and the fallback
+         * @param spin_margin busy wait margin of the wait strategy
+         */
+        TxTimeSender(
+            int socket_fd,
+            bool log_only,
+            std::chrono::microseconds lead_time,
+            rscmng::PacingStrategy strategy,
+            std::chrono::microseconds spin_margin
+        );
+
+        /**
+         * @brief Transmit one datagram at its launch time
+         *
+         * @param datagram_iovec datagram as scatter-gather list (header, payload)
+         * @param iovec_count number of iovecs
+         * @param destination target endpoint
+         * @param launch_time intended launch time (CLOCK_REALTIME)
+         * @return uint32_t number of datagrams handed to the kernel
+         */
+        uint32_t send(const struct iovec* datagram_iovec, size_t iovec_count, const udp::endpoint& destination, const struct timespec& launch_time);
+
+        /**
+         * @brief Read ETF drop reports (SO_EE_ORIGIN_TXTIME) from the socket error queue
+         *
+         */
+        void drain_error_queue();
+
+        /**
+         * @brief Count one error queue report, used if another reader owns the error queue
+         *
+         */
+        void handle_error(const struct sock_extended_err& extended_error);
+
+        /**
+         * @brief Stop reading the error queue, reports are passed in through handle_error
+         *
+         */
+        void set_external_error_queue(bool external);
+
+        /**
+         * @brief True if launch times are handed to the kernel
+         *
+         */
+        bool txtime_active() const;
+
+        /**
+         * @brief Print launch time statistics
+         *
+         */
+        void print_statistics(std::string name);
+
+        /**
+         * @brief Log intended launch time and actual send time of every datagram
+         *
+         */
+        bool log_each_datagram = false;
+
+        private:
+
+        /**
+         * @brief Interface of the local address the socket is bound to
+         *
+         * @return int interface index, 0 if the socket is not bound to the address of one interface
+         */
+        static int egress_interface(int socket_fd, std::string& interface_name);
+
+        /**
+         * @brief Dump the qdiscs of an interface over rtnetlink and look for an ETF qdisc (root or child)
+         *
+         * @return int 1 if present, 0 if not, -1 if the qdiscs could not be read
+         */
+        static int etf_qdisc_present(int interface_index);
+
+        int socket_fd;
+
+        bool txtime_enabled;
+
+        bool external_error_queue;
+
+        int64_t lead_time_ns;
+
+        int64_t tai_offset_ns;
+
+        rscmng::PacingEngine launch_pacing;
+
+        rscmng::LogLinearHistogram send_offset_histogram;
+
+        uint64_t datagram_count;
+
+        uint64_t clamped_count;
+
+        uint64_t missed_count;
+
+        uint64_t invalid_count;
+
+        uint64_t error_count;
+    };
+
+};
+
+#endif
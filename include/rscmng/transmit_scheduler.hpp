@@ -0,0 +1,266 @@
+// Copyright (C) 2025 IDA
+//
+// This file is part of a project licensed under the GNU Lesser General Public License v3.0.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+
+#ifndef TRANSMIT_SCHEDULER_h
+#define TRANSMIT_SCHEDULER_h
+
+
+#include <vector>
+#include <map>
+#include <queue>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <memory>
+#include <chrono>
+#include <ctime>
+
+#include <boost/asio.hpp>
+
+#include <rscmng/utils/log.hpp>
+#include <rscmng/utils/config_reader.hpp>
+#include <rscmng/utils/pacing_engine.hpp>
+#include <rscmng/utils/hyperperiod_timeline.hpp>
+#include <rscmng/utils/realtime_profile.hpp>
+#include <rscmng/attributes/demonstrator_config.hpp>
+#include <rscmng/messages.hpp>
+#include <rscmng/generator_control.hpp>
+#include <rscmng/traffic_generator.hpp>
+
+
+using boost::asio::ip::udp;
+
+
+namespace traffic_generator
+{
+
+    /**
+     * @brief Next fragment of a service in the scheduler queue
+     *
+     */
+    struct scheduled_fragment
+    {
+        struct timespec due;
+        struct timespec object_deadline;
+        uint32_t service_index;
+        uint64_t generation;
+    };
+
+    /**
+     * @brief Orders the queue by due time, ties by the earlier object deadline
+     *
+     */
+    struct scheduled_fragment_later
+    {
+        bool operator()(const scheduled_fragment& a, const scheduled_fragment& b) const;
+    };
+
+    /**
+     * @brief Per service state of the scheduler, runtime fields are only touched by the owning worker
+     *
+     */
+    struct scheduled_service
+    {
+        std::map<uint32_t, struct rscmng::config::service_settings> service_settings;
+        std::map<uint32_t, struct transmission_plan> transmission_plans;
+        std::unique_ptr<GeneratorControl> control;
+        uint32_t worker_index;
+        rscmng::HyperperiodTimeline timeline;
+        struct transmission_state state;
+
+        bool active = false;
+        uint64_t generation = 0;
+        // release of the running object on the timeline clock
+        int64_t object_release_ns = 0;
+
+        uint64_t fragments_sent = 0;
+        uint64_t objects_sent = 0;
+        uint64_t deadline_misses = 0;
+    };
+
+    /**
+     * @brief Transmits the objects of many services from one thread (or a small fixed pool). Every worker owns
+     * a transmit path and keeps a priority queue of the next due fragment per service. The modes of a service
+     * are compiled into transmission plans like for a TrafficGenerator, objects follow the traffic schedule of
+     * the current plan delayed by slot_offset, fragments follow every inter_packet_gap. Due times are on the
+     * TIMELINE_CLOCK, equal due times are served earliest object deadline first.
+     * Each service is controlled like a TrafficGenerator through its own GeneratorControl.
+     *
+     */
+    class TransmitScheduler
+    {
+        public:
+
+        /**
+         * @brief Construct a new Transmit Scheduler object
+         *
+         * @param client_configuration local unit, the socket binds to the first RM control ip
+         * @param experiment_parameter synchronous_start_mode applies mode changes at object boundaries only
+         * @param worker_count number of transmit threads, services are distributed round robin
+         * @param traffic_pattern wait strategy, transmit backend (SOCKET or TXTIME), timestamping and wire format
+         * @throws std::invalid_argument for a batching transmit backend, fragments are never held back
+         */
+        TransmitScheduler(
+            struct rscmng::config::unit_settings client_configuration,
+            struct rscmng::config::experiment_parameter experiment_parameter,
+            uint32_t worker_count,
+            traffic_generator_parameter traffic_pattern
+        );
+
+        /**
+         * @brief Destroy the Transmit Scheduler object, stops the workers
+         *
+         */
+        ~TransmitScheduler();
+
+        /**
+         * @brief Register a service with its modes and compile their plans, only before start()
+         *
+         * @return uint32_t service index used for notifications
+         */
+        uint32_t add_service(std::map<uint32_t, struct rscmng::config::service_settings> service_settings);
+
+        /**
+         * @brief Start the worker threads
+         *
+         */
+        void start();
+
+        /**
+         * @brief Stop and join the worker threads
+         *
+         */
+        void stop();
+
+        /**
+         * @brief Notify a new state for one service
+         *
+         */
+        void notify_service(uint32_t service_index, TrafficSourceControl state);
+
+        /**
+         * @brief Notify a new state and mode for one service
+         *
+         */
+        void notify_service_mode_change(uint32_t service_index, TrafficSourceControl state, uint32_t mode);
+
+        /**
+         * @brief Notify a new state, mode and period start for one service
+         *
+         */
+        void notify_service_timestamp(uint32_t service_index, TrafficSourceControl state, struct timespec timestamp, uint32_t mode, bool update_period);
+
+        /**
+         * @brief Number of registered services
+         *
+         */
+        uint32_t service_count() const;
+
+        /**
+         * @brief Print per service and per worker statistics
+         *
+         */
+        void print_statistics();
+
+        private:
+
+        /**
+         * @brief Transmit thread state
+         *
+         */
+        struct scheduler_worker
+        {
+            std::thread worker_thread;
+            std::atomic<uint64_t> notify_sequence;
+            std::mutex wakeup_mutex;
+            std::condition_variable wakeup_condition;
+            TransmitPath transmit_path;
+            rscmng::PacingEngine pacing;
+
+            scheduler_worker(const udp::endpoint& local_endpoint, const traffic_generator_parameter& traffic_pattern, clockid_t clock, uint32_t worker_index);
+        };
+
+        typedef std::priority_queue<scheduled_fragment, std::vector<scheduled_fragment>, scheduled_fragment_later> fragment_queue;
+
+        /**
+         * @brief Main loop of a worker
+         *
+         */
+        void run_worker(uint32_t worker_index);
+
+        /**
+         * @brief Wake the worker owning the service after a notification
+         *
+         */
+        void wake_worker(uint32_t service_index);
+
+        /**
+         * @brief Apply a published state to an idle or running service
+         *
+         */
+        void refresh_service(scheduled_service& service, uint32_t service_index, fragment_queue& queue);
+
+        /**
+         * @brief Send the next fragment of a service and queue the following one
+         *
+         */
+        void dispatch(scheduled_service& service, uint32_t service_index, fragment_queue& queue);
+
+        /**
+         * @brief Switch a service to the plan of the published mode and re-anchor its timeline on a new period
+         *
+         * @return false for an unknown mode
+         */
+        bool apply_control(scheduled_service& service, const control_snapshot& control);
+
+        /**
+         * @brief Release the next object of the traffic schedule and queue its first fragment
+         *
+         */
+        void start_object(scheduled_service& service, uint32_t service_index, fragment_queue& queue);
+
+        /**
+         * @brief Queue the next fragment of the current object
+         *
+         */
+        void queue_fragment(scheduled_service& service, uint32_t service_index, fragment_queue& queue);
+
+        struct rscmng::config::unit_settings client_configuration_struct;
+
+        struct rscmng::config::experiment_parameter experiment_parameter_struct;
+
+        traffic_generator_parameter traffic_pattern;
+
+        rscmng::TimelineClock timeline_clock;
+
+        std::vector<std::unique_ptr<scheduled_service>> services;
+
+        std::vector<std::unique_ptr<scheduler_worker>> workers;
+
+        std::atomic<bool> stop_thread;
+
+        bool started;
+
+        std::vector<char> dummy_payload;
+    };
+
+};
+
+#endif
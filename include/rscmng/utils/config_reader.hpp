@@ -56,6 +56,30 @@ namespace rscmng{
         #define SERVICE_LOCAL_IP "SERVICE_LOCAL_IP"
         #define SERVICE_LOCAL_PORT "SERVICE_LOCAL_PORT"
         #define CLIENT_PRIORITY "CLIENT_PRIORITY"
+        #define PACING_SPIN_MARGIN "PACING_SPIN_MARGIN[us]"
+        #define TRANSMIT_BACKEND "TRANSMIT_BACKEND"
+        #define TRANSMIT_BATCH_SIZE "TRANSMIT_BATCH_SIZE"
+        #define TRANSMIT_SCHEDULER "TRANSMIT_SCHEDULER"
+        #define TXTIME_LEAD "TXTIME_LEAD[us]"
+        #define TXTIME_LOG_ONLY "TXTIME_LOG_ONLY"
+        #define TX_TIMESTAMPING "TX_TIMESTAMPING"
+        #define DATA_MESSAGE_VERSION "DATA_MESSAGE_VERSION"
+        #define RECEIVE_BACKEND "RECEIVE_BACKEND"
+        #define RECEIVE_BATCH_SIZE "RECEIVE_BATCH_SIZE"
+        #define RECEIVE_GRO "RECEIVE_GRO"
+        #define RECEIVE_TIMESTAMPING "RECEIVE_TIMESTAMPING"
+        #define RECEIVE_EVENT_LOOP "RECEIVE_EVENT_LOOP"
+        #define RECEIVE_EVENT_THREADS "RECEIVE_EVENT_THREADS"
+        #define RECEIVE_SHARDS "RECEIVE_SHARDS"
+        #define RECEIVE_SHARD_STEERING "RECEIVE_SHARD_STEERING"
+        #define RECEIVE_KERNEL_POLL_INTERVAL "RECEIVE_KERNEL_POLL_INTERVAL[ms]"
+        #define REALTIME_PROFILE "REALTIME_PROFILE"
+        #define REALTIME_LOCK_MEMORY "LOCK_MEMORY"
+        #define REALTIME_PREFAULT_STACK "PREFAULT_STACK[KByte]"
+        #define REALTIME_PREFAULT_HEAP "PREFAULT_HEAP[KByte]"
+        #define REALTIME_THREADS "THREADS"
+        #define REALTIME_THREAD_CPUS "CPUS"
+        #define REALTIME_THREAD_PRIORITY "PRIORITY"
         
 
         #define SERVICE_SETTINGS "SERVICE_SETTINGS"
@@ -71,6 +95,19 @@ namespace rscmng{
         #define SLOT_LENGTH "SLOT_LENGTH [ms]"
         #define INTER_PACKET_GAP "INTER_PACKET_GAP[us]"
         #define INTER_OBJECT_GAP "INTER_OBJECT_GAP[us]"
+        #define PAYLOAD_SOURCE "PAYLOAD_SOURCE"
+        #define TRAFFIC_MODEL "TRAFFIC_MODEL"
+        #define TRAFFIC_MODEL_TYPE "TYPE"
+        #define TRAFFIC_MODEL_RATE "RATE[1/s]"
+        #define TRAFFIC_MODEL_ON "ON[ms]"
+        #define TRAFFIC_MODEL_OFF "OFF[ms]"
+        #define TRAFFIC_MODEL_SIZE_DISTRIBUTION "SIZE_DISTRIBUTION"
+        #define TRAFFIC_MODEL_SIZE_MIN "SIZE_MIN [KByte]"
+        #define TRAFFIC_MODEL_SIZE_MAX "SIZE_MAX [KByte]"
+        #define TRAFFIC_MODEL_SIZE_STDDEV "SIZE_STDDEV [KByte]"
+        #define TRAFFIC_MODEL_TRACE "TRACE"
+        #define TRAFFIC_MODEL_PERIODS "SCHEDULE_PERIODS"
+        #define TRAFFIC_MODEL_SEED "SEED"
 
         #define EXPERIMENT_SETTINGS "EXPERIMENT_SETTINGS"
         #define EXPERIMENT_NUMBER "EXPERIMENT_NUMBER"
@@ -88,12 +125,28 @@ namespace rscmng{
         #define INTER_MC_GAP_MAX "INTER_MC_GAP_MAX[ms]"
         #define HYPERPERIOD_DURATION "HYPERPERIOD_DURATION[ms]"
         #define HYPERPERIOD_SLOTS "HYPERPERIOD_SLOTS"
+        #define TIMELINE_CLOCK "TIMELINE_CLOCK"
         #define EXPERIMENT_STARTUP_MODE "EXPERIMENT_STARTUP_MODE"
         #define EXPERIMENT_STARTUP_MODE_MAP "EXPERIMENT_STARTUP_MODE_MAP"
         #define EXPERIMENT_RECONFIGURATION_ORDER "EXPERIMENT_RECONFIGURATION_ORDER"
         #define EXPERIMENT_RECONFIGURATION_MAP "EXPERIMENT_RECONFIGURATION_MAP"
 
 
+        struct traffic_model_settings
+        {
+            std::string type = "PERIODIC";
+            double rate_per_second = 0;
+            uint32_t on_ms = 0;
+            uint32_t off_ms = 0;
+            std::string size_distribution = "CONSTANT";
+            double size_min_kb = 0;
+            double size_max_kb = 0;
+            double size_stddev_kb = 0;
+            std::string trace_path;
+            uint32_t schedule_periods = 64;
+            uint32_t seed = 1;
+        };
+
         struct service_settings 
         {
             serviceID_t service_id;
@@ -108,11 +161,29 @@ namespace rscmng{
             uint32_t slot_length;
             std::chrono::microseconds inter_packet_gap;
             std::chrono::microseconds inter_object_gap;
+            std::string payload_source;
+            struct traffic_model_settings traffic_model;
             //calculated values
             uint32_t number_packets;
             double estimated_transmission_time_ms;
         };
 
+        struct realtime_thread_settings
+        {
+            std::vector<uint32_t> cpus;
+            // SCHED_FIFO priority, 0 keeps SCHED_OTHER
+            int priority = 0;
+        };
+
+        struct realtime_profile_settings
+        {
+            bool lock_memory = false;
+            uint32_t prefault_stack_kb = 0;
+            uint32_t prefault_heap_kb = 0;
+            // thread name <settings>
+            std::map<std::string, struct realtime_thread_settings> threads;
+        };
+
         struct unit_settings 
         {
             std::string host_name;
@@ -125,6 +196,27 @@ namespace rscmng{
             std::vector<std::string> service_local_ip;
             std::vector<uint32_t> service_local_port;
             uint32_t client_priority;
+            std::chrono::microseconds pacing_spin_margin;
+            std::string transmit_backend;
+            uint32_t transmit_batch_size;
+            // worker threads of a shared transmit scheduler (SOCKET or TXTIME backend), 0 runs one traffic generator thread per service
+            uint32_t transmit_scheduler;
+            std::chrono::microseconds txtime_lead;
+            bool txtime_log_only;
+            bool tx_timestamping;
+            // wire format of the generated data messages, sinks accept both
+            uint32_t data_message_version;
+            std::string receive_backend;
+            uint32_t receive_batch_size;
+            bool receive_gro;
+            std::string receive_timestamping;
+            bool receive_event_loop;
+            // 0 sizes the pool to the core count
+            uint32_t receive_event_threads;
+            uint32_t receive_shards;
+            bool receive_shard_steering;
+            std::chrono::milliseconds receive_kernel_poll_interval;
+            struct realtime_profile_settings realtime_profile;
         };
 
         struct experiment_parameter
@@ -144,6 +236,7 @@ namespace rscmng{
             std::chrono::milliseconds inter_mc_gap_max;
             std::chrono::milliseconds hyperperiod_duration;
             uint32_t hyperperiod_slots;
+            std::string timeline_clock;
             uint32_t startup_mode;
             std::map<uint32_t,std::map<uint32_t,uint32_t>> startup_mode_map;
             std::list<uint32_t> reconfiguration_order;
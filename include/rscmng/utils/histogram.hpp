@@ -0,0 +1,141 @@
+// Copyright (C) 2025 IDA
+//
+// This file is part of a project licensed under the GNU Lesser General Public License v3.0.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+
+#ifndef HISTOGRAM_h
+#define HISTOGRAM_h
+
+
+#include <atomic>
+#include <array>
+#include <algorithm>
+#include <string>
+#include <cstdint>
+
+#include <rscmng/utils/log.hpp>
+
+
+namespace rscmng {
+
+    /**
+     * @brief Log-linear (HDR style) histogram for nanosecond values.
+     * Every power of two is split into HISTOGRAM_SUB_BUCKETS linear sub buckets,
+     * which bounds the relative error of a recorded value to 1/HISTOGRAM_SUB_BUCKETS.
+     * Buckets are relaxed atomics, so one thread may record while another one reads.
+     *
+     */
+    class LogLinearHistogram
+    {
+        public:
+
+        static const uint32_t HISTOGRAM_SUB_BUCKET_BITS = 4;
+        static const uint32_t HISTOGRAM_SUB_BUCKETS = 1 << HISTOGRAM_SUB_BUCKET_BITS;
+        static const uint32_t HISTOGRAM_BUCKETS = (64 - HISTOGRAM_SUB_BUCKET_BITS + 1) * HISTOGRAM_SUB_BUCKETS;
+
+        /**
+         * @brief Construct a new (empty) histogram
+         *
+         */
+        LogLinearHistogram();
+
+        /**
+         * @brief Record a single value
+         *
+         * @param value value in nanoseconds
+         */
+        void record(uint64_t value);
+
+        /**
+         * @brief Add all values of another histogram
+         *
+         * @param other histogram to be merged into this one
+         */
+        void merge(const LogLinearHistogram& other);
+
+        /**
+         * @brief Clear all buckets
+         *
+         */
+        void reset();
+
+        /**
+         * @brief Number of recorded values
+         *
+         */
+        uint64_t count() const;
+
+        /**
+         * @brief Smallest recorded value, 0 if empty
+         *
+         */
+        uint64_t min() const;
+
+        /**
+         * @brief Largest recorded value, 0 if empty
+         *
+         */
+        uint64_t max() const;
+
+        /**
+         * @brief Arithmetic mean of all recorded values
+         *
+         */
+        double mean() const;
+
+        /**
+         * @brief Value below which the given percentage of the recorded values lies
+         *
+         * @param percentile percentile in the range [0, 100]
+         * @return uint64_t upper bound of the matching bucket
+         */
+        uint64_t percentile(double percentile) const;
+
+        /**
+         * @brief Print count, min, mean, percentiles and max in microseconds
+         *
+         * @param name prefix of the log line
+         */
+        void print(std::string name) const;
+
+        /**
+         * @brief Bucket index of a value
+         *
+         */
+        static uint32_t bucket_index(uint64_t value);
+
+        /**
+         * @brief Largest value mapped to a bucket
+         *
+         */
+        static uint64_t bucket_upper_bound(uint32_t index);
+
+        private:
+
+        std::array<std::atomic<uint64_t>, HISTOGRAM_BUCKETS> buckets;
+
+        std::atomic<uint64_t> total_count;
+
+        std::atomic<uint64_t> total_sum;
+
+        std::atomic<uint64_t> min_value;
+
+        std::atomic<uint64_t> max_value;
+    };
+
+}; // End rscmng namespace
+
+#endif
@@ -0,0 +1,184 @@
+// Copyright (C) 2025 IDA
+//
+// This file is part of a project licensed under the GNU Lesser General Public License v3.0.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+
+#ifndef HYPERPERIOD_TIMELINE_h
+#define HYPERPERIOD_TIMELINE_h
+
+
+#include <ctime>
+#include <cstdint>
+#include <string>
+
+#include <rscmng/utils/log.hpp>
+
+
+#ifndef CLOCK_TAI
+#define CLOCK_TAI 11
+#endif
+
+
+namespace rscmng {
+
+    /**
+     * @brief Clock a timeline runs on
+     *
+     */
+    enum TimelineClock
+    {
+        TIMELINE_MONOTONIC = 0,
+        TIMELINE_TAI,
+        TIMELINE_REALTIME
+    };
+
+    /**
+     * @brief Map the TIMELINE_CLOCK config value (MONOTONIC, TAI, REALTIME) to the clock
+     *
+     */
+    TimelineClock timeline_clock_from_string(std::string clock_name);
+
+    /**
+     * @brief Clock id used for clock_gettime / clock_nanosleep
+     *
+     */
+    clockid_t timeline_clock_id(TimelineClock clock);
+
+    /**
+     * @brief Periodic timeline anchored once on a selectable clock. The start of slot k is
+     * anchor + k * period in integer nanoseconds, so slots neither accumulate rounding errors nor
+     * follow steps of CLOCK_REALTIME (NTP step, leap smear) when running on MONOTONIC or TAI.
+     * Absolute timestamps exchanged with the RM stay CLOCK_REALTIME and are converted at the boundary.
+     *
+     */
+    class HyperperiodTimeline
+    {
+        public:
+
+        /**
+         * @brief Construct a new (unanchored) Hyperperiod Timeline object
+         *
+         * @param clock clock of the timeline
+         * @param period_ns slot length in ns
+         */
+        HyperperiodTimeline(TimelineClock clock = TIMELINE_MONOTONIC, int64_t period_ns = 0);
+
+        /**
+         * @brief Anchor slot 0 at an absolute time on the timeline clock
+         *
+         */
+        void anchor(int64_t anchor_ns, int64_t period_ns);
+
+        /**
+         * @brief Anchor slot 0 at the start of a slot of the current timeline and change the period
+         *
+         */
+        void rebase(uint64_t slot, int64_t period_ns);
+
+        /**
+         * @brief True once an anchor is set
+         *
+         */
+        bool anchored() const;
+
+        /**
+         * @brief Slot length in ns
+         *
+         */
+        int64_t period() const;
+
+        /**
+         * @brief Clock of the timeline
+         *
+         */
+        TimelineClock clock() const;
+
+        /**
+         * @brief Clock id of the timeline
+         *
+         */
+        clockid_t clock_id() const;
+
+        /**
+         * @brief Current time on the timeline clock in ns
+         *
+         */
+        int64_t now() const;
+
+        /**
+         * @brief Start of slot k (anchor + k * period)
+         *
+         */
+        int64_t slot_start(uint64_t slot) const;
+
+        /**
+         * @brief Index of the slot containing a time, 0 before the anchor
+         *
+         */
+        uint64_t slot_index(int64_t time_ns) const;
+
+        /**
+         * @brief Index of the first slot starting at or after a time
+         *
+         */
+        uint64_t next_slot(int64_t time_ns) const;
+
+        /**
+         * @brief Convert an absolute CLOCK_REALTIME timestamp (e.g. supplied by the RM) to the timeline clock
+         *
+         */
+        int64_t from_realtime(const struct timespec& realtime) const;
+
+        /**
+         * @brief Convert a time on the timeline clock to CLOCK_REALTIME
+         *
+         */
+        struct timespec to_realtime(int64_t time_ns) const;
+
+        /**
+         * @brief Nanoseconds of a timespec
+         *
+         */
+        static int64_t to_ns(const struct timespec& timestamp);
+
+        /**
+         * @brief Timespec of nanoseconds
+         *
+         */
+        static struct timespec to_timespec(int64_t time_ns);
+
+        private:
+
+        /**
+         * @brief Offset timeline clock - CLOCK_REALTIME, sampled around a single read of the timeline clock
+         *
+         */
+        int64_t realtime_offset() const;
+
+        TimelineClock timeline_clock;
+
+        clockid_t clock_identifier;
+
+        int64_t anchor_ns;
+
+        int64_t period_ns;
+
+        bool is_anchored;
+    };
+
+};
+
+#endif
@@ -0,0 +1,184 @@
+// Copyright (C) 2025 IDA
+//
+// This file is part of a project licensed under the GNU Lesser General Public License v3.0.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+
+#ifndef PACING_ENGINE_h
+#define PACING_ENGINE_h
+
+
+#include <ctime>
+#include <chrono>
+#include <string>
+#include <functional>
+
+#include <rscmng/utils/log.hpp>
+#include <rscmng/utils/histogram.hpp>
+
+
+namespace rscmng {
+
+    /**
+     * @brief Strategy used to wait for a deadline
+     *
+     */
+    enum PacingStrategy
+    {
+        PACING_BUSY_SPIN = 0,
+        PACING_SLEEP_SPIN,
+        PACING_SLEEP
+    };
+
+    /**
+     * @brief Waits for absolute deadlines on a selectable clock. In PACING_SLEEP_SPIN the thread
+     * sleeps with clock_nanosleep(TIMER_ABSTIME) until spin_margin before the deadline and busy
+     * waits only for the remainder. The lateness of every wakeup is recorded in a histogram.
+     *
+     */
+    class PacingEngine
+    {
+        public:
+
+        /**
+         * @brief Construct a new Pacing Engine object
+         *
+         * @param clock_id clock the deadlines refer to
+         * @param strategy wait strategy
+         * @param spin_margin time before the deadline in which the thread busy waits
+         */
+        PacingEngine(
+            clockid_t clock_id = CLOCK_MONOTONIC,
+            PacingStrategy strategy = PACING_SLEEP_SPIN,
+            std::chrono::microseconds spin_margin = std::chrono::microseconds(50)
+        );
+
+        /**
+         * @brief Wait until an absolute deadline
+         *
+         * @param deadline absolute time on the engine clock
+         * @return int64_t lateness of the wakeup in ns (negative if the deadline was not reached)
+         */
+        int64_t wait_until(const struct timespec& deadline);
+
+        /**
+         * @brief Wait until an absolute deadline, the wait is aborted as soon as interrupted returns true.
+         * Sleeps are split into slices of max_sleep_slice to poll the predicate.
+         *
+         * @param deadline absolute time on the engine clock
+         * @param interrupted predicate polled while waiting
+         * @return int64_t lateness of the wakeup in ns (negative if interrupted before the deadline)
+         */
+        int64_t wait_until(const struct timespec& deadline, const std::function<bool()>& interrupted);
+
+        /**
+         * @brief Wait for a duration relative to now
+         *
+         * @param duration time to wait
+         * @return int64_t lateness of the wakeup in ns
+         */
+        int64_t wait_for(std::chrono::nanoseconds duration);
+
+        /**
+         * @brief Current time of the engine clock
+         *
+         */
+        struct timespec now() const;
+
+        /**
+         * @brief Set the wait strategy
+         *
+         */
+        void set_strategy(PacingStrategy strategy);
+
+        /**
+         * @brief Set the busy wait margin before a deadline
+         *
+         */
+        void set_spin_margin(std::chrono::microseconds spin_margin);
+
+        /**
+         * @brief Histogram of the wakeup lateness
+         *
+         */
+        const LogLinearHistogram& lateness() const;
+
+        /**
+         * @brief Number of waits whose deadline already passed on entry
+         *
+         */
+        uint64_t missed_deadlines() const;
+
+        /**
+         * @brief Print lateness statistics
+         *
+         * @param name prefix of the log line
+         */
+        void print_statistics(std::string name) const;
+
+        /**
+         * @brief Clear lateness statistics
+         *
+         */
+        void reset_statistics();
+
+        /**
+         * @brief Add a nanosecond offset to a timespec
+         *
+         */
+        static struct timespec add_ns(struct timespec timestamp, int64_t nanoseconds);
+
+        /**
+         * @brief Difference a - b in nanoseconds
+         *
+         */
+        static int64_t diff_ns(const struct timespec& a, const struct timespec& b);
+
+        private:
+
+        /**
+         * @brief Sleep with clock_nanosleep(TIMER_ABSTIME), restarted on EINTR
+         *
+         */
+        void sleep_until(const struct timespec& deadline);
+
+        /**
+         * @brief Busy wait until the deadline
+         *
+         */
+        struct timespec spin_until(const struct timespec& deadline);
+
+        /**
+         * @brief Record the lateness of a wakeup
+         *
+         */
+        int64_t record(const struct timespec& deadline, const struct timespec& wakeup);
+
+        clockid_t clock_id;
+
+        PacingStrategy strategy;
+
+        int64_t spin_margin_ns;
+
+        int64_t max_sleep_slice_ns = 1000000;
+
+        uint64_t missed_deadline_count;
+
+        LogLinearHistogram lateness_histogram;
+    };
+
+}; // End rscmng namespace
+
+#endif
@@ -0,0 +1,111 @@
+// Copyright (C) 2025 IDA
+//
+// This file is part of a project licensed under the GNU Lesser General Public License v3.0.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+
+#ifndef REALTIME_PROFILE_h
+#define REALTIME_PROFILE_h
+
+
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+#include <rscmng/utils/log.hpp>
+#include <rscmng/utils/config_reader.hpp>
+
+
+namespace rscmng {
+
+    /**
+     * @brief Names of the threads a realtime profile can address (keys of REALTIME_PROFILE THREADS)
+     *
+     */
+    #define RT_THREAD_GENERATOR "generator"
+    #define RT_THREAD_SINK "sink"
+    #define RT_THREAD_SINK_WRITER "sink_writer"
+    #define RT_THREAD_SINK_SHARD "sink_shard"
+    #define RT_THREAD_RM_RECEIVE "rm_receive"
+    #define RT_THREAD_RM_HANDLER "rm_handler"
+    #define RT_THREAD_TIMER "timer"
+    #define RT_THREAD_TRANSMIT_WORKER "tx_worker"
+
+    /**
+     * @brief Process wide realtime runtime profile of a host (UNIT_SETTINGS REALTIME_PROFILE).
+     * The process locks and prefaults its memory once before the experiment, every thread applies
+     * its CPU set and SCHED_FIFO priority when it starts.
+     *
+     */
+    class RealtimeProfile
+    {
+        public:
+
+        /**
+         * @brief Profile of the process
+         *
+         */
+        static RealtimeProfile& instance();
+
+        /**
+         * @brief Lock and prefault the process memory, to be called before any thread is started
+         *
+         * @param settings realtime profile of the host
+         */
+        void configure(const struct rscmng::config::realtime_profile_settings& settings);
+
+        /**
+         * @brief Name the calling thread, apply its CPU set and priority and prefault its stack
+         *
+         * @param thread_name thread name, also key of the thread settings
+         * @param cpu_index pin to the single CPU at this index (modulo) of the configured CPU set, -1 for the whole set
+         * @return true if every configured setting was applied
+         */
+        bool apply(const std::string& thread_name, int32_t cpu_index = -1) const;
+
+        /**
+         * @brief Touch every page of a buffer so it is resident before use
+         *
+         */
+        static void prefault(void* data, size_t size);
+
+        /**
+         * @brief Log minor and major page faults of the process or of the calling thread
+         *
+         */
+        static void log_page_faults(const std::string& label, bool calling_thread);
+
+        private:
+
+        RealtimeProfile();
+
+        RealtimeProfile(const RealtimeProfile&) = delete;
+
+        RealtimeProfile& operator=(const RealtimeProfile&) = delete;
+
+        /**
+         * @brief Log the affinity and scheduling policy the calling thread runs with
+         *
+         */
+        static void log_thread_settings(const std::string& thread_name);
+
+        struct rscmng::config::realtime_profile_settings profile;
+
+        bool memory_locked;
+    };
+
+};
+
+#endif
@@ -29,6 +29,7 @@
 #include <boost/date_time/posix_time/posix_time.hpp>
 
 #include <rscmng/utils/log.hpp>
+#include <rscmng/utils/realtime_profile.hpp>
 #include <rscmng/attributes/uuid.hpp>
 
 
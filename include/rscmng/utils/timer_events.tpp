@@ -43,7 +43,10 @@ template<class T>
 void TimerManager<T>::start()
 {
     RM_logInfo("TimerManager active")
-    executor = std::thread([this](){timer_io.run();});
+    executor = std::thread([this](){
+        RealtimeProfile::instance().apply(RT_THREAD_TIMER);
+        timer_io.run();
+    });
 }
 
 template<class T>
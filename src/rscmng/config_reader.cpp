@@ -228,6 +228,20 @@ void ConfigReader::print_service(std::map<uint32_t, struct service_settings> ser
         RM_logInfo("# Service slot_length       : " << service.slot_length << " ms")
         RM_logInfo("# Service inter packet gap  : " << service.inter_packet_gap.count() << " us")
         RM_logInfo("# Service inter object gap  : " << service.inter_object_gap.count() << " us")
+        if (!service.payload_source.empty())
+        {
+            RM_logInfo("# Service payload source    : " << service.payload_source)
+        }
+        if (service.traffic_model.type != "PERIODIC" || service.traffic_model.size_distribution != "CONSTANT")
+        {
+            RM_logInfo("# Service traffic model     : " << service.traffic_model.type
+                << (service.traffic_model.type == "TRACE" ? " " + service.traffic_model.trace_path : "")
+                << ", sizes " << service.traffic_model.size_distribution)
+            RM_logInfo("# Service traffic rate      : " << service.traffic_model.rate_per_second << " 1/s, on "
+                << service.traffic_model.on_ms << " ms, off " << service.traffic_model.off_ms << " ms")
+            RM_logInfo("# Service traffic schedule  : " << service.traffic_model.schedule_periods << " periods, seed "
+                << service.traffic_model.seed)
+        }
         RM_logInfo("#----------------------------------------------#")
     }
     
@@ -273,6 +287,28 @@ void ConfigReader::print_unit(struct unit_settings unit)
     RM_logInfo("# Service local port        : " << oss5.str())
 
     RM_logInfo("# RM Client priority        : " << unit.client_priority)
+    RM_logInfo("# Pacing spin margin        : " << unit.pacing_spin_margin.count() << " us")
+    RM_logInfo("# Transmit backend          : " << unit.transmit_backend << " batch size " << unit.transmit_batch_size)
+    RM_logInfo("# Transmit scheduler        : " << (unit.transmit_scheduler > 0 ? std::to_string(unit.transmit_scheduler) + " workers" : "off"))
+    RM_logInfo("# TxTime lead               : " << unit.txtime_lead.count() << " us" << (unit.txtime_log_only ? " (log only)" : ""))
+    RM_logInfo("# TX timestamping           : " << (unit.tx_timestamping ? "on" : "off"))
+    RM_logInfo("# Data message version      : " << unit.data_message_version)
+    RM_logInfo("# Receive backend           : " << unit.receive_backend << " batch size " << unit.receive_batch_size << (unit.receive_gro ? " GRO" : "")
+        << (unit.receive_backend == "KERNEL" ? " poll interval " + std::to_string(unit.receive_kernel_poll_interval.count()) + " ms" : ""))
+    RM_logInfo("# RX timestamping           : " << unit.receive_timestamping)
+    RM_logInfo("# Receive event loop        : " << (unit.receive_event_loop ? "on, threads " + std::to_string(unit.receive_event_threads) : "off"))
+    RM_logInfo("# Receive shards            : " << unit.receive_shards << (unit.receive_shards > 1 && unit.receive_shard_steering ? " steered by service id" : ""))
+    RM_logInfo("# Lock memory               : " << (unit.realtime_profile.lock_memory ? "on" : "off")
+        << ", prefault stack " << unit.realtime_profile.prefault_stack_kb << " KB, heap " << unit.realtime_profile.prefault_heap_kb << " KB")
+    for (const auto& thread_entry : unit.realtime_profile.threads)
+    {
+        std::ostringstream cpus;
+        for (const auto& cpu : thread_entry.second.cpus)
+        {
+            cpus << cpu << " ";
+        }
+        RM_logInfo("# Thread " << thread_entry.first << " : CPUs " << cpus.str() << "priority " << thread_entry.second.priority)
+    }
     RM_logInfo("#----------------------------------------------#")
 }
 
@@ -321,6 +357,7 @@ void ConfigReader::print_experiment_settings(struct experiment_parameter& experi
     RM_logInfo("# Inter-MC Gap Max           : " << experiment_settings.inter_mc_gap_max.count() << " ms");
     RM_logInfo("# Hyperperiod Duration       : " << experiment_settings.hyperperiod_duration.count() << " ms");
     //RM_logInfo("# Hyperperiod Slots          : " << experiment_settings.hyperperiod_slots << " ms");
+    RM_logInfo("# Timeline clock             : " << experiment_settings.timeline_clock);
     RM_logInfo("# Startup mode               : " << experiment_settings.startup_mode);
     
     RM_logInfo("# Startup mode Map          :");
@@ -406,6 +443,24 @@ struct service_settings ConfigReader::parse_service_settings(boost::property_tre
     service_settings_struct.slot_length      = service_tree.get<uint32_t>(SLOT_LENGTH);
     service_settings_struct.inter_packet_gap = std::chrono::microseconds(service_tree.get<uint32_t>(INTER_PACKET_GAP));
     service_settings_struct.inter_object_gap = std::chrono::microseconds(service_tree.get<uint32_t>(INTER_OBJECT_GAP));
+    service_settings_struct.payload_source   = service_tree.get<std::string>(PAYLOAD_SOURCE, "");
+
+    boost::optional<boost::property_tree::ptree&> traffic_model_tree = service_tree.get_child_optional(TRAFFIC_MODEL);
+    if (traffic_model_tree)
+    {
+        struct traffic_model_settings& traffic_model = service_settings_struct.traffic_model;
+        traffic_model.type              = traffic_model_tree->get<std::string>(TRAFFIC_MODEL_TYPE, traffic_model.type);
+        traffic_model.rate_per_second   = traffic_model_tree->get<double>(TRAFFIC_MODEL_RATE, traffic_model.rate_per_second);
+        traffic_model.on_ms             = traffic_model_tree->get<uint32_t>(TRAFFIC_MODEL_ON, traffic_model.on_ms);
+        traffic_model.off_ms            = traffic_model_tree->get<uint32_t>(TRAFFIC_MODEL_OFF, traffic_model.off_ms);
+        traffic_model.size_distribution = traffic_model_tree->get<std::string>(TRAFFIC_MODEL_SIZE_DISTRIBUTION, traffic_model.size_distribution);
+        traffic_model.size_min_kb       = traffic_model_tree->get<double>(TRAFFIC_MODEL_SIZE_MIN, traffic_model.size_min_kb);
+        traffic_model.size_max_kb       = traffic_model_tree->get<double>(TRAFFIC_MODEL_SIZE_MAX, traffic_model.size_max_kb);
+        traffic_model.size_stddev_kb    = traffic_model_tree->get<double>(TRAFFIC_MODEL_SIZE_STDDEV, traffic_model.size_stddev_kb);
+        traffic_model.trace_path        = traffic_model_tree->get<std::string>(TRAFFIC_MODEL_TRACE, traffic_model.trace_path);
+        traffic_model.schedule_periods  = traffic_model_tree->get<uint32_t>(TRAFFIC_MODEL_PERIODS, traffic_model.schedule_periods);
+        traffic_model.seed              = traffic_model_tree->get<uint32_t>(TRAFFIC_MODEL_SEED, traffic_model.seed);
+    }
     
     return service_settings_struct;
 }
@@ -492,6 +547,61 @@ struct unit_settings ConfigReader::parse_unit_settings(boost::property_tree::ptr
     }
     //
     unit_settings_struct.client_priority = unit_tree.get<uint32_t>(CLIENT_PRIORITY);
+    // optional, busy wait margin of the traffic generator pacing
+    unit_settings_struct.pacing_spin_margin = std::chrono::microseconds(unit_tree.get<uint32_t>(PACING_SPIN_MARGIN, 50));
+    // optional, transmit backend of the traffic generator
+    unit_settings_struct.transmit_backend = unit_tree.get<std::string>(TRANSMIT_BACKEND, "SOCKET");
+    unit_settings_struct.transmit_batch_size = unit_tree.get<uint32_t>(TRANSMIT_BATCH_SIZE, 32);
+    // optional, services of an endnode share the workers of one transmit scheduler
+    unit_settings_struct.transmit_scheduler = unit_tree.get<uint32_t>(TRANSMIT_SCHEDULER, 0);
+    // optional, launch time backend: time a fragment is handed to the kernel ahead of its launch time
+    unit_settings_struct.txtime_lead = std::chrono::microseconds(unit_tree.get<uint32_t>(TXTIME_LEAD, 500));
+    unit_settings_struct.txtime_log_only = unit_tree.get<bool>(TXTIME_LOG_ONLY, false);
+    // optional, kernel TX timestamps of the generated fragments
+    unit_settings_struct.tx_timestamping = unit_tree.get<bool>(TX_TIMESTAMPING, false);
+    // optional, header format of the generated data messages (1: legacy, 2: compact little endian, 3: compact with service mode)
+    unit_settings_struct.data_message_version = unit_tree.get<uint32_t>(DATA_MESSAGE_VERSION, 1);
+    // optional, receive backend of the traffic sink
+    unit_settings_struct.receive_backend = unit_tree.get<std::string>(RECEIVE_BACKEND, "SOCKET");
+    unit_settings_struct.receive_batch_size = unit_tree.get<uint32_t>(RECEIVE_BATCH_SIZE, 32);
+    unit_settings_struct.receive_gro = unit_tree.get<bool>(RECEIVE_GRO, false);
+    // optional, kernel receive timestamps of the traffic sink (NONE, SOFTWARE, HARDWARE)
+    unit_settings_struct.receive_timestamping = unit_tree.get<std::string>(RECEIVE_TIMESTAMPING, "SOFTWARE");
+    // optional, all sink ports on a shared epoll thread pool instead of one thread per port
+    unit_settings_struct.receive_event_loop = unit_tree.get<bool>(RECEIVE_EVENT_LOOP, false);
+    unit_settings_struct.receive_event_threads = unit_tree.get<uint32_t>(RECEIVE_EVENT_THREADS, 0);
+    // optional, SO_REUSEPORT sockets per sink port and steering of the services to them
+    unit_settings_struct.receive_shards = unit_tree.get<uint32_t>(RECEIVE_SHARDS, 1);
+    unit_settings_struct.receive_shard_steering = unit_tree.get<bool>(RECEIVE_SHARD_STEERING, true);
+    // optional, interval the KERNEL receive backend reads its per service counters
+    unit_settings_struct.receive_kernel_poll_interval = std::chrono::milliseconds(unit_tree.get<uint32_t>(RECEIVE_KERNEL_POLL_INTERVAL, 1000));
+    // optional, CPU pinning, SCHED_FIFO priorities and memory locking of the host
+    boost::optional<boost::property_tree::ptree&> realtime_tree = unit_tree.get_child_optional(REALTIME_PROFILE);
+    if (realtime_tree)
+    {
+        struct realtime_profile_settings& realtime_profile = unit_settings_struct.realtime_profile;
+        realtime_profile.lock_memory       = realtime_tree->get<bool>(REALTIME_LOCK_MEMORY, false);
+        realtime_profile.prefault_stack_kb = realtime_tree->get<uint32_t>(REALTIME_PREFAULT_STACK, 0);
+        realtime_profile.prefault_heap_kb  = realtime_tree->get<uint32_t>(REALTIME_PREFAULT_HEAP, 0);
+        boost::optional<boost::property_tree::ptree&> threads_tree = realtime_tree->get_child_optional(REALTIME_THREADS);
+        if (threads_tree)
+        {
+            for (const auto& thread_tree : *threads_tree)
+            {
+                struct realtime_thread_settings thread_settings;
+                boost::optional<const boost::property_tree::ptree&> cpus_tree = thread_tree.second.get_child_optional(REALTIME_THREAD_CPUS);
+                if (cpus_tree)
+                {
+                    for (const auto& cpu : *cpus_tree)
+                    {
+                        thread_settings.cpus.push_back(cpu.second.get_value<uint32_t>());
+                    }
+                }
+                thread_settings.priority = thread_tree.second.get<int>(REALTIME_THREAD_PRIORITY, 0);
+                realtime_profile.threads[thread_tree.first] = thread_settings;
+            }
+        }
+    }
 
     /*
     std::string host_id = unit_tree.get<std::string>(HOST_ID);    
@@ -530,6 +640,7 @@ struct experiment_parameter ConfigReader::check_experiment_settings(boost::prope
     experiment_settings.inter_mc_gap_max                = std::chrono::milliseconds(experiment_tree.get<uint32_t>(INTER_MC_GAP_MAX));
     experiment_settings.hyperperiod_duration            = std::chrono::milliseconds(experiment_tree.get<uint32_t>(HYPERPERIOD_DURATION));
     //experiment_settings.hyperperiod_slots               = experiment_tree.get<uint32_t>(HYPERPERIOD_SLOTS);
+    experiment_settings.timeline_clock                  = experiment_tree.get<std::string>(TIMELINE_CLOCK, "MONOTONIC");
 
     experiment_settings.startup_mode = experiment_tree.get<uint32_t>(EXPERIMENT_STARTUP_MODE); 
     for (const auto& outer : experiment_tree.get_child(EXPERIMENT_STARTUP_MODE_MAP)) 
@@ -0,0 +1,280 @@
+// Copyright (C) 2025 IDA
+//
+// This file is part of a project licensed under the GNU Lesser General Public License v3.0.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+
+#include <cstring>
+#include <cerrno>
+#include <fstream>
+#include <iomanip>
+
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+#include <rscmng/generator_benchmark.hpp>
+#include <rscmng/utils/realtime_profile.hpp>
+
+
+using namespace traffic_generator;
+
+
+/*
+*
+*/
+std::string traffic_generator::transmit_backend_name(TransmitBackend backend)
+{
+    switch (backend)
+    {
+        case TRANSMIT_BATCH:
+            return "BATCH";
+        case TRANSMIT_GSO:
+            return "GSO";
+        case TRANSMIT_TXTIME:
+            return "TXTIME";
+        case TRANSMIT_PACKET_RING:
+            return "PACKET_RING";
+        default:
+            return "SOCKET";
+    }
+}
+
+
+/*
+*
+*/
+std::string traffic_generator::pacing_strategy_name(rscmng::PacingStrategy strategy)
+{
+    switch (strategy)
+    {
+        case rscmng::PACING_BUSY_SPIN:
+            return "BUSY_SPIN";
+        case rscmng::PACING_SLEEP:
+            return "SLEEP";
+        default:
+            return "SLEEP_SPIN";
+    }
+}
+
+
+/*
+*
+*/
+GeneratorBenchmark::GeneratorBenchmark(
+    const struct rscmng::config::unit_settings& unit_configuration,
+    const struct rscmng::config::experiment_parameter& experiment_parameter,
+    const struct benchmark_settings& settings
+)
+:
+    unit_configuration(unit_configuration),
+    experiment_parameter(experiment_parameter),
+    settings(settings),
+    sink_active(false),
+    sink_received(0)
+{
+    // The generator binds its source port on the first local address, the sink receives on the configured one
+    if (this->unit_configuration.rm_control_local_ip.empty())
+    {
+        this->unit_configuration.rm_control_local_ip.push_back(settings.sink_ip);
+    }
+    this->experiment_parameter.synchronous_start_mode = false;
+}
+
+
+/*
+*
+*/
+std::vector<struct benchmark_result> GeneratorBenchmark::run()
+{
+    std::vector<struct benchmark_result> results;
+
+    int sink_socket = socket(AF_INET, SOCK_DGRAM, 0);
+    struct sockaddr_in sink_address;
+    memset(&sink_address, 0, sizeof(sink_address));
+    sink_address.sin_family = AF_INET;
+    sink_address.sin_port = htons(static_cast<uint16_t>(settings.sink_port));
+    inet_pton(AF_INET, settings.sink_ip.c_str(), &sink_address.sin_addr);
+    if (sink_socket < 0 || bind(sink_socket, reinterpret_cast<struct sockaddr*>(&sink_address), sizeof(sink_address)) != 0)
+    {
+        RM_logError("Generator benchmark discard sink " << settings.sink_ip << ":" << settings.sink_port << " not bound: " << strerror(errno))
+        if (sink_socket >= 0)
+        {
+            close(sink_socket);
+        }
+        return results;
+    }
+    int receive_buffer_size = 32 * 1024 * 1024;
+    setsockopt(sink_socket, SOL_SOCKET, SO_RCVBUF, &receive_buffer_size, sizeof(receive_buffer_size));
+    struct timeval receive_timeout = {0, 100000};
+    setsockopt(sink_socket, SOL_SOCKET, SO_RCVTIMEO, &receive_timeout, sizeof(receive_timeout));
+
+    sink_active = true;
+    std::thread sink_thread(&GeneratorBenchmark::discard_sink, this, sink_socket);
+
+    for (const auto& backend : settings.transmit_backends)
+    {
+        for (const auto& pacing : settings.pacing_strategies)
+        {
+            for (const auto& object_size_kb : settings.object_sizes_kb)
+            {
+                for (const auto& inter_packet_gap : settings.inter_packet_gaps)
+                {
+                    results.push_back(measure(backend, pacing, object_size_kb, inter_packet_gap));
+                }
+            }
+        }
+    }
+
+    sink_active = false;
+    sink_thread.join();
+    close(sink_socket);
+
+    return results;
+}
+
+
+/*
+*
+*/
+void GeneratorBenchmark::report(const std::vector<struct benchmark_result>& results) const
+{
+    std::ofstream result_file(settings.result_file);
+    result_file << "backend,pacing,object_size_kb,inter_packet_gap_us,fragments_sent,fragments_received,duration_s,"
+        << "packets_per_second,gbit_per_second,cpu_utilization,"
+        << "gap_error_p50_ns,gap_error_p90_ns,gap_error_p99_ns,gap_error_p999_ns,gap_error_max_ns,"
+        << "start_lateness_p50_ns,start_lateness_p90_ns,start_lateness_p99_ns,start_lateness_p999_ns,start_lateness_max_ns\n";
+
+    for (const auto& result : results)
+    {
+        RM_logInfo("Generator benchmark " << transmit_backend_name(result.transmit_backend) << " " << pacing_strategy_name(result.pacing_strategy)
+            << " " << result.object_size_kb << " KB gap " << result.inter_packet_gap.count() << " us: "
+            << std::fixed << std::setprecision(0) << result.packets_per_second << " pps, "
+            << std::setprecision(3) << result.gbit_per_second << " Gbit/s, CPU " << std::setprecision(1) << result.cpu_utilization * 100.0 << " %, "
+            << "received " << result.fragments_received << "/" << result.fragments_sent
+            << ", gap error p50/p99/p99.9 " << result.gap_error.p50 / 1000.0 << "/" << result.gap_error.p99 / 1000.0 << "/" << result.gap_error.p999 / 1000.0 << " us"
+            << ", start lateness p50/p99/p99.9 " << result.start_lateness.p50 / 1000.0 << "/" << result.start_lateness.p99 / 1000.0 << "/" << result.start_lateness.p999 / 1000.0 << " us")
+
+        result_file << transmit_backend_name(result.transmit_backend) << "," << pacing_strategy_name(result.pacing_strategy) << ","
+            << result.object_size_kb << "," << result.inter_packet_gap.count() << ","
+            << result.fragments_sent << "," << result.fragments_received << "," << result.duration_s << ","
+            << result.packets_per_second << "," << result.gbit_per_second << "," << result.cpu_utilization << ","
+            << result.gap_error.p50 << "," << result.gap_error.p90 << "," << result.gap_error.p99 << "," << result.gap_error.p999 << "," << result.gap_error.max << ","
+            << result.start_lateness.p50 << "," << result.start_lateness.p90 << "," << result.start_lateness.p99 << "," << result.start_lateness.p999 << "," << result.start_lateness.max << "\n";
+    }
+
+    RM_logInfo("Generator benchmark results written to " << settings.result_file)
+}
+
+
+/*------------------------------------- Private -----------------------------------------*/
+/*
+*
+*/
+struct benchmark_result GeneratorBenchmark::measure(TransmitBackend backend, rscmng::PacingStrategy pacing, uint32_t object_size_kb, std::chrono::microseconds inter_packet_gap)
+{
+    std::map<uint32_t, struct rscmng::config::service_settings> service_configuration;
+    struct rscmng::config::service_settings service_setting = rscmng::config::service_settings();
+    service_setting.service_id = 0xBE;
+    service_setting.ip_address = settings.sink_ip;
+    service_setting.port = settings.sink_port;
+    service_setting.object_size = object_size_kb;
+    service_setting.deadline = static_cast<uint32_t>(settings.period.count());
+    service_setting.service_priority = 1;
+    service_setting.inter_packet_gap = inter_packet_gap;
+    service_configuration[0] = service_setting;
+
+    traffic_generator_parameter traffic_pattern;
+    traffic_pattern.info_flag = false;
+    traffic_pattern.period = settings.period;
+    traffic_pattern.object_size_kb = object_size_kb;
+    traffic_pattern.inter_object_gap = std::chrono::microseconds(0);
+    traffic_pattern.inter_packet_gap = inter_packet_gap;
+    traffic_pattern.auto_traffic_termination = settings.objects;
+    traffic_pattern.pacing_strategy = pacing;
+    traffic_pattern.pacing_spin_margin = unit_configuration.pacing_spin_margin;
+    traffic_pattern.transmit_backend = backend;
+    traffic_pattern.batch_size = unit_configuration.transmit_batch_size > 0 ? unit_configuration.transmit_batch_size : traffic_pattern.batch_size;
+    traffic_pattern.txtime_lead = unit_configuration.txtime_lead;
+    traffic_pattern.txtime_log_only = unit_configuration.txtime_log_only;
+    traffic_pattern.tx_timestamping = false;
+    traffic_pattern.message_version = rscmng::data_message_version_from_number(unit_configuration.data_message_version);
+
+    uint64_t received_before = sink_received;
+
+    TrafficGenerator traffic_generator(service_configuration, unit_configuration, experiment_parameter, OBJECT_BURST_DYNAMIC_CHANGE, traffic_pattern);
+    traffic_generator.start();
+
+    struct timespec start_time;
+    clock_gettime(CLOCK_REALTIME, &start_time);
+    std::chrono::steady_clock::time_point wall_start = std::chrono::steady_clock::now();
+    traffic_generator.notify_generator_timestamp(THREAD_TRANSMISSION, start_time, 0, true);
+    traffic_generator.join();
+    std::chrono::steady_clock::time_point wall_end = std::chrono::steady_clock::now();
+
+    // Let the sink drain the socket buffer
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    struct benchmark_result result;
+    result.transmit_backend = backend;
+    result.pacing_strategy = pacing;
+    result.object_size_kb = object_size_kb;
+    result.inter_packet_gap = inter_packet_gap;
+    result.fragments_sent = traffic_generator.fragments_sent();
+    result.fragments_received = sink_received - received_before;
+    result.duration_s = std::chrono::duration<double>(wall_end - wall_start).count();
+    result.packets_per_second = result.duration_s > 0 ? result.fragments_sent / result.duration_s : 0;
+    result.gbit_per_second = result.duration_s > 0 ? traffic_generator.bytes_sent() * 8.0 / result.duration_s / 1e9 : 0;
+    result.cpu_utilization = result.duration_s > 0 ? traffic_generator.thread_cpu_time_ns() / 1e9 / result.duration_s : 0;
+    result.gap_error = percentiles_of(traffic_generator.inter_packet_gap_error());
+    result.start_lateness = percentiles_of(traffic_generator.object_start_lateness());
+
+    return result;
+}
+
+
+/*
+*
+*/
+void GeneratorBenchmark::discard_sink(int socket_fd)
+{
+    rscmng::RealtimeProfile::instance().apply(RT_THREAD_SINK);
+
+    std::vector<char> receive_buffer(65536);
+    while (sink_active)
+    {
+        ssize_t length = recv(socket_fd, receive_buffer.data(), receive_buffer.size(), 0);
+        if (length >= 0)
+        {
+            sink_received++;
+        }
+    }
+}
+
+
+/*
+*
+*/
+struct benchmark_percentiles GeneratorBenchmark::percentiles_of(const rscmng::LogLinearHistogram& histogram)
+{
+    struct benchmark_percentiles percentiles;
+    percentiles.p50 = histogram.percentile(50.0);
+    percentiles.p90 = histogram.percentile(90.0);
+    percentiles.p99 = histogram.percentile(99.0);
+    percentiles.p999 = histogram.percentile(99.9);
+    percentiles.max = histogram.max();
+    return percentiles;
+}
@@ -0,0 +1,167 @@
+// Copyright (C) 2025 IDA
+//
+// This file is part of a project licensed under the GNU Lesser General Public License v3.0.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+
+#include <rscmng/generator_control.hpp>
+
+
+using namespace traffic_generator;
+
+
+/*
+*
+*/
+GeneratorControl::GeneratorControl()
+:
+    sequence(0),
+    control_state(THREAD_START),
+    control_mode(0),
+    period_seconds(0),
+    period_nanoseconds(0),
+    period_version(0)
+{
+
+}
+
+
+/*
+*
+*/
+void GeneratorControl::publish_state(TrafficSourceControl state)
+{
+    {
+        std::lock_guard<std::mutex> lock(writer_mutex);
+        write(state, control_mode.load(std::memory_order_relaxed), nullptr);
+    }
+    resume_condition.notify_all();
+}
+
+
+/*
+*
+*/
+void GeneratorControl::publish_mode(TrafficSourceControl state, uint32_t mode)
+{
+    {
+        std::lock_guard<std::mutex> lock(writer_mutex);
+        write(state, mode, nullptr);
+    }
+    resume_condition.notify_all();
+}
+
+
+/*
+*
+*/
+void GeneratorControl::publish_timestamp(TrafficSourceControl state, struct timespec timestamp, uint32_t mode, bool update_period)
+{
+    {
+        std::lock_guard<std::mutex> lock(writer_mutex);
+        write(state, mode, update_period ? &timestamp : nullptr);
+    }
+    resume_condition.notify_all();
+}
+
+
+/*
+*
+*/
+TrafficSourceControl GeneratorControl::state() const
+{
+    return static_cast<TrafficSourceControl>(control_state.load(std::memory_order_acquire));
+}
+
+
+/*
+*
+*/
+control_snapshot GeneratorControl::snapshot() const
+{
+    control_snapshot copy;
+    uint64_t sequence_begin;
+    uint64_t sequence_end;
+
+    do
+    {
+        sequence_begin = sequence.load(std::memory_order_acquire);
+        copy.state = static_cast<TrafficSourceControl>(control_state.load(std::memory_order_relaxed));
+        copy.mode = control_mode.load(std::memory_order_relaxed);
+        copy.period_timestamp.tv_sec = static_cast<time_t>(period_seconds.load(std::memory_order_relaxed));
+        copy.period_timestamp.tv_nsec = static_cast<long>(period_nanoseconds.load(std::memory_order_relaxed));
+        copy.period_version = period_version.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        sequence_end = sequence.load(std::memory_order_relaxed);
+    }
+    while ((sequence_begin & 1) != 0 || sequence_begin != sequence_end);
+
+    copy.version = sequence_begin >> 1;
+    return copy;
+}
+
+
+/*
+*
+*/
+TrafficSourceControl GeneratorControl::await_transmission(bool finish_object_allowed)
+{
+    TrafficSourceControl current_state = state();
+    if (releases(current_state, finish_object_allowed))
+    {
+        return current_state;
+    }
+
+    // Paused, writers publish under writer_mutex before notifying so no wakeup is lost
+    std::unique_lock<std::mutex> lock(writer_mutex);
+    resume_condition.wait(lock, [&] {
+        current_state = state();
+        return releases(current_state, finish_object_allowed);
+    });
+    return current_state;
+}
+
+
+/*------------------------------------- Private -----------------------------------------*/
+/*
+*
+*/
+bool GeneratorControl::releases(TrafficSourceControl state, bool finish_object_allowed)
+{
+    return state == THREAD_TRANSMISSION
+        || state == THREAD_STOP
+        || (finish_object_allowed && state == THREAD_TRANSMISSION_FINISH_OBJECT);
+}
+
+
+/*
+*
+*/
+void GeneratorControl::write(TrafficSourceControl state, uint32_t mode, const struct timespec* timestamp)
+{
+    sequence.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    control_mode.store(mode, std::memory_order_relaxed);
+    if (timestamp != nullptr)
+    {
+        period_seconds.store(static_cast<int64_t>(timestamp->tv_sec), std::memory_order_relaxed);
+        period_nanoseconds.store(static_cast<int64_t>(timestamp->tv_nsec), std::memory_order_relaxed);
+        period_version.store(period_version.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+    control_state.store(state, std::memory_order_release);
+
+    sequence.fetch_add(1, std::memory_order_release);
+}
@@ -0,0 +1,220 @@
+// Copyright (C) 2025 IDA
+//
+// This file is part of a project licensed under the GNU Lesser General Public License v3.0.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+
+#include <rscmng/utils/histogram.hpp>
+
+
+using namespace rscmng;
+
+
+/*
+*
+*/
+LogLinearHistogram::LogLinearHistogram()
+{
+    reset();
+}
+
+
+/*
+*
+*/
+void LogLinearHistogram::record(uint64_t value)
+{
+    buckets[bucket_index(value)].fetch_add(1, std::memory_order_relaxed);
+    total_count.fetch_add(1, std::memory_order_relaxed);
+    total_sum.fetch_add(value, std::memory_order_relaxed);
+
+    uint64_t current = min_value.load(std::memory_order_relaxed);
+    while (value < current && !min_value.compare_exchange_weak(current, value, std::memory_order_relaxed));
+
+    current = max_value.load(std::memory_order_relaxed);
+    while (value > current && !max_value.compare_exchange_weak(current, value, std::memory_order_relaxed));
+}
+
+
+/*
+*
+*/
+void LogLinearHistogram::merge(const LogLinearHistogram& other)
+{
+    if (other.count() == 0)
+    {
+        return;
+    }
+
+    for (uint32_t index = 0; index < HISTOGRAM_BUCKETS; ++index)
+    {
+        uint64_t bucket_count = other.buckets[index].load(std::memory_order_relaxed);
+        if (bucket_count != 0)
+        {
+            buckets[index].fetch_add(bucket_count, std::memory_order_relaxed);
+        }
+    }
+    total_count.fetch_add(other.total_count.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    total_sum.fetch_add(other.total_sum.load(std::memory_order_relaxed), std::memory_order_relaxed);
+
+    uint64_t other_min = other.min_value.load(std::memory_order_relaxed);
+    uint64_t current = min_value.load(std::memory_order_relaxed);
+    while (other_min < current && !min_value.compare_exchange_weak(current, other_min, std::memory_order_relaxed));
+
+    uint64_t other_max = other.max_value.load(std::memory_order_relaxed);
+    current = max_value.load(std::memory_order_relaxed);
+    while (other_max > current && !max_value.compare_exchange_weak(current, other_max, std::memory_order_relaxed));
+}
+
+
+/*
+*
+*/
+void LogLinearHistogram::reset()
+{
+    for (auto& bucket : buckets)
+    {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    total_count.store(0, std::memory_order_relaxed);
+    total_sum.store(0, std::memory_order_relaxed);
+    min_value.store(UINT64_MAX, std::memory_order_relaxed);
+    max_value.store(0, std::memory_order_relaxed);
+}
+
+
+/*
+*
+*/
+uint64_t LogLinearHistogram::count() const
+{
+    return total_count.load(std::memory_order_relaxed);
+}
+
+
+/*
+*
+*/
+uint64_t LogLinearHistogram::min() const
+{
+    return count() == 0 ? 0 : min_value.load(std::memory_order_relaxed);
+}
+
+
+/*
+*
+*/
+uint64_t LogLinearHistogram::max() const
+{
+    return max_value.load(std::memory_order_relaxed);
+}
+
+
+/*
+*
+*/
+double LogLinearHistogram::mean() const
+{
+    uint64_t number_values = count();
+    if (number_values == 0)
+    {
+        return 0.0;
+    }
+    return static_cast<double>(total_sum.load(std::memory_order_relaxed)) / number_values;
+}
+
+
+/*
+*
+*/
+uint64_t LogLinearHistogram::percentile(double percentile) const
+{
+    uint64_t number_values = count();
+    if (number_values == 0)
+    {
+        return 0;
+    }
+
+    uint64_t target = static_cast<uint64_t>(percentile / 100.0 * number_values + 0.5);
+    if (target == 0)
+    {
+        target = 1;
+    }
+
+    uint64_t accumulated = 0;
+    for (uint32_t index = 0; index < HISTOGRAM_BUCKETS; ++index)
+    {
+        accumulated += buckets[index].load(std::memory_order_relaxed);
+        if (accumulated >= target)
+        {
+            return std::min(bucket_upper_bound(index), max());
+        }
+    }
+    return max();
+}
+
+
+/*
+*
+*/
+void LogLinearHistogram::print(std::string name) const
+{
+    RM_logInfo(name << " count: " << count()
+        << " min: " << min() / 1e3 << " us"
+        << " mean: " << mean() / 1e3 << " us"
+        << " p50: " << percentile(50.0) / 1e3 << " us"
+        << " p90: " << percentile(90.0) / 1e3 << " us"
+        << " p99: " << percentile(99.0) / 1e3 << " us"
+        << " p99.9: " << percentile(99.9) / 1e3 << " us"
+        << " max: " << max() / 1e3 << " us")
+}
+
+
+/*
+*
+*/
+uint32_t LogLinearHistogram::bucket_index(uint64_t value)
+{
+    if (value < HISTOGRAM_SUB_BUCKETS)
+    {
+        return static_cast<uint32_t>(value);
+    }
+
+    uint32_t most_significant_bit = 63 - __builtin_clzll(value);
+    uint32_t shift = most_significant_bit - HISTOGRAM_SUB_BUCKET_BITS;
+    uint32_t group = shift + 1;
+    uint32_t sub_bucket = static_cast<uint32_t>(value >> shift) - HISTOGRAM_SUB_BUCKETS;
+
+    return group * HISTOGRAM_SUB_BUCKETS + sub_bucket;
+}
+
+
+/*
+*
+*/
+uint64_t LogLinearHistogram::bucket_upper_bound(uint32_t index)
+{
+    if (index < HISTOGRAM_SUB_BUCKETS)
+    {
+        return index;
+    }
+
+    uint32_t group = index / HISTOGRAM_SUB_BUCKETS;
+    uint32_t sub_bucket = index % HISTOGRAM_SUB_BUCKETS;
+    uint32_t shift = group - 1;
+    uint64_t lower_bound = static_cast<uint64_t>(HISTOGRAM_SUB_BUCKETS + sub_bucket) << shift;
+
+    return lower_bound + ((static_cast<uint64_t>(1) << shift) - 1);
+}
@@ -0,0 +1,244 @@
+// Copyright (C) 2025 IDA
+//
+// This file is part of a project licensed under the GNU Lesser General Public License v3.0.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+
+#include <rscmng/utils/hyperperiod_timeline.hpp>
+
+
+using namespace rscmng;
+
+
+/*
+*
+*/
+TimelineClock rscmng::timeline_clock_from_string(std::string clock_name)
+{
+    if (clock_name == "TAI")
+    {
+        return TIMELINE_TAI;
+    }
+    if (clock_name == "REALTIME")
+    {
+        return TIMELINE_REALTIME;
+    }
+    if (clock_name != "MONOTONIC")
+    {
+        RM_logWarning("Unknown timeline clock " << clock_name << ", using MONOTONIC")
+    }
+    return TIMELINE_MONOTONIC;
+}
+
+
+/*
+*
+*/
+clockid_t rscmng::timeline_clock_id(TimelineClock clock)
+{
+    switch (clock)
+    {
+        case TIMELINE_TAI:
+            return CLOCK_TAI;
+        case TIMELINE_REALTIME:
+            return CLOCK_REALTIME;
+        default:
+            return CLOCK_MONOTONIC;
+    }
+}
+
+
+/*
+*
+*/
+HyperperiodTimeline::HyperperiodTimeline(TimelineClock clock, int64_t period_ns)
+:
+    timeline_clock(clock),
+    clock_identifier(timeline_clock_id(clock)),
+    anchor_ns(0),
+    period_ns(period_ns),
+    is_anchored(false)
+{
+
+}
+
+
+/*
+*
+*/
+void HyperperiodTimeline::anchor(int64_t new_anchor_ns, int64_t new_period_ns)
+{
+    anchor_ns = new_anchor_ns;
+    period_ns = new_period_ns;
+    is_anchored = true;
+}
+
+
+/*
+*
+*/
+void HyperperiodTimeline::rebase(uint64_t slot, int64_t new_period_ns)
+{
+    anchor(slot_start(slot), new_period_ns);
+}
+
+
+/*
+*
+*/
+bool HyperperiodTimeline::anchored() const
+{
+    return is_anchored;
+}
+
+
+/*
+*
+*/
+int64_t HyperperiodTimeline::period() const
+{
+    return period_ns;
+}
+
+
+/*
+*
+*/
+TimelineClock HyperperiodTimeline::clock() const
+{
+    return timeline_clock;
+}
+
+
+/*
+*
+*/
+clockid_t HyperperiodTimeline::clock_id() const
+{
+    return clock_identifier;
+}
+
+
+/*
+*
+*/
+int64_t HyperperiodTimeline::now() const
+{
+    struct timespec time_now = {0,0};
+    clock_gettime(clock_identifier, &time_now);
+    return to_ns(time_now);
+}
+
+
+/*
+*
+*/
+int64_t HyperperiodTimeline::slot_start(uint64_t slot) const
+{
+    return anchor_ns + static_cast<int64_t>(slot) * period_ns;
+}
+
+
+/*
+*
+*/
+uint64_t HyperperiodTimeline::slot_index(int64_t time_ns) const
+{
+    if (time_ns <= anchor_ns || period_ns <= 0)
+    {
+        return 0;
+    }
+    return static_cast<uint64_t>((time_ns - anchor_ns) / period_ns);
+}
+
+
+/*
+*
+*/
+uint64_t HyperperiodTimeline::next_slot(int64_t time_ns) const
+{
+    if (time_ns <= anchor_ns || period_ns <= 0)
+    {
+        return 0;
+    }
+    return static_cast<uint64_t>((time_ns - anchor_ns + period_ns - 1) / period_ns);
+}
+
+
+/*
+*
+*/
+int64_t HyperperiodTimeline::from_realtime(const struct timespec& realtime) const
+{
+    return to_ns(realtime) + realtime_offset();
+}
+
+
+/*
+*
+*/
+struct timespec HyperperiodTimeline::to_realtime(int64_t time_ns) const
+{
+    return to_timespec(time_ns - realtime_offset());
+}
+
+
+/*
+*
+*/
+int64_t HyperperiodTimeline::to_ns(const struct timespec& timestamp)
+{
+    return static_cast<int64_t>(timestamp.tv_sec) * 1000000000L + timestamp.tv_nsec;
+}
+
+
+/*
+*
+*/
+struct timespec HyperperiodTimeline::to_timespec(int64_t time_ns)
+{
+    struct timespec timestamp;
+    timestamp.tv_sec = static_cast<time_t>(time_ns / 1000000000L);
+    timestamp.tv_nsec = static_cast<long>(time_ns % 1000000000L);
+    if (timestamp.tv_nsec < 0)
+    {
+        timestamp.tv_sec -= 1;
+        timestamp.tv_nsec += 1000000000L;
+    }
+    return timestamp;
+}
+
+
+/*------------------------------------- Private -----------------------------------------*/
+/*
+*
+*/
+int64_t HyperperiodTimeline::realtime_offset() const
+{
+    if (timeline_clock == TIMELINE_REALTIME)
+    {
+        return 0;
+    }
+
+    struct timespec realtime_before = {0,0};
+    struct timespec timeline_now = {0,0};
+    struct timespec realtime_after = {0,0};
+    clock_gettime(CLOCK_REALTIME, &realtime_before);
+    clock_gettime(clock_identifier, &timeline_now);
+    clock_gettime(CLOCK_REALTIME, &realtime_after);
+
+    int64_t realtime_middle = to_ns(realtime_before) + (to_ns(realtime_after) - to_ns(realtime_before)) / 2;
+    return to_ns(timeline_now) - realtime_middle;
+}
@@ -16,6 +16,9 @@
 // along with this program. If not, see <https://www.gnu.org/licenses/>.
 
 
+#include <algorithm>
+#include <endian.h>
+
 #include <rscmng/messages.hpp>
 
 
@@ -224,8 +227,8 @@ DataMessage::DataMessage(
     payload_length(payload_size),
     timestamp({0,0})
 {
-    length = sizeof(priority) + sizeof(source_id) + sizeof(service_id) + sizeof(object_number) + sizeof(fragment_number) + sizeof(total_fragments) + payload_length + sizeof(timestamp);
-    header_length = sizeof(priority) + sizeof(source_id) + sizeof(service_id) + sizeof(object_number) + sizeof(fragment_number) + sizeof(total_fragments) + sizeof(timestamp);
+    header_length = sizeof(priority) + sizeof(source_id) + sizeof(service_id) + sizeof(object_number) + sizeof(fragment_number) + sizeof(total_fragments) + sizeof(timestamp) + sizeof(time_stamp);
+    length = header_length + payload_length;
     memcpy(payload, payload, payload_size);
     time_stamp = std::chrono::system_clock::now();
 }
@@ -252,8 +255,8 @@ DataMessage::DataMessage(
     payload_length(payload_size),
     timestamp(timestamp)
 {
-    length = sizeof(priority) + sizeof(source_id) + sizeof(service_id) + sizeof(object_number) + sizeof(fragment_number) + sizeof(total_fragments) + payload_length + sizeof(timestamp);
-    header_length = sizeof(priority) + sizeof(source_id) + sizeof(service_id) + sizeof(object_number) + sizeof(fragment_number) + sizeof(total_fragments) + sizeof(timestamp);
+    header_length = sizeof(priority) + sizeof(source_id) + sizeof(service_id) + sizeof(object_number) + sizeof(fragment_number) + sizeof(total_fragments) + sizeof(timestamp) + sizeof(time_stamp);
+    length = header_length + payload_length;
     memcpy(payload, payload, payload_size);
     time_stamp = std::chrono::system_clock::now();
 }
@@ -277,7 +280,8 @@ void DataMessage::dataToNet(char* message)
 void DataMessage::netToData(char* message, size_t size)
 {
     length = size;
-    payload_length = length - header_length;
+    // Never copy more than was received or fits into the payload
+    payload_length = size > header_length ? std::min<size_t>(size - header_length, sizeof(payload)) : 0;
     
     priority = (uint8_t)(message[0]);
     memcpy(&source_id, (message+sizeof(priority)), sizeof(source_id));
@@ -343,6 +347,7 @@ void DataMessage::set_packet_number(uint32_t packet_number)
 void DataMessage::set_payload_size( size_t payload_size)
 {
     payload_length = payload_size;
+    length = header_length + payload_length;
 }
 
 
@@ -425,4 +430,410 @@ void DataMessage::clear()
     length = header_length;
 }
 
+
+// ----------------------------- DataMessageTemplate ---------------------------------------------------------------
+// A full fragment must not be split into IP fragments on a 1500 byte MTU
+static_assert(DataMessageTemplate::HEADER_LENGTH + demonstrator::MAX_PROTOCOL_MESSAGE_LENGTH <= demonstrator::MAX_DATAGRAM_LENGTH,
+    "full data message exceeds MAX_DATAGRAM_LENGTH");
+
+/*
+*
+*/
+DataMessageVersion rscmng::data_message_version_from_number(uint32_t version_number)
+{
+    if (version_number == DATA_MESSAGE_V2 || version_number == DATA_MESSAGE_V3)
+    {
+        return static_cast<DataMessageVersion>(version_number);
+    }
+    if (version_number != DATA_MESSAGE_V1)
+    {
+        RM_logWarning("Unknown data message version " << version_number << ", using 1")
+    }
+    return DATA_MESSAGE_V1;
+}
+
+
+/*
+*
+*/
+DataMessageTemplate::DataMessageTemplate()
+:
+    header_version(DATA_MESSAGE_V1),
+    header_length(HEADER_LENGTH)
+{
+    memset(header, 0, sizeof(header));
+}
+
+
+/*
+*
+*/
+void DataMessageTemplate::prepare(uint8_t priority, uint32_t client_id, serviceID_t service_id, uint32_t object_number, uint32_t total_fragments, DataMessageVersion version, int32_t mode)
+{
+    memset(header, 0, sizeof(header));
+    header_version = version;
+
+    if (header_version != DATA_MESSAGE_V1)
+    {
+        header_length = DataMessageHeaderV2::HEADER_LENGTH;
+        uint32_t source_le = htole32(client_id);
+        uint64_t service_le = htole64(service_id);
+        header[DataMessageHeaderV2::MARKER_OFFSET] = static_cast<char>(DataMessageHeaderV2::MARKER);
+        header[DataMessageHeaderV2::VERSION_OFFSET] = static_cast<char>(header_version);
+        header[DataMessageHeaderV2::PRIORITY_OFFSET] = static_cast<char>(priority & 0xFF);
+        header[DataMessageHeaderV2::HEADER_LENGTH_OFFSET] = static_cast<char>(DataMessageHeaderV2::HEADER_LENGTH);
+        memcpy(header + DataMessageHeaderV2::SOURCE_ID_OFFSET, &source_le, sizeof(source_le));
+        memcpy(header + DataMessageHeaderV2::SERVICE_ID_OFFSET, &service_le, sizeof(service_le));
+        if (header_version == DATA_MESSAGE_V3 && mode >= 0 && mode < 0xFFFF)
+        {
+            uint16_t mode_le = htole16(static_cast<uint16_t>(mode + 1));
+            memcpy(header + DataMessageHeaderV3::MODE_OFFSET, &mode_le, sizeof(mode_le));
+        }
+        begin_object(object_number, total_fragments);
+        return;
+    }
+
+    header_length = HEADER_LENGTH;
+    char* position = header;
+    *position = static_cast<char>(priority & 0xFF);
+    position += sizeof(priority);
+    memcpy(position, &client_id, sizeof(client_id));
+    position += sizeof(client_id);
+    memcpy(position, &service_id, sizeof(service_id));
+    position += sizeof(service_id);
+    memcpy(position, &object_number, sizeof(object_number));
+    memcpy(header + FRAGMENT_NUMBER_OFFSET + sizeof(uint32_t), &total_fragments, sizeof(total_fragments));
+
+    // Set once per object, like the time_stamp of a DataMessage constructed per object
+    std::chrono::system_clock::time_point time_stamp = std::chrono::system_clock::now();
+    memcpy(header + TIME_STAMP_OFFSET, &time_stamp, sizeof(time_stamp));
+}
+
+
+/*
+*
+*/
+void DataMessageTemplate::begin_object(uint32_t object_number, uint32_t total_fragments)
+{
+    if (header_version != DATA_MESSAGE_V1)
+    {
+        // v2 carries no separate object time stamp, the send time of the first fragment takes its place
+        uint32_t object_le = htole32(object_number);
+        uint32_t total_le = htole32(total_fragments);
+        memcpy(header + DataMessageHeaderV2::OBJECT_NUMBER_OFFSET, &object_le, sizeof(object_le));
+        memcpy(header + DataMessageHeaderV2::TOTAL_FRAGMENTS_OFFSET, &total_le, sizeof(total_le));
+        return;
+    }
+
+    memcpy(header + FRAGMENT_NUMBER_OFFSET - sizeof(object_number), &object_number, sizeof(object_number));
+    memcpy(header + FRAGMENT_NUMBER_OFFSET + sizeof(uint32_t), &total_fragments, sizeof(total_fragments));
+
+    std::chrono::system_clock::time_point time_stamp = std::chrono::system_clock::now();
+    memcpy(header + TIME_STAMP_OFFSET, &time_stamp, sizeof(time_stamp));
+}
+
+
+/*
+*
+*/
+void DataMessageTemplate::patch(uint32_t fragment_number, const struct timespec& timestamp, size_t payload_length)
+{
+    if (header_version != DATA_MESSAGE_V1)
+    {
+        uint32_t fragment_le = htole32(fragment_number);
+        uint16_t payload_le = htole16(static_cast<uint16_t>(payload_length));
+        uint64_t timestamp_le = htole64(static_cast<uint64_t>(timestamp.tv_sec) * 1000000000ULL + static_cast<uint64_t>(timestamp.tv_nsec));
+        memcpy(header + DataMessageHeaderV2::FRAGMENT_NUMBER_OFFSET, &fragment_le, sizeof(fragment_le));
+        memcpy(header + DataMessageHeaderV2::PAYLOAD_LENGTH_OFFSET, &payload_le, sizeof(payload_le));
+        memcpy(header + DataMessageHeaderV2::TIMESTAMP_OFFSET, &timestamp_le, sizeof(timestamp_le));
+        return;
+    }
+
+    memcpy(header + FRAGMENT_NUMBER_OFFSET, &fragment_number, sizeof(fragment_number));
+    memcpy(header + TIMESTAMP_OFFSET, &timestamp, sizeof(timestamp));
+}
+
+
+/*
+*
+*/
+const char* DataMessageTemplate::data() const
+{
+    return header;
+}
+
+
+/*
+*
+*/
+size_t DataMessageTemplate::size() const
+{
+    return header_length;
+}
+
+
+/*
+*
+*/
+DataMessageVersion DataMessageTemplate::version() const
+{
+    return header_version;
+}
+
+
+/*
+*
+*/
+size_t DataMessageTemplate::max_payload() const
+{
+    return max_payload(header_version);
+}
+
+
+/*
+*
+*/
+size_t DataMessageTemplate::max_payload(DataMessageVersion version)
+{
+    if (version != DATA_MESSAGE_V1)
+    {
+        return HEADER_LENGTH + demonstrator::MAX_PROTOCOL_MESSAGE_LENGTH - DataMessageHeaderV2::HEADER_LENGTH;
+    }
+    return demonstrator::MAX_PROTOCOL_MESSAGE_LENGTH;
+}
+
+
+/*
+*
+*/
+void DataMessageTemplate::scatter(struct iovec* message_iovec, const char* payload, size_t payload_length) const
+{
+    message_iovec[0].iov_base = const_cast<char*>(header);
+    message_iovec[0].iov_len = header_length;
+    message_iovec[1].iov_base = const_cast<char*>(payload);
+    message_iovec[1].iov_len = payload_length;
+}
+
+
+// ----------------------------- DataMessageView -------------------------------------------------------------------
+/*
+*
+*/
+DataMessageView::DataMessageView()
+:
+    message(nullptr),
+    message_size(0),
+    header_valid(false),
+    header_version(DATA_MESSAGE_V1),
+    header_length(DataMessageTemplate::HEADER_LENGTH),
+    message_priority(0),
+    source(0),
+    service(0),
+    object(0),
+    fragment(0),
+    fragments(0),
+    service_mode(-1),
+    send_timestamp({0, 0})
+{
+
+}
+
+
+/*
+*
+*/
+bool DataMessageView::parse(const char* message, size_t size)
+{
+    this->message = message;
+    message_size = size;
+    header_valid = false;
+    if (message == nullptr)
+    {
+        return false;
+    }
+
+    if (size >= DataMessageHeaderV2::HEADER_LENGTH
+        && static_cast<uint8_t>(message[DataMessageHeaderV2::MARKER_OFFSET]) == DataMessageHeaderV2::MARKER
+        && (static_cast<uint8_t>(message[DataMessageHeaderV2::VERSION_OFFSET]) == DataMessageHeaderV2::VERSION
+            || static_cast<uint8_t>(message[DataMessageHeaderV2::VERSION_OFFSET]) == DataMessageHeaderV3::VERSION)
+        && static_cast<uint8_t>(message[DataMessageHeaderV2::HEADER_LENGTH_OFFSET]) == DataMessageHeaderV2::HEADER_LENGTH)
+    {
+        return parse_v2();
+    }
+
+    if (size < DataMessageTemplate::HEADER_LENGTH)
+    {
+        return false;
+    }
+
+    header_version = DATA_MESSAGE_V1;
+    header_length = DataMessageTemplate::HEADER_LENGTH;
+    message_priority = static_cast<uint8_t>(message[0]);
+    service_mode = -1;
+
+    // Unaligned fields, memcpy compiles to plain loads
+    memcpy(&source, message + SOURCE_ID_OFFSET, sizeof(source));
+    memcpy(&service, message + SERVICE_ID_OFFSET, sizeof(service));
+    memcpy(&object, message + OBJECT_NUMBER_OFFSET, sizeof(object));
+    memcpy(&fragment, message + DataMessageTemplate::FRAGMENT_NUMBER_OFFSET, sizeof(fragment));
+    memcpy(&fragments, message + TOTAL_FRAGMENTS_OFFSET, sizeof(fragments));
+    memcpy(&send_timestamp, message + DataMessageTemplate::TIMESTAMP_OFFSET, sizeof(send_timestamp));
+
+    header_valid = send_timestamp.tv_nsec >= 0 && send_timestamp.tv_nsec < 1000000000L;
+    return header_valid;
+}
+
+
+/*
+*
+*/
+bool DataMessageView::valid() const
+{
+    return header_valid;
+}
+
+
+/*
+*
+*/
+DataMessageVersion DataMessageView::version() const
+{
+    return header_version;
+}
+
+
+/*
+*
+*/
+uint8_t DataMessageView::priority() const
+{
+    return header_valid ? message_priority : 0;
+}
+
+
+/*
+*
+*/
+uint32_t DataMessageView::source_id() const
+{
+    return source;
+}
+
+
+/*
+*
+*/
+serviceID_t DataMessageView::service_id() const
+{
+    return service;
+}
+
+
+/*
+*
+*/
+uint32_t DataMessageView::object_number() const
+{
+    return object;
+}
+
+
+/*
+*
+*/
+uint32_t DataMessageView::fragment_number() const
+{
+    return fragment;
+}
+
+
+/*
+*
+*/
+uint32_t DataMessageView::total_fragments() const
+{
+    return fragments;
+}
+
+
+/*
+*
+*/
+int32_t DataMessageView::mode() const
+{
+    return service_mode;
+}
+
+
+/*
+*
+*/
+const struct timespec& DataMessageView::timestamp() const
+{
+    return send_timestamp;
+}
+
+
+/*
+*
+*/
+const char* DataMessageView::payload() const
+{
+    return header_valid ? message + header_length : nullptr;
+}
+
+
+/*
+*
+*/
+size_t DataMessageView::payload_length() const
+{
+    return header_valid ? message_size - header_length : 0;
+}
+
+
+/*------------------------------------- Private -----------------------------------------*/
+/*
+*
+*/
+bool DataMessageView::parse_v2()
+{
+    uint16_t payload_le;
+    uint16_t mode_le;
+    uint64_t timestamp_le;
+    memcpy(&payload_le, message + DataMessageHeaderV2::PAYLOAD_LENGTH_OFFSET, sizeof(payload_le));
+    // A truncated or padded datagram is not a message
+    if (le16toh(payload_le) != message_size - DataMessageHeaderV2::HEADER_LENGTH)
+    {
+        return false;
+    }
+
+    header_version = static_cast<DataMessageVersion>(static_cast<uint8_t>(message[DataMessageHeaderV2::VERSION_OFFSET]));
+    header_length = DataMessageHeaderV2::HEADER_LENGTH;
+    message_priority = static_cast<uint8_t>(message[DataMessageHeaderV2::PRIORITY_OFFSET]);
+
+    // Naturally aligned within the header, memcpy only because the receive buffer itself may not be
+    memcpy(&source, message + DataMessageHeaderV2::SOURCE_ID_OFFSET, sizeof(source));
+    memcpy(&service, message + DataMessageHeaderV2::SERVICE_ID_OFFSET, sizeof(service));
+    memcpy(&object, message + DataMessageHeaderV2::OBJECT_NUMBER_OFFSET, sizeof(object));
+    memcpy(&fragment, message + DataMessageHeaderV2::FRAGMENT_NUMBER_OFFSET, sizeof(fragment));
+    memcpy(&fragments, message + DataMessageHeaderV2::TOTAL_FRAGMENTS_OFFSET, sizeof(fragments));
+    memcpy(&mode_le, message + DataMessageHeaderV3::MODE_OFFSET, sizeof(mode_le));
+    memcpy(&timestamp_le, message + DataMessageHeaderV2::TIMESTAMP_OFFSET, sizeof(timestamp_le));
+    source = le32toh(source);
+    service = le64toh(service);
+    object = le32toh(object);
+    fragment = le32toh(fragment);
+    fragments = le32toh(fragments);
+    // The v2 field at the mode offset is reserved
+    service_mode = header_version == DATA_MESSAGE_V3 ? static_cast<int32_t>(le16toh(mode_le)) - 1 : -1;
+
+    uint64_t timestamp_ns = le64toh(timestamp_le);
+    send_timestamp.tv_sec = static_cast<time_t>(timestamp_ns / 1000000000ULL);
+    send_timestamp.tv_nsec = static_cast<long>(timestamp_ns % 1000000000ULL);
+
+    header_valid = true;
+    return header_valid;
+}
+
 // -------------------------------------------------------------------------------------------------------------------
\ No newline at end of file
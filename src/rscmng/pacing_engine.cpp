@@ -0,0 +1,265 @@
+// Copyright (C) 2025 IDA
+//
+// This file is part of a project licensed under the GNU Lesser General Public License v3.0.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+
+#include <cerrno>
+
+#include <rscmng/utils/pacing_engine.hpp>
+
+
+using namespace rscmng;
+
+
+/*
+*
+*/
+PacingEngine::PacingEngine(clockid_t clock_id, PacingStrategy strategy, std::chrono::microseconds spin_margin)
+:
+    clock_id(clock_id),
+    strategy(strategy),
+    spin_margin_ns(std::chrono::duration_cast<std::chrono::nanoseconds>(spin_margin).count()),
+    missed_deadline_count(0),
+    lateness_histogram()
+{
+
+}
+
+
+/*
+*
+*/
+int64_t PacingEngine::wait_until(const struct timespec& deadline)
+{
+    struct timespec time_now = now();
+
+    if (diff_ns(deadline, time_now) <= 0)
+    {
+        ++missed_deadline_count;
+        return record(deadline, time_now);
+    }
+
+    switch (strategy)
+    {
+        case PACING_BUSY_SPIN:
+            time_now = spin_until(deadline);
+            break;
+
+        case PACING_SLEEP:
+            sleep_until(deadline);
+            time_now = now();
+            break;
+
+        case PACING_SLEEP_SPIN:
+        default:
+            if (diff_ns(deadline, time_now) > spin_margin_ns)
+            {
+                sleep_until(add_ns(deadline, -spin_margin_ns));
+            }
+            time_now = spin_until(deadline);
+            break;
+    }
+
+    return record(deadline, time_now);
+}
+
+
+/*
+*
+*/
+int64_t PacingEngine::wait_until(const struct timespec& deadline, const std::function<bool()>& interrupted)
+{
+    struct timespec time_now = now();
+
+    if (diff_ns(deadline, time_now) <= 0)
+    {
+        ++missed_deadline_count;
+        return record(deadline, time_now);
+    }
+
+    int64_t spin_start_ns = (strategy == PACING_SLEEP_SPIN) ? spin_margin_ns : 0;
+
+    // Sleep in slices to be able to react on the interrupt predicate
+    if (strategy != PACING_BUSY_SPIN)
+    {
+        while (diff_ns(deadline, time_now) > spin_start_ns)
+        {
+            if (interrupted())
+            {
+                return diff_ns(time_now, deadline);
+            }
+
+            int64_t remaining_ns = diff_ns(deadline, time_now) - spin_start_ns;
+            sleep_until(add_ns(time_now, std::min(remaining_ns, max_sleep_slice_ns)));
+            time_now = now();
+        }
+    }
+
+    while (diff_ns(deadline, time_now) > 0)
+    {
+        if (interrupted())
+        {
+            return diff_ns(time_now, deadline);
+        }
+        time_now = now();
+    }
+
+    return record(deadline, time_now);
+}
+
+
+/*
+*
+*/
+int64_t PacingEngine::wait_for(std::chrono::nanoseconds duration)
+{
+    return wait_until(add_ns(now(), duration.count()));
+}
+
+
+/*
+*
+*/
+struct timespec PacingEngine::now() const
+{
+    struct timespec time_now = {0,0};
+    clock_gettime(clock_id, &time_now);
+    return time_now;
+}
+
+
+/*
+*
+*/
+void PacingEngine::set_strategy(PacingStrategy new_strategy)
+{
+    strategy = new_strategy;
+}
+
+
+/*
+*
+*/
+void PacingEngine::set_spin_margin(std::chrono::microseconds spin_margin)
+{
+    spin_margin_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(spin_margin).count();
+}
+
+
+/*
+*
+*/
+const LogLinearHistogram& PacingEngine::lateness() const
+{
+    return lateness_histogram;
+}
+
+
+/*
+*
+*/
+uint64_t PacingEngine::missed_deadlines() const
+{
+    return missed_deadline_count;
+}
+
+
+/*
+*
+*/
+void PacingEngine::print_statistics(std::string name) const
+{
+    lateness_histogram.print(name + " lateness");
+    RM_logInfo(name << " deadlines already passed on entry: " << missed_deadline_count)
+}
+
+
+/*
+*
+*/
+void PacingEngine::reset_statistics()
+{
+    lateness_histogram.reset();
+    missed_deadline_count = 0;
+}
+
+
+/*
+*
+*/
+struct timespec PacingEngine::add_ns(struct timespec timestamp, int64_t nanoseconds)
+{
+    int64_t total_ns = static_cast<int64_t>(timestamp.tv_nsec) + nanoseconds % 1000000000L;
+    timestamp.tv_sec += nanoseconds / 1000000000L;
+
+    if (total_ns >= 1000000000L)
+    {
+        timestamp.tv_sec += 1;
+        total_ns -= 1000000000L;
+    }
+    else if (total_ns < 0)
+    {
+        timestamp.tv_sec -= 1;
+        total_ns += 1000000000L;
+    }
+    timestamp.tv_nsec = total_ns;
+
+    return timestamp;
+}
+
+
+/*
+*
+*/
+int64_t PacingEngine::diff_ns(const struct timespec& a, const struct timespec& b)
+{
+    return (static_cast<int64_t>(a.tv_sec) - b.tv_sec) * 1000000000L + (static_cast<int64_t>(a.tv_nsec) - b.tv_nsec);
+}
+
+
+/*------------------------------------- Private -----------------------------------------*/
+/*
+*
+*/
+void PacingEngine::sleep_until(const struct timespec& deadline)
+{
+    while (clock_nanosleep(clock_id, TIMER_ABSTIME, &deadline, nullptr) == EINTR);
+}
+
+
+/*
+*
+*/
+struct timespec PacingEngine::spin_until(const struct timespec& deadline)
+{
+    struct timespec time_now = now();
+    while (diff_ns(deadline, time_now) > 0)
+    {
+        time_now = now();
+    }
+    return time_now;
+}
+
+
+/*
+*
+*/
+int64_t PacingEngine::record(const struct timespec& deadline, const struct timespec& wakeup)
+{
+    int64_t lateness_ns = diff_ns(wakeup, deadline);
+    lateness_histogram.record(lateness_ns > 0 ? static_cast<uint64_t>(lateness_ns) : 0);
+    return lateness_ns;
+}
@@ -0,0 +1,222 @@
+// Copyright (C) 2025 IDA
+//
+// This file is part of a project licensed under the GNU Lesser General Public License v3.0.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+
+#include <cstring>
+#include <cstdlib>
+#include <cerrno>
+#include <sstream>
+
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include <alloca.h>
+#include <malloc.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+
+#include <rscmng/utils/realtime_profile.hpp>
+
+
+using namespace rscmng;
+
+
+/*
+*
+*/
+RealtimeProfile& RealtimeProfile::instance()
+{
+    static RealtimeProfile process_profile;
+    return process_profile;
+}
+
+
+/*
+*
+*/
+void RealtimeProfile::configure(const struct rscmng::config::realtime_profile_settings& settings)
+{
+    profile = settings;
+    log_page_faults("Realtime profile before prefault", false);
+
+    if (profile.prefault_heap_kb > 0)
+    {
+        // Freed memory stays in the heap, so the prefaulted pages are reused instead of faulted again
+        mallopt(M_TRIM_THRESHOLD, -1);
+        mallopt(M_MMAP_MAX, 0);
+        size_t heap_size = static_cast<size_t>(profile.prefault_heap_kb) * 1024;
+        void* heap_reserve = malloc(heap_size);
+        if (heap_reserve != nullptr)
+        {
+            prefault(heap_reserve, heap_size);
+            free(heap_reserve);
+        }
+    }
+
+    if (profile.lock_memory && !memory_locked)
+    {
+        // Current and future mappings (buffers, thread stacks, payload sources) are faulted in when mapped
+        if (mlockall(MCL_CURRENT | MCL_FUTURE) == 0)
+        {
+            memory_locked = true;
+        }
+        else
+        {
+            RM_logWarning("Realtime profile mlockall failed: " << strerror(errno))
+        }
+    }
+
+    RM_logInfo("Realtime profile memory " << (memory_locked ? "locked" : "not locked") << ", heap prefault " << profile.prefault_heap_kb << " KB")
+    log_page_faults("Realtime profile after prefault", false);
+}
+
+
+/*
+*
+*/
+bool RealtimeProfile::apply(const std::string& thread_name, int32_t cpu_index) const
+{
+    bool applied = true;
+    pthread_setname_np(pthread_self(), thread_name.substr(0, 15).c_str());
+
+    if (profile.prefault_stack_kb > 0)
+    {
+        size_t stack_size = static_cast<size_t>(profile.prefault_stack_kb) * 1024;
+        prefault(alloca(stack_size), stack_size);
+    }
+
+    auto thread_iterator = profile.threads.find(thread_name);
+    if (thread_iterator == profile.threads.end())
+    {
+        return applied;
+    }
+    const struct rscmng::config::realtime_thread_settings& thread_settings = thread_iterator->second;
+
+    if (!thread_settings.cpus.empty())
+    {
+        cpu_set_t cpu_set;
+        CPU_ZERO(&cpu_set);
+        if (cpu_index >= 0)
+        {
+            CPU_SET(thread_settings.cpus[static_cast<size_t>(cpu_index) % thread_settings.cpus.size()], &cpu_set);
+        }
+        else
+        {
+            for (const auto& cpu : thread_settings.cpus)
+            {
+                CPU_SET(cpu, &cpu_set);
+            }
+        }
+        int result = pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set);
+        if (result != 0)
+        {
+            RM_logWarning("Realtime profile thread " << thread_name << " affinity not set: " << strerror(result))
+            applied = false;
+        }
+    }
+
+    if (thread_settings.priority > 0)
+    {
+        struct sched_param scheduling_parameter;
+        memset(&scheduling_parameter, 0, sizeof(scheduling_parameter));
+        scheduling_parameter.sched_priority = thread_settings.priority;
+        int result = pthread_setschedparam(pthread_self(), SCHED_FIFO, &scheduling_parameter);
+        if (result != 0)
+        {
+            RM_logWarning("Realtime profile thread " << thread_name << " SCHED_FIFO " << thread_settings.priority << " not set: " << strerror(result))
+            applied = false;
+        }
+    }
+
+    log_thread_settings(thread_name);
+    return applied;
+}
+
+
+/*
+*
+*/
+void RealtimeProfile::prefault(void* data, size_t size)
+{
+    static const size_t page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    volatile char* bytes = static_cast<volatile char*>(data);
+    for (size_t offset = 0; offset < size; offset += page_size)
+    {
+        bytes[offset] = bytes[offset];
+    }
+    if (size > 0)
+    {
+        bytes[size - 1] = bytes[size - 1];
+    }
+}
+
+
+/*
+*
+*/
+void RealtimeProfile::log_page_faults(const std::string& label, bool calling_thread)
+{
+    struct rusage usage;
+    if (getrusage(calling_thread ? RUSAGE_THREAD : RUSAGE_SELF, &usage) != 0)
+    {
+        return;
+    }
+    RM_logInfo(label << " page faults: " << usage.ru_minflt << " minor, " << usage.ru_majflt << " major")
+}
+
+
+/*------------------------------------- Private -----------------------------------------*/
+/*
+*
+*/
+RealtimeProfile::RealtimeProfile()
+:
+    profile(),
+    memory_locked(false)
+{
+
+}
+
+
+/*
+*
+*/
+void RealtimeProfile::log_thread_settings(const std::string& thread_name)
+{
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    std::ostringstream cpus;
+    if (pthread_getaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set) == 0)
+    {
+        for (int cpu = 0; cpu < CPU_SETSIZE; cpu++)
+        {
+            if (CPU_ISSET(cpu, &cpu_set))
+            {
+                cpus << cpu << " ";
+            }
+        }
+    }
+
+    int policy = SCHED_OTHER;
+    struct sched_param scheduling_parameter;
+    memset(&scheduling_parameter, 0, sizeof(scheduling_parameter));
+    pthread_getschedparam(pthread_self(), &policy, &scheduling_parameter);
+
+    RM_logInfo("Realtime profile thread " << thread_name << " runs on CPUs " << cpus.str()
+        << (policy == SCHED_FIFO ? "SCHED_FIFO " : "SCHED_OTHER ") << scheduling_parameter.sched_priority)
+    log_page_faults("Realtime profile thread " + thread_name, true);
+}
@@ -0,0 +1,188 @@
+// Copyright (C) 2025 IDA
+//
+// This file is part of a project licensed under the GNU Lesser General Public License v3.0.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+
+#include <cerrno>
+#include <algorithm>
+
+#include <arpa/inet.h>
+
+#include <rscmng/sink/batch_receiver.hpp>
+#include <rscmng/utils/realtime_profile.hpp>
+
+
+using namespace traffic_statistic;
+
+
+// Largest super packet the kernel coalesces with GRO
+#define GRO_MAX_SUPER_PACKET 65535
+// Control message space per slot (GRO segment size and receive timestamp)
+#define BATCH_RECEIVER_CONTROL_SIZE (CMSG_SPACE(sizeof(int)) + RX_TIMESTAMP_CONTROL_SIZE)
+
+
+/*
+*
+*/
+BatchReceiver::BatchReceiver(int socket_fd, uint32_t batch_size, size_t datagram_size, bool gro)
+:
+    socket_fd(socket_fd),
+    batch_size(batch_size > 0 ? batch_size : 1),
+    slot_size(datagram_size),
+    gro_active(false),
+    syscall_count(0),
+    datagram_count(0),
+    super_packet_count(0),
+    error_count(0)
+{
+    if (gro)
+    {
+        int enable = 1;
+        gro_active = setsockopt(socket_fd, SOL_UDP, UDP_GRO, &enable, sizeof(enable)) == 0;
+        if (gro_active)
+        {
+            slot_size = GRO_MAX_SUPER_PACKET;
+        }
+        else
+        {
+            RM_logWarning("Batch receiver UDP_GRO not supported (" << strerror(errno) << "), receiving single datagrams")
+        }
+    }
+
+    slot_buffer.resize(this->batch_size * slot_size);
+    slot_control.resize(this->batch_size * BATCH_RECEIVER_CONTROL_SIZE);
+    slot_iovec.resize(this->batch_size);
+    slot_source.resize(this->batch_size);
+    slot_header.resize(this->batch_size);
+    // Split super packets append further entries, reserve for a typical number of segments
+    datagrams.reserve(this->batch_size * (gro_active ? 64 : 1));
+    rscmng::RealtimeProfile::prefault(slot_buffer.data(), slot_buffer.size());
+
+    for (uint32_t slot = 0; slot < this->batch_size; ++slot)
+    {
+        slot_iovec[slot].iov_base = slot_buffer.data() + slot * slot_size;
+        slot_iovec[slot].iov_len = slot_size;
+
+        memset(&slot_header[slot], 0, sizeof(struct mmsghdr));
+        slot_header[slot].msg_hdr.msg_name = &slot_source[slot];
+        slot_header[slot].msg_hdr.msg_iov = &slot_iovec[slot];
+        slot_header[slot].msg_hdr.msg_iovlen = 1;
+    }
+}
+
+
+/*
+*
+*/
+uint32_t BatchReceiver::receive()
+{
+    // The kernel overwrites name and control lengths on return
+    for (uint32_t slot = 0; slot < batch_size; ++slot)
+    {
+        slot_header[slot].msg_hdr.msg_namelen = sizeof(struct sockaddr_in);
+        slot_header[slot].msg_hdr.msg_control = slot_control.data() + slot * BATCH_RECEIVER_CONTROL_SIZE;
+        slot_header[slot].msg_hdr.msg_controllen = BATCH_RECEIVER_CONTROL_SIZE;
+    }
+
+    int received = -1;
+    do
+    {
+        received = recvmmsg(socket_fd, slot_header.data(), batch_size, MSG_WAITFORONE, nullptr);
+        ++syscall_count;
+    }
+    while (received < 0 && errno == EINTR);
+
+    datagrams.clear();
+    if (received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+    {
+        // Drained non-blocking socket
+        return 0;
+    }
+    if (received < 0)
+    {
+        ++error_count;
+        RM_logError("Batch receiver recvmmsg failed: " << strerror(errno))
+        return 0;
+    }
+
+    for (int slot = 0; slot < received; ++slot)
+    {
+        const struct msghdr& message = slot_header[slot].msg_hdr;
+        const char* data = static_cast<const char*>(message.msg_iov[0].iov_base);
+        size_t length = slot_header[slot].msg_len;
+
+        size_t segment_size = length;
+        for (struct cmsghdr* control = CMSG_FIRSTHDR(&message); control != nullptr; control = CMSG_NXTHDR(const_cast<struct msghdr*>(&message), control))
+        {
+            if (control->cmsg_level == SOL_UDP && control->cmsg_type == UDP_GRO)
+            {
+                int gso_size = 0;
+                memcpy(&gso_size, CMSG_DATA(control), sizeof(gso_size));
+                if (gso_size > 0)
+                {
+                    segment_size = static_cast<size_t>(gso_size);
+                }
+            }
+        }
+        if (segment_size < length)
+        {
+            ++super_packet_count;
+        }
+
+        struct received_datagram datagram;
+        datagram.kernel_timestamped = read_rx_timestamp(message, datagram.kernel_timestamp);
+        datagram.source_address = ntohl(slot_source[slot].sin_addr.s_addr);
+        datagram.source_port = ntohs(slot_source[slot].sin_port);
+        // All segments of a super packet have the segment size, except the last one
+        for (size_t offset = 0; offset < length; offset += segment_size)
+        {
+            datagram.data = data + offset;
+            datagram.length = std::min(segment_size, length - offset);
+            datagrams.push_back(datagram);
+        }
+    }
+
+    datagram_count += datagrams.size();
+    return static_cast<uint32_t>(datagrams.size());
+}
+
+
+/*
+*
+*/
+const struct received_datagram& BatchReceiver::datagram(uint32_t index) const
+{
+    return datagrams[index];
+}
+
+
+/*
+*
+*/
+bool BatchReceiver::gro_enabled() const
+{
+    return gro_active;
+}
+
+
+/*
+*
+*/
+void BatchReceiver::print_statistics(std::string name) const
+{
+    RM_logInfo(name << " syscalls: " << syscall_count << " datagrams: " << datagram_count << " GRO super packets: " << super_packet_count
+        << " errors: " << error_count << " datagrams per syscall: " << (syscall_count > 0 ? static_cast<double>(datagram_count) / syscall_count : 0.0))
+}
@@ -0,0 +1,231 @@
+// Copyright (C) 2025 IDA
+//
+// This file is part of a project licensed under the GNU Lesser General Public License v3.0.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+
+#include <cerrno>
+#include <cstring>
+#include <algorithm>
+
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+
+#include <rscmng/sink/event_loop.hpp>
+#include <rscmng/utils/realtime_profile.hpp>
+
+
+using namespace traffic_statistic;
+
+
+/*
+*
+*/
+SinkEventLoop::SinkEventLoop(uint32_t thread_count)
+:
+    active(true),
+    stop_fd(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC))
+{
+    if (thread_count == 0)
+    {
+        thread_count = std::max(1U, std::thread::hardware_concurrency() / 4);
+    }
+    if (stop_fd < 0)
+    {
+        RM_logError("Sink event loop eventfd failed: " << strerror(errno))
+    }
+
+    for (uint32_t index = 0; index < thread_count; ++index)
+    {
+        std::unique_ptr<struct event_thread> loop(new struct event_thread());
+        loop->socket_count = 0;
+        loop->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+        if (loop->epoll_fd < 0)
+        {
+            RM_logError("Sink event loop epoll_create1 failed: " << strerror(errno))
+            continue;
+        }
+
+        struct epoll_event stop_event;
+        memset(&stop_event, 0, sizeof(stop_event));
+        stop_event.events = EPOLLIN;
+        stop_event.data.ptr = nullptr;
+        epoll_ctl(loop->epoll_fd, EPOLL_CTL_ADD, stop_fd, &stop_event);
+
+        loops.push_back(std::move(loop));
+    }
+
+    for (auto& loop : loops)
+    {
+        loop->thread = std::thread(&SinkEventLoop::run, this, std::ref(*loop));
+    }
+    RM_logInfo("Sink event loop started with " << loops.size() << " threads")
+}
+
+
+/*
+*
+*/
+SinkEventLoop::~SinkEventLoop()
+{
+    stop();
+    for (auto& loop : loops)
+    {
+        close(loop->epoll_fd);
+    }
+    if (stop_fd >= 0)
+    {
+        close(stop_fd);
+    }
+}
+
+
+/*
+*
+*/
+bool SinkEventLoop::add(int socket_fd, std::function<void()> on_readable)
+{
+    std::lock_guard<std::mutex> lock(loop_mutex);
+    if (loops.empty())
+    {
+        return false;
+    }
+
+    std::unique_ptr<struct event_handler> handler(new struct event_handler());
+    handler->socket_fd = socket_fd;
+    handler->on_readable = on_readable;
+    handler->removed = false;
+
+    auto loop = std::min_element(loops.begin(), loops.end(), [](const std::unique_ptr<struct event_thread>& first, const std::unique_ptr<struct event_thread>& second)
+    {
+        return first->socket_count < second->socket_count;
+    });
+
+    struct epoll_event socket_event;
+    memset(&socket_event, 0, sizeof(socket_event));
+    socket_event.events = EPOLLIN;
+    socket_event.data.ptr = handler.get();
+    if (epoll_ctl((*loop)->epoll_fd, EPOLL_CTL_ADD, socket_fd, &socket_event) < 0)
+    {
+        RM_logError("Sink event loop epoll_ctl failed: " << strerror(errno))
+        return false;
+    }
+
+    handler->loop = loop->get();
+    (*loop)->socket_count++;
+    handlers.push_back(std::move(handler));
+    return true;
+}
+
+
+/*
+*
+*/
+void SinkEventLoop::remove(int socket_fd)
+{
+    std::lock_guard<std::mutex> lock(loop_mutex);
+    for (auto& handler : handlers)
+    {
+        if (handler->socket_fd != socket_fd || handler->removed)
+        {
+            continue;
+        }
+        if (epoll_ctl(handler->loop->epoll_fd, EPOLL_CTL_DEL, socket_fd, nullptr) < 0)
+        {
+            RM_logError("Sink event loop epoll_ctl delete failed: " << strerror(errno))
+        }
+        // Waits for a running dispatch, events returned before the delete are skipped
+        std::lock_guard<std::mutex> dispatch_lock(handler->loop->dispatch_mutex);
+        handler->removed = true;
+        handler->loop->socket_count--;
+        return;
+    }
+}
+
+
+/*
+*
+*/
+uint32_t SinkEventLoop::thread_count() const
+{
+    return static_cast<uint32_t>(loops.size());
+}
+
+
+/*
+*
+*/
+void SinkEventLoop::join()
+{
+    for (auto& loop : loops)
+    {
+        if (loop->thread.joinable())
+        {
+            loop->thread.join();
+        }
+    }
+}
+
+
+/*
+*
+*/
+void SinkEventLoop::stop()
+{
+    active = false;
+    uint64_t wakeup = 1;
+    if (stop_fd >= 0 && write(stop_fd, &wakeup, sizeof(wakeup)) < 0 && errno != EAGAIN)
+    {
+        RM_logError("Sink event loop stop failed: " << strerror(errno))
+    }
+    join();
+}
+
+
+/*------------------------------------- Private -----------------------------------------*/
+/*
+*
+*/
+void SinkEventLoop::run(struct event_thread& loop)
+{
+    rscmng::RealtimeProfile::instance().apply(RT_THREAD_SINK);
+    struct epoll_event events[SINK_EVENT_MAX_EVENTS];
+
+    while (active)
+    {
+        int ready = epoll_wait(loop.epoll_fd, events, SINK_EVENT_MAX_EVENTS, -1);
+        if (ready < 0)
+        {
+            if (errno != EINTR)
+            {
+                RM_logError("Sink event loop epoll_wait failed: " << strerror(errno))
+                return;
+            }
+            continue;
+        }
+
+        std::lock_guard<std::mutex> dispatch_lock(loop.dispatch_mutex);
+        for (int index = 0; index < ready && active; ++index)
+        {
+            // The stop eventfd is registered without handler and stays readable once written
+            struct event_handler* handler = static_cast<struct event_handler*>(events[index].data.ptr);
+            if (handler != nullptr && !handler->removed)
+            {
+                handler->on_readable();
+            }
+        }
+    }
+}
@@ -0,0 +1,354 @@
+// Copyright (C) 2025 IDA
+//
+// This file is part of a project licensed under the GNU Lesser General Public License v3.0.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#include <algorithm>
+
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+
+#include <rscmng/messages.hpp>
+#include <rscmng/sink/kernel_counter.hpp>
+
+
+using namespace traffic_statistic;
+
+
+/*
+*
+*/
+KernelServiceCounter::KernelServiceCounter(int socket_fd)
+:
+    socket_fd(socket_fd),
+    map_fd(-1),
+    program_fd(-1),
+    cpu_count(possible_cpus())
+{
+    union bpf_attr map_attributes;
+    memset(&map_attributes, 0, sizeof(map_attributes));
+    map_attributes.map_type = BPF_MAP_TYPE_PERCPU_HASH;
+    map_attributes.key_size = sizeof(uint64_t);
+    map_attributes.value_size = sizeof(struct kernel_service_counters);
+    // One entry more for the rejected datagrams
+    map_attributes.max_entries = KERNEL_COUNTER_MAX_SERVICES + 1;
+    map_fd = static_cast<int>(bpf_call(BPF_MAP_CREATE, map_attributes));
+    if (map_fd < 0)
+    {
+        RM_logWarning("Kernel counter map not created: " << strerror(errno))
+        return;
+    }
+
+    std::vector<struct bpf_insn> instructions = program();
+    std::vector<char> verifier_log(65536, 0);
+    union bpf_attr program_attributes;
+    memset(&program_attributes, 0, sizeof(program_attributes));
+    program_attributes.prog_type = BPF_PROG_TYPE_SOCKET_FILTER;
+    program_attributes.insns = reinterpret_cast<uint64_t>(instructions.data());
+    program_attributes.insn_cnt = static_cast<uint32_t>(instructions.size());
+    program_attributes.license = reinterpret_cast<uint64_t>("GPL");
+    program_attributes.log_buf = reinterpret_cast<uint64_t>(verifier_log.data());
+    program_attributes.log_size = static_cast<uint32_t>(verifier_log.size());
+    program_attributes.log_level = 1;
+    program_fd = static_cast<int>(bpf_call(BPF_PROG_LOAD, program_attributes));
+    if (program_fd < 0)
+    {
+        RM_logWarning("Kernel counter program not loaded: " << strerror(errno) << " " << verifier_log.data())
+        return;
+    }
+
+    if (setsockopt(socket_fd, SOL_SOCKET, SO_ATTACH_BPF, &program_fd, sizeof(program_fd)) < 0)
+    {
+        RM_logWarning("Kernel counter program not attached: " << strerror(errno))
+        close(program_fd);
+        program_fd = -1;
+    }
+}
+
+
+/*
+*
+*/
+KernelServiceCounter::~KernelServiceCounter()
+{
+    if (program_fd >= 0)
+    {
+        // The socket may outlive the counter, datagrams are delivered to user space again
+        setsockopt(socket_fd, SOL_SOCKET, SO_DETACH_BPF, &program_fd, sizeof(program_fd));
+        close(program_fd);
+    }
+    if (map_fd >= 0)
+    {
+        close(map_fd);
+    }
+}
+
+
+/*
+*
+*/
+bool KernelServiceCounter::valid() const
+{
+    return program_fd >= 0;
+}
+
+
+/*
+*
+*/
+std::map<uint64_t, struct kernel_service_counters> KernelServiceCounter::snapshot() const
+{
+    std::map<uint64_t, struct kernel_service_counters> services;
+    if (map_fd < 0)
+    {
+        return services;
+    }
+
+    // Per CPU values are returned for every possible CPU, each rounded up to 8 bytes
+    std::vector<struct kernel_service_counters> cpu_values(cpu_count);
+    uint64_t key = 0;
+    uint64_t next_key = 0;
+    bool first = true;
+    while (true)
+    {
+        union bpf_attr next_attributes;
+        memset(&next_attributes, 0, sizeof(next_attributes));
+        next_attributes.map_fd = static_cast<uint32_t>(map_fd);
+        next_attributes.key = first ? 0 : reinterpret_cast<uint64_t>(&key);
+        next_attributes.next_key = reinterpret_cast<uint64_t>(&next_key);
+        if (bpf_call(BPF_MAP_GET_NEXT_KEY, next_attributes) < 0)
+        {
+            break;
+        }
+        first = false;
+        key = next_key;
+
+        union bpf_attr lookup_attributes;
+        memset(&lookup_attributes, 0, sizeof(lookup_attributes));
+        lookup_attributes.map_fd = static_cast<uint32_t>(map_fd);
+        lookup_attributes.key = reinterpret_cast<uint64_t>(&key);
+        lookup_attributes.value = reinterpret_cast<uint64_t>(cpu_values.data());
+        if (bpf_call(BPF_MAP_LOOKUP_ELEM, lookup_attributes) < 0)
+        {
+            continue;
+        }
+
+        struct kernel_service_counters sum;
+        memset(&sum, 0, sizeof(sum));
+        for (const auto& value : cpu_values)
+        {
+            sum.packets += value.packets;
+            sum.bytes += value.bytes;
+            sum.first_fragments += value.first_fragments;
+            // Fragments of one object may be counted on several CPUs, the newest object wins
+            if (value.packets > 0 && (sum.packets == value.packets || value.last_object > sum.last_object
+                || (value.last_object == sum.last_object && value.last_fragment > sum.last_fragment)))
+            {
+                sum.last_object = value.last_object;
+                sum.last_fragment = value.last_fragment;
+            }
+        }
+        services[key] = sum;
+    }
+    return services;
+}
+
+
+/*
+*
+*/
+void KernelServiceCounter::print(std::string name) const
+{
+    for (const auto& service : snapshot())
+    {
+        if (service.first == KERNEL_COUNTER_REJECTED_KEY)
+        {
+            RM_logInfo(name << " kernel rejected datagrams without data message header: " << service.second.packets
+                << " bytes: " << service.second.bytes)
+            continue;
+        }
+        RM_logInfo(name << " service " << service.first << " kernel counted fragments: " << service.second.packets
+            << " bytes: " << service.second.bytes << " objects started: " << service.second.first_fragments
+            << " last object: " << service.second.last_object << " fragment: " << service.second.last_fragment)
+    }
+}
+
+
+/*------------------------------------- Private -----------------------------------------*/
+/*
+*
+*/
+std::vector<struct bpf_insn> KernelServiceCounter::program() const
+{
+    const int32_t v1_service_offset = KERNEL_COUNTER_PAYLOAD_OFFSET + rscmng::DataMessageView::SERVICE_ID_OFFSET;
+    const int32_t v1_object_offset = KERNEL_COUNTER_PAYLOAD_OFFSET + rscmng::DataMessageView::OBJECT_NUMBER_OFFSET;
+    const int32_t v2_service_offset = KERNEL_COUNTER_PAYLOAD_OFFSET + rscmng::DataMessageHeaderV2::SERVICE_ID_OFFSET;
+    const int32_t v2_object_offset = KERNEL_COUNTER_PAYLOAD_OFFSET + rscmng::DataMessageHeaderV2::OBJECT_NUMBER_OFFSET;
+    const int32_t map = map_fd;
+
+    // r6 context, r7 service id offset (0 for datagrams that are no data message), r8 object number offset
+    // (fragment number follows in all formats), r9 datagram length including the UDP header,
+    // stack: -8 service id, -16 object number, -12 fragment number, -48 zeroed value of a new service.
+    // Fields are host byte order in v1 and little endian in v2/v3, the program assumes a little endian host.
+    std::vector<struct bpf_insn> code =
+    {
+        /*  0 */ instruction(BPF_ALU64 | BPF_MOV | BPF_X, BPF_REG_6, BPF_REG_1, 0, 0),
+        /*  1 */ instruction(BPF_LDX | BPF_MEM | BPF_W, BPF_REG_9, BPF_REG_6, offsetof(struct __sk_buff, len), 0),
+        // v2/v3 header: long enough, marker, version and header length as in DataMessageView::parse
+        /*  2 */ instruction(BPF_JMP | BPF_JLT | BPF_K, BPF_REG_9, 0, 10, KERNEL_COUNTER_PAYLOAD_OFFSET + rscmng::DataMessageHeaderV2::HEADER_LENGTH),
+        /*  3 */ instruction(BPF_LD | BPF_ABS | BPF_B, 0, 0, 0, KERNEL_COUNTER_PAYLOAD_OFFSET + rscmng::DataMessageHeaderV2::MARKER_OFFSET),
+        /*  4 */ instruction(BPF_JMP | BPF_JNE | BPF_K, BPF_REG_0, 0, 8, rscmng::DataMessageHeaderV2::MARKER),
+        /*  5 */ instruction(BPF_LD | BPF_ABS | BPF_B, 0, 0, 0, KERNEL_COUNTER_PAYLOAD_OFFSET + rscmng::DataMessageHeaderV2::VERSION_OFFSET),
+        /*  6 */ instruction(BPF_JMP | BPF_JEQ | BPF_K, BPF_REG_0, 0, 1, rscmng::DataMessageHeaderV2::VERSION),
+        /*  7 */ instruction(BPF_JMP | BPF_JNE | BPF_K, BPF_REG_0, 0, 5, rscmng::DataMessageHeaderV3::VERSION),
+        /*  8 */ instruction(BPF_LD | BPF_ABS | BPF_B, 0, 0, 0, KERNEL_COUNTER_PAYLOAD_OFFSET + rscmng::DataMessageHeaderV2::HEADER_LENGTH_OFFSET),
+        /*  9 */ instruction(BPF_JMP | BPF_JNE | BPF_K, BPF_REG_0, 0, 3, rscmng::DataMessageHeaderV2::HEADER_LENGTH),
+        /* 10 */ instruction(BPF_ALU64 | BPF_MOV | BPF_K, BPF_REG_7, 0, 0, v2_service_offset),
+        /* 11 */ instruction(BPF_ALU64 | BPF_MOV | BPF_K, BPF_REG_8, 0, 0, v2_object_offset),
+        /* 12 */ instruction(BPF_JMP | BPF_JA, 0, 0, 7, 0),
+        // v1 header, any other datagram long enough for it
+        /* 13 */ instruction(BPF_JMP | BPF_JLT | BPF_K, BPF_REG_9, 0, 3, KERNEL_COUNTER_PAYLOAD_OFFSET + rscmng::DataMessageTemplate::HEADER_LENGTH),
+        /* 14 */ instruction(BPF_ALU64 | BPF_MOV | BPF_K, BPF_REG_7, 0, 0, v1_service_offset),
+        /* 15 */ instruction(BPF_ALU64 | BPF_MOV | BPF_K, BPF_REG_8, 0, 0, v1_object_offset),
+        /* 16 */ instruction(BPF_JMP | BPF_JA, 0, 0, 3, 0),
+        // No data message, counted under the rejected key without object tracking
+        /* 17 */ instruction(BPF_ALU64 | BPF_MOV | BPF_K, BPF_REG_7, 0, 0, 0),
+        /* 18 */ instruction(BPF_ST | BPF_MEM | BPF_DW, BPF_REG_10, 0, -8, -1),
+        /* 19 */ instruction(BPF_JMP | BPF_JA, 0, 0, 14, 0),
+        // Service id to -8
+        /* 20 */ instruction(BPF_ALU64 | BPF_MOV | BPF_X, BPF_REG_1, BPF_REG_6, 0, 0),
+        /* 21 */ instruction(BPF_ALU64 | BPF_MOV | BPF_X, BPF_REG_2, BPF_REG_7, 0, 0),
+        /* 22 */ instruction(BPF_ALU64 | BPF_MOV | BPF_X, BPF_REG_3, BPF_REG_10, 0, 0),
+        /* 23 */ instruction(BPF_ALU64 | BPF_ADD | BPF_K, BPF_REG_3, 0, 0, -8),
+        /* 24 */ instruction(BPF_ALU64 | BPF_MOV | BPF_K, BPF_REG_4, 0, 0, sizeof(uint64_t)),
+        /* 25 */ instruction(BPF_JMP | BPF_CALL, 0, 0, 0, BPF_FUNC_skb_load_bytes),
+        /* 26 */ instruction(BPF_JMP | BPF_JNE | BPF_K, BPF_REG_0, 0, 46, 0),
+        // Object and fragment number to -16
+        /* 27 */ instruction(BPF_ALU64 | BPF_MOV | BPF_X, BPF_REG_1, BPF_REG_6, 0, 0),
+        /* 28 */ instruction(BPF_ALU64 | BPF_MOV | BPF_X, BPF_REG_2, BPF_REG_8, 0, 0),
+        /* 29 */ instruction(BPF_ALU64 | BPF_MOV | BPF_X, BPF_REG_3, BPF_REG_10, 0, 0),
+        /* 30 */ instruction(BPF_ALU64 | BPF_ADD | BPF_K, BPF_REG_3, 0, 0, -16),
+        /* 31 */ instruction(BPF_ALU64 | BPF_MOV | BPF_K, BPF_REG_4, 0, 0, 2 * sizeof(uint32_t)),
+        /* 32 */ instruction(BPF_JMP | BPF_CALL, 0, 0, 0, BPF_FUNC_skb_load_bytes),
+        /* 33 */ instruction(BPF_JMP | BPF_JNE | BPF_K, BPF_REG_0, 0, 39, 0),
+        // Counters of the service on this CPU
+        /* 34 */ instruction(BPF_LD | BPF_DW | BPF_IMM, BPF_REG_1, BPF_PSEUDO_MAP_FD, 0, map),
+        /* 35 */ instruction(0, 0, 0, 0, 0),
+        /* 36 */ instruction(BPF_ALU64 | BPF_MOV | BPF_X, BPF_REG_2, BPF_REG_10, 0, 0),
+        /* 37 */ instruction(BPF_ALU64 | BPF_ADD | BPF_K, BPF_REG_2, 0, 0, -8),
+        /* 38 */ instruction(BPF_JMP | BPF_CALL, 0, 0, 0, BPF_FUNC_map_lookup_elem),
+        /* 39 */ instruction(BPF_JMP | BPF_JNE | BPF_K, BPF_REG_0, 0, 18, 0),
+        // First datagram of the service, insert zeroed counters unless another CPU was faster
+        /* 40 */ instruction(BPF_ST | BPF_MEM | BPF_DW, BPF_REG_10, 0, -48, 0),
+        /* 41 */ instruction(BPF_ST | BPF_MEM | BPF_DW, BPF_REG_10, 0, -40, 0),
+        /* 42 */ instruction(BPF_ST | BPF_MEM | BPF_DW, BPF_REG_10, 0, -32, 0),
+        /* 43 */ instruction(BPF_ST | BPF_MEM | BPF_DW, BPF_REG_10, 0, -24, 0),
+        /* 44 */ instruction(BPF_LD | BPF_DW | BPF_IMM, BPF_REG_1, BPF_PSEUDO_MAP_FD, 0, map),
+        /* 45 */ instruction(0, 0, 0, 0, 0),
+        /* 46 */ instruction(BPF_ALU64 | BPF_MOV | BPF_X, BPF_REG_2, BPF_REG_10, 0, 0),
+        /* 47 */ instruction(BPF_ALU64 | BPF_ADD | BPF_K, BPF_REG_2, 0, 0, -8),
+        /* 48 */ instruction(BPF_ALU64 | BPF_MOV | BPF_X, BPF_REG_3, BPF_REG_10, 0, 0),
+        /* 49 */ instruction(BPF_ALU64 | BPF_ADD | BPF_K, BPF_REG_3, 0, 0, -48),
+        /* 50 */ instruction(BPF_ALU64 | BPF_MOV | BPF_K, BPF_REG_4, 0, 0, BPF_NOEXIST),
+        /* 51 */ instruction(BPF_JMP | BPF_CALL, 0, 0, 0, BPF_FUNC_map_update_elem),
+        /* 52 */ instruction(BPF_LD | BPF_DW | BPF_IMM, BPF_REG_1, BPF_PSEUDO_MAP_FD, 0, map),
+        /* 53 */ instruction(0, 0, 0, 0, 0),
+        /* 54 */ instruction(BPF_ALU64 | BPF_MOV | BPF_X, BPF_REG_2, BPF_REG_10, 0, 0),
+        /* 55 */ instruction(BPF_ALU64 | BPF_ADD | BPF_K, BPF_REG_2, 0, 0, -8),
+        /* 56 */ instruction(BPF_JMP | BPF_CALL, 0, 0, 0, BPF_FUNC_map_lookup_elem),
+        /* 57 */ instruction(BPF_JMP | BPF_JEQ | BPF_K, BPF_REG_0, 0, 15, 0),
+        // packets += 1, bytes += UDP payload
+        /* 58 */ instruction(BPF_ALU64 | BPF_MOV | BPF_K, BPF_REG_1, 0, 0, 1),
+        /* 59 */ instruction(BPF_STX | BPF_ATOMIC | BPF_DW, BPF_REG_0, BPF_REG_1, offsetof(struct kernel_service_counters, packets), BPF_ADD),
+        /* 60 */ instruction(BPF_ALU64 | BPF_MOV | BPF_X, BPF_REG_1, BPF_REG_9, 0, 0),
+        /* 61 */ instruction(BPF_ALU64 | BPF_ADD | BPF_K, BPF_REG_1, 0, 0, -KERNEL_COUNTER_PAYLOAD_OFFSET),
+        /* 62 */ instruction(BPF_STX | BPF_ATOMIC | BPF_DW, BPF_REG_0, BPF_REG_1, offsetof(struct kernel_service_counters, bytes), BPF_ADD),
+        // Rejected datagrams carry no object
+        /* 63 */ instruction(BPF_JMP | BPF_JEQ | BPF_K, BPF_REG_7, 0, 9, 0),
+        // first_fragments += (fragment == 0)
+        /* 64 */ instruction(BPF_LDX | BPF_MEM | BPF_W, BPF_REG_1, BPF_REG_10, -16, 0),
+        /* 65 */ instruction(BPF_LDX | BPF_MEM | BPF_W, BPF_REG_2, BPF_REG_10, -12, 0),
+        /* 66 */ instruction(BPF_JMP | BPF_JNE | BPF_K, BPF_REG_2, 0, 2, 0),
+        /* 67 */ instruction(BPF_ALU64 | BPF_MOV | BPF_K, BPF_REG_3, 0, 0, 1),
+        /* 68 */ instruction(BPF_STX | BPF_ATOMIC | BPF_DW, BPF_REG_0, BPF_REG_3, offsetof(struct kernel_service_counters, first_fragments), BPF_ADD),
+        // last object and fragment, fragments of older objects arriving late are not tracked
+        /* 69 */ instruction(BPF_LDX | BPF_MEM | BPF_W, BPF_REG_3, BPF_REG_0, offsetof(struct kernel_service_counters, last_object), 0),
+        /* 70 */ instruction(BPF_JMP | BPF_JLT | BPF_X, BPF_REG_1, BPF_REG_3, 2, 0),
+        /* 71 */ instruction(BPF_STX | BPF_MEM | BPF_W, BPF_REG_0, BPF_REG_1, offsetof(struct kernel_service_counters, last_object), 0),
+        /* 72 */ instruction(BPF_STX | BPF_MEM | BPF_W, BPF_REG_0, BPF_REG_2, offsetof(struct kernel_service_counters, last_fragment), 0),
+        // Drop, the datagram never reaches the socket queue
+        /* 73 */ instruction(BPF_ALU64 | BPF_MOV | BPF_K, BPF_REG_0, 0, 0, 0),
+        /* 74 */ instruction(BPF_JMP | BPF_EXIT, 0, 0, 0, 0)
+    };
+    return code;
+}
+
+
+/*
+*
+*/
+struct bpf_insn KernelServiceCounter::instruction(uint8_t code, uint8_t dst_reg, uint8_t src_reg, int16_t off, int32_t imm)
+{
+    struct bpf_insn encoded;
+    encoded.code = code;
+    encoded.dst_reg = dst_reg;
+    encoded.src_reg = src_reg;
+    encoded.off = off;
+    encoded.imm = imm;
+    return encoded;
+}
+
+
+/*
+*
+*/
+long KernelServiceCounter::bpf_call(int command, union bpf_attr& attributes)
+{
+    return syscall(__NR_bpf, command, &attributes, sizeof(attributes));
+}
+
+
+/*
+*
+*/
+uint32_t KernelServiceCounter::possible_cpus()
+{
+    // Ranges like "0-7" or "0,2-3"
+    std::ifstream possible_file("/sys/devices/system/cpu/possible");
+    std::string ranges;
+    uint32_t highest_cpu = 0;
+    if (possible_file >> ranges)
+    {
+        size_t position = 0;
+        while (position < ranges.size())
+        {
+            size_t end = ranges.find(',', position);
+            std::string range = ranges.substr(position, end == std::string::npos ? std::string::npos : end - position);
+            size_t dash = range.find('-');
+            highest_cpu = std::max(highest_cpu, static_cast<uint32_t>(std::stoul(dash == std::string::npos ? range : range.substr(dash + 1))));
+            if (end == std::string::npos)
+            {
+                break;
+            }
+            position = end + 1;
+        }
+    }
+    return highest_cpu + 1;
+}
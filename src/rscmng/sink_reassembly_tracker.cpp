@@ -0,0 +1,234 @@
+// Copyright (C) 2025 IDA
+//
+// This file is part of a project licensed under the GNU Lesser General Public License v3.0.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+
+#include <algorithm>
+
+#include <rscmng/sink/reassembly_tracker.hpp>
+
+
+using namespace traffic_statistic;
+
+
+/*
+*
+*/
+ReassemblyTracker::ReassemblyTracker()
+:
+    deadline_ns(0),
+    newest_valid(false),
+    newest_object(0),
+    newest_total(0),
+    newest_mode(-1),
+    fragment_count_mode_changes(true)
+{
+
+}
+
+
+/*
+*
+*/
+void ReassemblyTracker::set_deadline(int64_t deadline_ns)
+{
+    this->deadline_ns = deadline_ns;
+}
+
+
+/*
+*
+*/
+int64_t ReassemblyTracker::deadline() const
+{
+    return deadline_ns;
+}
+
+
+/*
+*
+*/
+void ReassemblyTracker::set_fragment_count_mode_changes(bool enabled)
+{
+    fragment_count_mode_changes = enabled;
+}
+
+
+/*
+*
+*/
+int64_t ReassemblyTracker::record(uint32_t object_number, uint32_t fragment_number, uint32_t total_fragments, int64_t send_ns, int64_t receive_ns, int32_t mode)
+{
+    expire(receive_ns);
+
+    if (fragment_number >= total_fragments)
+    {
+        counter.fragments_invalid++;
+        return -1;
+    }
+
+    // Object numbers wrap around, compare by distance
+    bool older_object = false;
+    if (newest_valid)
+    {
+        int32_t distance = static_cast<int32_t>(object_number - newest_object);
+        if (distance <= -REASSEMBLY_WINDOW)
+        {
+            counter.fragments_late++;
+            return -1;
+        }
+        older_object = distance < 0;
+        if (distance > 0)
+        {
+            // The header mode is explicit, a new fragment count only signals a mode change of a constant size service
+            bool mode_changed = (mode >= 0 && newest_mode >= 0)
+                ? mode != newest_mode
+                : fragment_count_mode_changes && total_fragments != newest_total;
+            if (mode_changed)
+            {
+                // Objects in reception are affected by the mode change
+                counter.mode_changes++;
+                for (auto& object : objects)
+                {
+                    object.interrupted = object.interrupted || object.open;
+                }
+            }
+            newest_object = object_number;
+            newest_total = total_fragments;
+            newest_mode = mode;
+        }
+    }
+    else
+    {
+        newest_valid = true;
+        newest_object = object_number;
+        newest_total = total_fragments;
+        newest_mode = mode;
+    }
+
+    struct object_state& object = objects[object_number & (REASSEMBLY_WINDOW - 1)];
+    if (object.used && object.object_number == object_number)
+    {
+        if (!object.open)
+        {
+            if (object.complete)
+            {
+                counter.fragments_duplicate++;
+            }
+            else
+            {
+                counter.fragments_late++;
+            }
+            return -1;
+        }
+        if (fragment_number >= object.total_fragments)
+        {
+            counter.fragments_invalid++;
+            return -1;
+        }
+    }
+    else
+    {
+        // The slot is taken by an object REASSEMBLY_WINDOW objects older
+        if (object.open)
+        {
+            close_lost(object);
+        }
+        object.used = true;
+        object.open = true;
+        object.complete = false;
+        object.interrupted = false;
+        object.object_number = object_number;
+        object.total_fragments = total_fragments;
+        object.received = 0;
+        object.highest_fragment = 0;
+        object.first_send_ns = send_ns;
+        object.bitmap.assign((total_fragments + 63) / 64, 0);
+    }
+
+    uint64_t& bitmap_word = object.bitmap[fragment_number / 64];
+    uint64_t bitmap_bit = 1ULL << (fragment_number % 64);
+    if (bitmap_word & bitmap_bit)
+    {
+        counter.fragments_duplicate++;
+        return -1;
+    }
+    bitmap_word |= bitmap_bit;
+
+    if (older_object || fragment_number < object.highest_fragment)
+    {
+        counter.fragments_reordered++;
+    }
+    object.highest_fragment = std::max(object.highest_fragment, fragment_number);
+    object.first_send_ns = std::min(object.first_send_ns, send_ns);
+    object.received++;
+
+    if (object.received < object.total_fragments)
+    {
+        return -1;
+    }
+
+    object.open = false;
+    object.complete = true;
+    counter.objects_complete++;
+    return std::max<int64_t>(receive_ns - object.first_send_ns, 0);
+}
+
+
+/*
+*
+*/
+void ReassemblyTracker::expire(int64_t now_ns)
+{
+    int64_t timeout_ns = deadline_ns > 0 ? deadline_ns : REASSEMBLY_DEFAULT_TIMEOUT_NS;
+    for (auto& object : objects)
+    {
+        if (object.open && now_ns - object.first_send_ns > timeout_ns)
+        {
+            close_lost(object);
+        }
+    }
+}
+
+
+/*
+*
+*/
+const struct reassembly_counters& ReassemblyTracker::counters() const
+{
+    return counter;
+}
+
+
+/*------------------------------------- Private -----------------------------------------*/
+/*
+*
+*/
+void ReassemblyTracker::close_lost(struct object_state& object)
+{
+    object.open = false;
+    object.complete = false;
+    counter.objects_lost++;
+    counter.fragments_missing += object.total_fragments - object.received;
+    if (object.interrupted)
+    {
+        counter.objects_interrupted++;
+    }
+    if (deadline_ns > 0)
+    {
+        counter.deadline_misses++;
+    }
+}
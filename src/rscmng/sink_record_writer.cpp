@@ -0,0 +1,356 @@
+// Copyright (C) 2025 IDA
+//
+// This file is part of a project licensed under the GNU Lesser General Public License v3.0.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+
+#include <cstring>
+#include <cerrno>
+#include <chrono>
+#include <algorithm>
+#include <cstddef>
+
+#include <arpa/inet.h>
+
+#include <rscmng/sink/record_writer.hpp>
+#include <rscmng/utils/realtime_profile.hpp>
+
+
+using namespace traffic_statistic;
+
+
+/*
+*
+*/
+SinkRecordRing::SinkRecordRing(size_t capacity)
+:
+    records(capacity),
+    mask(capacity - 1),
+    head(0),
+    tail(0),
+    dropped_count(0)
+{
+    rscmng::RealtimeProfile::prefault(records.data(), records.size() * sizeof(struct sink_record));
+}
+
+
+/*
+*
+*/
+bool SinkRecordRing::push(const struct sink_record& record)
+{
+    uint64_t write_index = head.load(std::memory_order_relaxed);
+    if (write_index - tail.load(std::memory_order_acquire) > mask)
+    {
+        dropped_count.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    records[write_index & mask] = record;
+    head.store(write_index + 1, std::memory_order_release);
+    return true;
+}
+
+
+/*
+*
+*/
+size_t SinkRecordRing::pop(struct sink_record* output, size_t max_records)
+{
+    uint64_t read_index = tail.load(std::memory_order_relaxed);
+    uint64_t available = head.load(std::memory_order_acquire) - read_index;
+    size_t count = available < max_records ? static_cast<size_t>(available) : max_records;
+
+    // Copy in up to two contiguous parts of the ring
+    size_t first = read_index & mask;
+    size_t first_count = std::min(count, records.size() - first);
+    memcpy(output, &records[first], first_count * sizeof(struct sink_record));
+    memcpy(output + first_count, &records[0], (count - first_count) * sizeof(struct sink_record));
+
+    tail.store(read_index + count, std::memory_order_release);
+    return count;
+}
+
+
+/*
+*
+*/
+uint64_t SinkRecordRing::dropped() const
+{
+    return dropped_count.load(std::memory_order_relaxed);
+}
+
+
+/*
+*
+*/
+SinkRecordWriter::SinkRecordWriter(std::string file_prefix)
+:
+    file_prefix(file_prefix),
+    active(false),
+    write_buffer(SINK_RECORD_WRITE_BATCH)
+{
+
+}
+
+
+/*
+*
+*/
+SinkRecordWriter::~SinkRecordWriter()
+{
+    stop();
+}
+
+
+/*
+*
+*/
+std::shared_ptr<SinkRecordRing> SinkRecordWriter::create_ring(std::string local_ip_address, uint32_t local_port, std::string file_suffix)
+{
+    std::shared_ptr<struct record_stream> stream = std::make_shared<struct record_stream>();
+    stream->file_name = file_prefix + "_" + local_ip_address + "_" + std::to_string(local_port) + file_suffix + SINK_RECORD_FILE_EXTENSION;
+    stream->file = fopen(stream->file_name.c_str(), "ab");
+    if (stream->file == nullptr)
+    {
+        RM_logError("Sink record file " << stream->file_name << " not opened: " << strerror(errno))
+        return nullptr;
+    }
+    // Records reach the disk in large sequential writes
+    stream->file_buffer.resize(SINK_RECORD_WRITE_BATCH * sizeof(struct sink_record));
+    setvbuf(stream->file, stream->file_buffer.data(), _IOFBF, stream->file_buffer.size());
+    stream->written = 0;
+
+    // Every file (or appended run) starts with a header, the converter reads runs until the end of the file
+    struct sink_record_file_header header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, SINK_RECORD_FILE_MAGIC, sizeof(header.magic));
+    header.record_size = sizeof(struct sink_record);
+    struct in_addr local_address;
+    if (inet_pton(AF_INET, local_ip_address.c_str(), &local_address) == 1)
+    {
+        header.local_address = ntohl(local_address.s_addr);
+    }
+    header.local_port = local_port;
+    fwrite(&header, sizeof(header), 1, stream->file);
+
+    stream->ring = std::make_shared<SinkRecordRing>(SINK_RECORD_RING_SIZE);
+
+    std::lock_guard<std::mutex> lock(stream_mutex);
+    streams.push_back(stream);
+    if (!writer.joinable())
+    {
+        active = true;
+        writer = std::thread(&SinkRecordWriter::run, this);
+    }
+    RM_logInfo("Sink records of " << local_ip_address << ":" << local_port << " are written to " << stream->file_name)
+    return stream->ring;
+}
+
+
+/*
+*
+*/
+void SinkRecordWriter::stop()
+{
+    active = false;
+    if (writer.joinable())
+    {
+        writer.join();
+    }
+
+    std::lock_guard<std::mutex> lock(stream_mutex);
+    for (auto& stream : streams)
+    {
+        if (stream->file == nullptr)
+        {
+            continue;
+        }
+        drain(*stream);
+        fclose(stream->file);
+        stream->file = nullptr;
+        RM_logInfo("Sink records " << stream->file_name << ": " << stream->written << " written, " << stream->ring->dropped() << " dropped")
+    }
+}
+
+
+/*
+*
+*/
+bool SinkRecordWriter::convert_to_text(std::string record_file_name, std::string text_prefix)
+{
+    FILE* record_file = fopen(record_file_name.c_str(), "rb");
+    if (record_file == nullptr)
+    {
+        RM_logError("Sink record file " << record_file_name << " not opened: " << strerror(errno))
+        return false;
+    }
+
+    FILE* log_file = nullptr;
+    FILE* log_file_all = nullptr;
+    std::vector<struct sink_record> records(SINK_RECORD_WRITE_BATCH);
+    std::vector<char> chunk;
+    struct sink_record_file_header header;
+    bool complete = true;
+    uint64_t converted = 0;
+
+    while (fread(&header, sizeof(header), 1, record_file) == 1)
+    {
+        // Files of older versions have shorter records, the missing fields stay 0
+        if (memcmp(header.magic, SINK_RECORD_FILE_MAGIC, sizeof(header.magic)) != 0 || header.record_size > sizeof(struct sink_record)
+            || header.record_size < offsetof(struct sink_record, kernel_receive_sec))
+        {
+            RM_logError("Sink record file " << record_file_name << " has an unknown format")
+            complete = false;
+            break;
+        }
+
+        struct in_addr local_address;
+        local_address.s_addr = htonl(header.local_address);
+        char local_ip_address[INET_ADDRSTRLEN];
+        inet_ntop(AF_INET, &local_address, local_ip_address, sizeof(local_ip_address));
+
+        if (log_file == nullptr)
+        {
+            std::string filename_str = text_prefix + "_" + local_ip_address + ".log";
+            std::string filename_str_log = text_prefix + "_" + local_ip_address + "_all.log";
+            log_file = fopen(filename_str.c_str(), "a");
+            log_file_all = fopen(filename_str_log.c_str(), "a");
+            if (log_file == nullptr || log_file_all == nullptr)
+            {
+                RM_logError("Sink text log " << filename_str << " not opened: " << strerror(errno))
+                complete = false;
+                break;
+            }
+        }
+
+        // Records of this run follow until the next header or the end of the file
+        bool next_header = false;
+        while (!next_header)
+        {
+            long chunk_offset = ftell(record_file);
+            chunk.resize(records.size() * header.record_size);
+            size_t count = fread(chunk.data(), header.record_size, records.size(), record_file);
+            for (size_t index = 0; index < count; index++)
+            {
+                memset(&records[index], 0, sizeof(struct sink_record));
+                memcpy(&records[index], chunk.data() + index * header.record_size, header.record_size);
+            }
+            for (size_t index = 0; index < count; index++)
+            {
+                const struct sink_record& record = records[index];
+                if (memcmp(&record, SINK_RECORD_FILE_MAGIC, sizeof(header.magic)) == 0)
+                {
+                    // Step back to the header of an appended run
+                    fseek(record_file, chunk_offset + static_cast<long>(index * header.record_size), SEEK_SET);
+                    next_header = true;
+                    break;
+                }
+
+                struct in_addr source_address;
+                source_address.s_addr = htonl(record.source_address);
+                char source_ip_address[INET_ADDRSTRLEN];
+                inet_ntop(AF_INET, &source_address, source_ip_address, sizeof(source_ip_address));
+
+                bool kernel_timestamp = record.kernel_receive_sec != 0 || record.kernel_receive_nsec != 0;
+                long receive_sec = static_cast<long>(kernel_timestamp ? record.kernel_receive_sec : record.receive_sec);
+                long receive_nsec = static_cast<long>(kernel_timestamp ? record.kernel_receive_nsec : record.receive_nsec);
+
+                if (record.fragment_number == 1)
+                {
+                    fprintf(log_file_all, "Traffic sink received frame from service: %lu %s from port %u on interface ip: %s on port %u with packet number %u from object %u at time %li s %ld ns\n",
+                        static_cast<unsigned long>(record.service_id), source_ip_address, record.source_port, local_ip_address, header.local_port,
+                        record.fragment_number, record.object_number, receive_sec, receive_nsec);
+                }
+                fprintf(log_file, "Frame started    :%s:%u:%u:%lu: %ld secs %ld nsecs\n", local_ip_address, record.object_number, record.fragment_number,
+                    static_cast<unsigned long>(record.service_id), static_cast<long>(record.send_sec), static_cast<long>(record.send_nsec));
+                fprintf(log_file, "Frame received   :%s:%u:%u:%lu: %ld secs %ld nsecs\n", local_ip_address, record.object_number, record.fragment_number,
+                    static_cast<unsigned long>(record.service_id), receive_sec, receive_nsec);
+                converted++;
+            }
+            if (count < records.size())
+            {
+                break;
+            }
+        }
+    }
+
+    if (log_file != nullptr)
+    {
+        fclose(log_file);
+    }
+    if (log_file_all != nullptr)
+    {
+        fclose(log_file_all);
+    }
+    fclose(record_file);
+
+    RM_logInfo("Sink record file " << record_file_name << ": " << converted << " records converted")
+    return complete;
+}
+
+
+/*------------------------------------- Private -----------------------------------------*/
+/*
+*
+*/
+void SinkRecordWriter::run()
+{
+    rscmng::RealtimeProfile::instance().apply(RT_THREAD_SINK_WRITER);
+    std::chrono::steady_clock::time_point last_flush = std::chrono::steady_clock::now();
+
+    while (active)
+    {
+        size_t written = 0;
+        {
+            std::lock_guard<std::mutex> lock(stream_mutex);
+            for (auto& stream : streams)
+            {
+                written += drain(*stream);
+            }
+
+            if (std::chrono::steady_clock::now() - last_flush >= std::chrono::milliseconds(SINK_RECORD_FLUSH_INTERVAL_MS))
+            {
+                for (auto& stream : streams)
+                {
+                    fflush(stream->file);
+                }
+                last_flush = std::chrono::steady_clock::now();
+            }
+        }
+
+        // A ring holds several ms of records at line rate, so the writer only polls when idle
+        if (written == 0)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+}
+
+
+/*
+*
+*/
+size_t SinkRecordWriter::drain(struct record_stream& stream)
+{
+    size_t written = 0;
+    size_t count = 0;
+    while ((count = stream.ring->pop(write_buffer.data(), write_buffer.size())) > 0)
+    {
+        fwrite(write_buffer.data(), sizeof(struct sink_record), count, stream.file);
+        written += count;
+    }
+    stream.written += written;
+    return written;
+}
@@ -0,0 +1,95 @@
+// Copyright (C) 2025 IDA
+//
+// This file is part of a project licensed under the GNU Lesser General Public License v3.0.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+
+#include <cerrno>
+#include <cstring>
+
+#include <vector>
+
+#include <sys/socket.h>
+#include <linux/filter.h>
+
+#include <rscmng/messages.hpp>
+#include <rscmng/sink/reuseport_steering.hpp>
+
+
+using namespace traffic_statistic;
+
+
+/*
+*
+*/
+uint32_t traffic_statistic::service_shard(uint64_t service_id, uint32_t shard_count)
+{
+    return shard_count > 0 ? static_cast<uint32_t>(service_id) % shard_count : 0;
+}
+
+
+/*
+*
+*/
+bool traffic_statistic::attach_service_steering(int socket_fd, uint32_t shard_count)
+{
+    // The program sees the UDP payload at offset 0. A v2 or v3 header starts with the marker byte, the service id
+    // of both formats is little endian at a format specific offset, so the first byte selects one of two
+    // identical blocks that differ only in that offset.
+    std::vector<struct sock_filter> steering_code;
+    steering_code.push_back(BPF_STMT(BPF_LD | BPF_B | BPF_ABS, rscmng::DataMessageHeaderV2::MARKER_OFFSET));
+    steering_code.push_back(BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, rscmng::DataMessageHeaderV2::MARKER, 0, STEERING_BLOCK_LENGTH));
+    append_steering_block(steering_code, rscmng::DataMessageHeaderV2::SERVICE_ID_OFFSET, shard_count);
+    append_steering_block(steering_code, STEERING_SERVICE_ID_OFFSET, shard_count);
+
+    struct sock_fprog steering_program;
+    steering_program.len = static_cast<unsigned short>(steering_code.size());
+    steering_program.filter = steering_code.data();
+
+    if (shard_count == 0 || setsockopt(socket_fd, SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF, &steering_program, sizeof(steering_program)) < 0)
+    {
+        RM_logWarning("Sink service steering not attached (" << strerror(errno) << "), shards are selected by the kernel hash")
+        return false;
+    }
+    return true;
+}
+
+
+/*
+*
+*/
+void traffic_statistic::append_steering_block(std::vector<struct sock_filter>& steering_code, uint32_t service_id_offset, uint32_t shard_count)
+{
+    // Absolute loads are big endian, the service id is little endian, so its lower 32 bits are assembled byte by byte
+    struct sock_filter steering_block[STEERING_BLOCK_LENGTH] =
+    {
+        BPF_STMT(BPF_LD | BPF_B | BPF_ABS, service_id_offset + 3),
+        BPF_STMT(BPF_ALU | BPF_LSH | BPF_K, 24),
+        BPF_STMT(BPF_MISC | BPF_TAX, 0),
+        BPF_STMT(BPF_LD | BPF_B | BPF_ABS, service_id_offset + 2),
+        BPF_STMT(BPF_ALU | BPF_LSH | BPF_K, 16),
+        BPF_STMT(BPF_ALU | BPF_OR | BPF_X, 0),
+        BPF_STMT(BPF_MISC | BPF_TAX, 0),
+        BPF_STMT(BPF_LD | BPF_B | BPF_ABS, service_id_offset + 1),
+        BPF_STMT(BPF_ALU | BPF_LSH | BPF_K, 8),
+        BPF_STMT(BPF_ALU | BPF_OR | BPF_X, 0),
+        BPF_STMT(BPF_MISC | BPF_TAX, 0),
+        BPF_STMT(BPF_LD | BPF_B | BPF_ABS, service_id_offset),
+        BPF_STMT(BPF_ALU | BPF_OR | BPF_X, 0),
+        BPF_STMT(BPF_ALU | BPF_MOD | BPF_K, shard_count),
+        BPF_STMT(BPF_RET | BPF_A, 0)
+    };
+    steering_code.insert(steering_code.end(), steering_block, steering_block + STEERING_BLOCK_LENGTH);
+}
@@ -0,0 +1,109 @@
+// Copyright (C) 2025 IDA
+//
+// This file is part of a project licensed under the GNU Lesser General Public License v3.0.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+
+#include <cerrno>
+#include <cstring>
+#include <cstdint>
+
+#include <rscmng/sink/rx_timestamp.hpp>
+
+
+using namespace traffic_statistic;
+
+
+/*
+*
+*/
+RxTimestampMode traffic_statistic::rx_timestamp_mode_from_string(std::string mode_name)
+{
+    if (mode_name == "NONE")
+    {
+        return RX_TIMESTAMP_NONE;
+    }
+    if (mode_name == "HARDWARE")
+    {
+        return RX_TIMESTAMP_HARDWARE;
+    }
+    if (mode_name != "SOFTWARE")
+    {
+        RM_logWarning("Unknown receive timestamping " << mode_name << ", using SOFTWARE")
+    }
+    return RX_TIMESTAMP_SOFTWARE;
+}
+
+
+/*
+*
+*/
+RxTimestampMode traffic_statistic::enable_rx_timestamps(int socket_fd, RxTimestampMode mode)
+{
+    if (mode == RX_TIMESTAMP_HARDWARE)
+    {
+        uint32_t timestamping_flags = SOF_TIMESTAMPING_RX_HARDWARE
+            | SOF_TIMESTAMPING_RAW_HARDWARE
+            | SOF_TIMESTAMPING_RX_SOFTWARE
+            | SOF_TIMESTAMPING_SOFTWARE;
+        if (setsockopt(socket_fd, SOL_SOCKET, SO_TIMESTAMPING, &timestamping_flags, sizeof(timestamping_flags)) == 0)
+        {
+            return RX_TIMESTAMP_HARDWARE;
+        }
+        RM_logWarning("RX timestamping SO_TIMESTAMPING not available (" << strerror(errno) << "), using SO_TIMESTAMPNS")
+        mode = RX_TIMESTAMP_SOFTWARE;
+    }
+
+    if (mode == RX_TIMESTAMP_SOFTWARE)
+    {
+        int enable = 1;
+        if (setsockopt(socket_fd, SOL_SOCKET, SO_TIMESTAMPNS, &enable, sizeof(enable)) == 0)
+        {
+            return RX_TIMESTAMP_SOFTWARE;
+        }
+        RM_logWarning("RX timestamping SO_TIMESTAMPNS not available (" << strerror(errno) << "), using the time after receive")
+    }
+
+    return RX_TIMESTAMP_NONE;
+}
+
+
+/*
+*
+*/
+bool traffic_statistic::read_rx_timestamp(const struct msghdr& message, struct timespec& timestamp)
+{
+    for (struct cmsghdr* control = CMSG_FIRSTHDR(&message); control != nullptr; control = CMSG_NXTHDR(const_cast<struct msghdr*>(&message), control))
+    {
+        if (control->cmsg_level != SOL_SOCKET)
+        {
+            continue;
+        }
+        if (control->cmsg_type == SCM_TIMESTAMPNS)
+        {
+            memcpy(&timestamp, CMSG_DATA(control), sizeof(timestamp));
+            return true;
+        }
+        if (control->cmsg_type == SCM_TIMESTAMPING)
+        {
+            // ts[0] software, ts[2] raw hardware timestamp
+            struct timespec timestamps[3];
+            memcpy(timestamps, CMSG_DATA(control), sizeof(timestamps));
+            timestamp = (timestamps[2].tv_sec != 0 || timestamps[2].tv_nsec != 0) ? timestamps[2] : timestamps[0];
+            return timestamp.tv_sec != 0 || timestamp.tv_nsec != 0;
+        }
+    }
+    return false;
+}
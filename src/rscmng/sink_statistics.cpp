@@ -0,0 +1,279 @@
+// Copyright (C) 2025 IDA
+//
+// This file is part of a project licensed under the GNU Lesser General Public License v3.0.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+
+#include <algorithm>
+#include <ctime>
+
+#include <rscmng/sink/sink_statistics.hpp>
+
+
+using namespace traffic_statistic;
+
+
+/*
+*
+*/
+SinkStatistics::SinkStatistics(uint32_t service_count)
+:
+    capacity(SINK_STATISTICS_MIN_SERVICES),
+    dropped_services(0)
+{
+    // Half filled at most, probes stay short
+    while (capacity < SINK_STATISTICS_MAX_SERVICES && capacity < 2 * static_cast<uint64_t>(service_count))
+    {
+        capacity <<= 1;
+    }
+    slots.reset(new struct service_slot[capacity]);
+    for (uint32_t index = 0; index < capacity; ++index)
+    {
+        struct service_slot& service = slots[index];
+        service.key.store(0);
+        service.deadline_ns.store(0);
+        service.fragments.store(0);
+    }
+}
+
+
+/*
+*
+*/
+void SinkStatistics::register_service(uint64_t service_id, int64_t deadline_ns, bool constant_size)
+{
+    struct service_slot* service = slot(service_id);
+    if (service != nullptr)
+    {
+        service->deadline_ns.store(deadline_ns, std::memory_order_relaxed);
+        std::lock_guard<std::mutex> object_lock(service->object_mutex);
+        service->reassembly.set_deadline(deadline_ns);
+        service->reassembly.set_fragment_count_mode_changes(constant_size);
+    }
+}
+
+
+/*
+*
+*/
+void SinkStatistics::record_fragment(uint64_t service_id, uint32_t object_number, uint32_t fragment_number, uint32_t total_fragments, int64_t send_ns, int64_t receive_ns, int32_t mode)
+{
+    struct service_slot* service = slot(service_id);
+    if (service == nullptr)
+    {
+        return;
+    }
+
+    // Send and receive clocks of different hosts are only synchronized up to an offset, never record negative delays
+    service->fragment_delay.record(receive_ns > send_ns ? static_cast<uint64_t>(receive_ns - send_ns) : 0);
+    service->fragments.fetch_add(1, std::memory_order_relaxed);
+
+    int64_t completion_ns;
+    {
+        std::lock_guard<std::mutex> object_lock(service->object_mutex);
+        completion_ns = service->reassembly.record(object_number, fragment_number, total_fragments, send_ns, receive_ns, mode);
+    }
+
+    if (completion_ns >= 0)
+    {
+        service->object_completion.record(static_cast<uint64_t>(completion_ns));
+    }
+}
+
+
+/*
+*
+*/
+std::vector<struct service_statistics_snapshot> SinkStatistics::snapshot()
+{
+    return snapshot(std::vector<SinkStatistics*>{this});
+}
+
+
+/*
+*
+*/
+std::vector<struct service_statistics_snapshot> SinkStatistics::snapshot(const std::vector<SinkStatistics*>& shards)
+{
+    struct timespec time_now;
+    clock_gettime(CLOCK_REALTIME, &time_now);
+    int64_t now_ns = time_now.tv_sec * 1000000000L + time_now.tv_nsec;
+
+    struct merged_service
+    {
+        struct service_statistics_snapshot snapshot;
+        rscmng::LogLinearHistogram fragment_delay;
+        rscmng::LogLinearHistogram object_completion;
+    };
+    std::map<uint64_t, std::unique_ptr<struct merged_service>> merged;
+
+    for (SinkStatistics* shard : shards)
+    {
+        for (uint32_t index = 0; index < shard->capacity; ++index)
+        {
+            struct service_slot& service = shard->slots[index];
+            uint64_t key = service.key.load(std::memory_order_acquire);
+            if (key == 0)
+            {
+                continue;
+            }
+
+            std::unique_ptr<struct merged_service>& merged_service = merged[key - 1];
+            if (!merged_service)
+            {
+                merged_service.reset(new struct merged_service());
+                merged_service->snapshot.service_id = key - 1;
+                merged_service->snapshot.deadline_ns = 0;
+                merged_service->snapshot.fragments = 0;
+            }
+
+            struct service_statistics_snapshot& snapshot = merged_service->snapshot;
+            snapshot.deadline_ns = std::max(snapshot.deadline_ns, service.deadline_ns.load(std::memory_order_relaxed));
+            snapshot.fragments += service.fragments.load(std::memory_order_relaxed);
+            {
+                std::lock_guard<std::mutex> object_lock(service.object_mutex);
+                // Objects of a service that stopped sending are only declared lost here
+                service.reassembly.expire(now_ns);
+                add_counters(snapshot.reassembly, service.reassembly.counters());
+            }
+            merged_service->fragment_delay.merge(service.fragment_delay);
+            merged_service->object_completion.merge(service.object_completion);
+        }
+    }
+
+    // Ordered by service id
+    std::vector<struct service_statistics_snapshot> services;
+    for (auto& merged_service : merged)
+    {
+        merged_service.second->snapshot.fragment_delay = percentiles_of(merged_service.second->fragment_delay);
+        merged_service.second->snapshot.object_completion = percentiles_of(merged_service.second->object_completion);
+        services.push_back(merged_service.second->snapshot);
+    }
+    return services;
+}
+
+
+/*
+*
+*/
+void SinkStatistics::print(std::string name)
+{
+    print(name, std::vector<SinkStatistics*>{this});
+}
+
+
+/*
+*
+*/
+void SinkStatistics::print(std::string name, const std::vector<SinkStatistics*>& shards)
+{
+    for (const auto& service : snapshot(shards))
+    {
+        const struct reassembly_counters& reassembly = service.reassembly;
+        RM_logInfo(name << " service " << service.service_id << " objects complete: " << reassembly.objects_complete
+            << " lost: " << reassembly.objects_lost << " interrupted: " << reassembly.objects_interrupted
+            << " mode changes: " << reassembly.mode_changes
+            << " deadline " << service.deadline_ns / 1e6 << " ms misses: " << reassembly.deadline_misses)
+        RM_logInfo(name << " service " << service.service_id << " fragments: " << service.fragments
+            << " missing: " << reassembly.fragments_missing << " duplicate: " << reassembly.fragments_duplicate
+            << " reordered: " << reassembly.fragments_reordered << " late: " << reassembly.fragments_late
+            << " invalid: " << reassembly.fragments_invalid)
+        RM_logInfo(name << " service " << service.service_id << " fragment delay"
+            << " p50: " << service.fragment_delay.p50 / 1e3 << " us p99: " << service.fragment_delay.p99 / 1e3
+            << " us p99.9: " << service.fragment_delay.p999 / 1e3 << " us max: " << service.fragment_delay.max / 1e3 << " us")
+        RM_logInfo(name << " service " << service.service_id << " object completion"
+            << " p50: " << service.object_completion.p50 / 1e3 << " us p99: " << service.object_completion.p99 / 1e3
+            << " us p99.9: " << service.object_completion.p999 / 1e3 << " us max: " << service.object_completion.max / 1e3 << " us")
+    }
+
+    uint64_t dropped = 0;
+    uint32_t capacity = SINK_STATISTICS_MAX_SERVICES;
+    for (SinkStatistics* shard : shards)
+    {
+        dropped += shard->dropped_services.load(std::memory_order_relaxed);
+        capacity = std::min(capacity, shard->capacity);
+    }
+    if (dropped > 0)
+    {
+        RM_logWarning(name << " " << dropped << " fragments of untracked services, more than " << capacity << " services")
+    }
+}
+
+
+/*------------------------------------- Private -----------------------------------------*/
+/*
+*
+*/
+struct SinkStatistics::service_slot* SinkStatistics::slot(uint64_t service_id)
+{
+    uint64_t key = service_id + 1;
+    uint32_t start = static_cast<uint32_t>((key * 0x9E3779B97F4A7C15ULL) >> 32) & (capacity - 1);
+
+    for (uint32_t probe = 0; probe < capacity; ++probe)
+    {
+        struct service_slot& service = slots[(start + probe) & (capacity - 1)];
+        uint64_t current = service.key.load(std::memory_order_acquire);
+        if (current == key)
+        {
+            return &service;
+        }
+        if (current == 0)
+        {
+            uint64_t expected = 0;
+            if (service.key.compare_exchange_strong(expected, key, std::memory_order_acq_rel) || expected == key)
+            {
+                return &service;
+            }
+        }
+    }
+
+    dropped_services.fetch_add(1, std::memory_order_relaxed);
+    return nullptr;
+}
+
+
+/*
+*
+*/
+struct latency_percentiles SinkStatistics::percentiles_of(const rscmng::LogLinearHistogram& histogram)
+{
+    struct latency_percentiles percentiles;
+    percentiles.count = histogram.count();
+    percentiles.min = histogram.min();
+    percentiles.p50 = histogram.percentile(50.0);
+    percentiles.p90 = histogram.percentile(90.0);
+    percentiles.p99 = histogram.percentile(99.0);
+    percentiles.p999 = histogram.percentile(99.9);
+    percentiles.max = histogram.max();
+    return percentiles;
+}
+
+
+/*
+*
+*/
+void SinkStatistics::add_counters(struct reassembly_counters& sum, const struct reassembly_counters& counters)
+{
+    sum.objects_complete += counters.objects_complete;
+    sum.objects_lost += counters.objects_lost;
+    sum.objects_interrupted += counters.objects_interrupted;
+    sum.deadline_misses += counters.deadline_misses;
+    sum.mode_changes += counters.mode_changes;
+    sum.fragments_missing += counters.fragments_missing;
+    sum.fragments_duplicate += counters.fragments_duplicate;
+    sum.fragments_reordered += counters.fragments_reordered;
+    sum.fragments_late += counters.fragments_late;
+    sum.fragments_invalid += counters.fragments_invalid;
+}
@@ -27,6 +27,502 @@ using namespace traffic_generator;
 using namespace boost::placeholders;
 
 
+/*
+*
+*/
+TransmitBackend traffic_generator::transmit_backend_from_string(std::string backend_name)
+{
+    if (backend_name == "BATCH")
+    {
+        return TRANSMIT_BATCH;
+    }
+    if (backend_name == "GSO")
+    {
+        return TRANSMIT_GSO;
+    }
+    if (backend_name == "TXTIME")
+    {
+        return TRANSMIT_TXTIME;
+    }
+    if (backend_name == "PACKET_RING")
+    {
+        return TRANSMIT_PACKET_RING;
+    }
+    if (backend_name != "SOCKET")
+    {
+        RM_logWarning("Unknown transmit backend " << backend_name << ", using SOCKET")
+    }
+    return TRANSMIT_SOCKET;
+}
+
+
+/*
+*
+*/
+TransmitPath::TransmitPath(const udp::endpoint& local_endpoint, const traffic_generator_parameter& traffic_pattern, std::string name)
+:
+    path_name(name),
+    transmit_socket(transmit_context),
+    transmit_endpoint_local(local_endpoint),
+    txtime_lead_ns(std::chrono::duration_cast<std::chrono::nanoseconds>(traffic_pattern.txtime_lead).count())
+{
+    transmit_socket.open(transmit_endpoint_local.protocol());
+    transmit_socket.set_option(boost::asio::socket_base::reuse_address(true));
+    transmit_socket.set_option(boost::asio::socket_base::broadcast(true));
+    transmit_socket.bind(transmit_endpoint_local);
+
+    if (traffic_pattern.transmit_backend == TRANSMIT_BATCH)
+    {
+        batch_sender.reset(new BatchSender(
+            transmit_socket.native_handle(),
+            traffic_pattern.batch_size,
+            DataMessageTemplate::HEADER_LENGTH
+        ));
+        RM_logInfo(path_name << " batched transmission with " << batch_sender->capacity() << " fragments per sendmmsg")
+    }
+    else if (traffic_pattern.transmit_backend == TRANSMIT_GSO)
+    {
+        gso_sender.reset(new GsoSender(
+            transmit_socket.native_handle(),
+            DataMessageTemplate::HEADER_LENGTH + demonstrator::MAX_PROTOCOL_MESSAGE_LENGTH,
+            DataMessageTemplate::HEADER_LENGTH
+        ));
+        RM_logInfo(path_name << " segmentation offload transmission, offload " << (gso_sender->offload_active() ? "active" : "fallback"))
+    }
+    else if (traffic_pattern.transmit_backend == TRANSMIT_TXTIME)
+    {
+        txtime_sender.reset(new TxTimeSender(
+            transmit_socket.native_handle(),
+            traffic_pattern.txtime_log_only,
+            traffic_pattern.txtime_lead,
+            traffic_pattern.pacing_strategy,
+            traffic_pattern.pacing_spin_margin
+        ));
+        txtime_sender->log_each_datagram = traffic_pattern.info_flag;
+        RM_logInfo(path_name << " launch time transmission, " << (txtime_sender->txtime_active() ? "SO_TXTIME" : "logging fallback"))
+    }
+    else if (traffic_pattern.transmit_backend == TRANSMIT_PACKET_RING)
+    {
+        packet_ring_sender.reset(new PacketRingSender(
+            transmit_endpoint_local,
+            traffic_pattern.batch_size,
+            DataMessageTemplate::HEADER_LENGTH + demonstrator::MAX_PROTOCOL_MESSAGE_LENGTH
+        ));
+        if (packet_ring_sender->valid())
+        {
+            RM_logInfo(path_name << " packet ring transmission on " << packet_ring_sender->interface())
+        }
+        else
+        {
+            // Raw frames need CAP_NET_RAW
+            RM_logWarning(path_name << " packet ring not available, using SOCKET")
+            packet_ring_sender.reset();
+        }
+    }
+
+    if (traffic_pattern.tx_timestamping)
+    {
+        if (gso_sender)
+        {
+            // One timestamp key per offload call, fragments could not be matched
+            RM_logWarning(path_name << " TX timestamping is not supported with segmentation offload")
+        }
+        else if (packet_ring_sender)
+        {
+            // Frames bypass the UDP socket, its error queue reports nothing
+            RM_logWarning(path_name << " TX timestamping is not supported with the packet ring")
+        }
+        else
+        {
+            tx_timestamps.reset(new TxTimestampCollector(transmit_socket.native_handle()));
+            tx_timestamps->log_each_completion = traffic_pattern.info_flag;
+            if (txtime_sender)
+            {
+                // Both read the socket error queue, the collector forwards launch time reports
+                txtime_sender->set_external_error_queue(true);
+                TxTimeSender* launch_time_sender = txtime_sender.get();
+                tx_timestamps->set_foreign_error_handler([launch_time_sender](const struct sock_extended_err& extended_error) {
+                    launch_time_sender->handle_error(extended_error);
+                });
+            }
+        }
+    }
+}
+
+
+/*
+*
+*/
+void TransmitPath::prepare_destination(const udp::endpoint& destination)
+{
+    if (packet_ring_sender && !packet_ring_sender->resolve(destination.address().to_v4()))
+    {
+        RM_logWarning(path_name << " next hop of " << destination.address().to_string() << " not resolved, sending to it through the socket")
+        socket_destinations.insert(destination);
+    }
+}
+
+
+/*
+*
+*/
+size_t TransmitPath::max_payload(const DataMessageTemplate& header_template, const udp::endpoint& destination)
+{
+    size_t payload_limit = header_template.max_payload();
+    if (gso_sender)
+    {
+        // Segments larger than the route MTU allows are rejected by the kernel
+        payload_limit = std::min(payload_limit, gso_sender->segment_size_for(destination) - header_template.size());
+    }
+    return payload_limit;
+}
+
+
+/*
+*
+*/
+uint32_t TransmitPath::transmit_fragment(const DataMessageTemplate& header_template, const char* payload, size_t payload_size, const udp::endpoint& destination, bool last_fragment, const struct timespec& launch_time)
+{
+    if (txtime_sender)
+    {
+        struct iovec datagram_iovec[2];
+        header_template.scatter(datagram_iovec, payload, payload_size);
+        return txtime_sender->send(datagram_iovec, 2, destination, launch_time);
+    }
+
+    if (gso_sender)
+    {
+        uint32_t fragments_sent = 0;
+
+        // One offload buffer carries a single destination
+        if (gso_sender->pending() > 0 && gso_sender->destination() != destination)
+        {
+            fragments_sent += gso_sender->flush();
+        }
+
+        gso_sender->queue(header_template.data(), header_template.size(), payload, payload_size, destination);
+
+        if (gso_sender->full() || last_fragment)
+        {
+            fragments_sent += gso_sender->flush();
+        }
+        return fragments_sent;
+    }
+
+    if (packet_ring_sender && (socket_destinations.empty() || socket_destinations.count(destination) == 0))
+    {
+        // A full ring is kicked while queueing, those datagrams are on the wire as well
+        uint32_t fragments_sent = packet_ring_sender->queue(header_template.data(), header_template.size(), payload, payload_size, destination);
+
+        if (packet_ring_sender->full() || last_fragment)
+        {
+            fragments_sent += packet_ring_sender->flush();
+        }
+        return fragments_sent;
+    }
+
+    if (batch_sender)
+    {
+        batch_sender->queue(header_template.data(), header_template.size(), payload, payload_size, destination);
+
+        if (batch_sender->full() || last_fragment)
+        {
+            return batch_sender->flush();
+        }
+        return 0;
+    }
+
+    std::array<boost::asio::const_buffer, 2> datagram_buffers = {{
+        boost::asio::buffer(header_template.data(), header_template.size()),
+        boost::asio::buffer(payload, payload_size)
+    }};
+    boost::system::error_code send_error;
+    transmit_socket.send_to(datagram_buffers, destination, 0, send_error);
+    if (send_error)
+    {
+        RM_logError(path_name << " send to " << destination.address().to_string() << ":" << destination.port() << " failed: " << send_error.message())
+        return 0;
+    }
+    return 1;
+}
+
+
+/*
+*
+*/
+uint32_t TransmitPath::flush()
+{
+    if (gso_sender && gso_sender->pending() > 0)
+    {
+        return gso_sender->flush();
+    }
+    if (batch_sender && batch_sender->pending() > 0)
+    {
+        return batch_sender->flush();
+    }
+    if (packet_ring_sender && packet_ring_sender->pending() > 0)
+    {
+        return packet_ring_sender->flush();
+    }
+    return 0;
+}
+
+
+/*
+*
+*/
+void TransmitPath::register_fragment(serviceID_t service_id, uint32_t object_number, uint32_t fragment_number, const struct timespec& send_time)
+{
+    if (tx_timestamps)
+    {
+        tx_timestamps->register_fragment(service_id, object_number, fragment_number, send_time);
+    }
+}
+
+
+/*
+*
+*/
+void TransmitPath::poll_timestamps()
+{
+    if (tx_timestamps)
+    {
+        tx_timestamps->poll();
+    }
+}
+
+
+/*
+*
+*/
+void TransmitPath::drain_timestamps()
+{
+    if (tx_timestamps)
+    {
+        tx_timestamps->drain();
+    }
+}
+
+
+/*
+*
+*/
+TransmitBackend TransmitPath::backend() const
+{
+    if (txtime_sender)
+    {
+        return TRANSMIT_TXTIME;
+    }
+    if (gso_sender)
+    {
+        return TRANSMIT_GSO;
+    }
+    if (packet_ring_sender)
+    {
+        return TRANSMIT_PACKET_RING;
+    }
+    if (batch_sender)
+    {
+        return TRANSMIT_BATCH;
+    }
+    return TRANSMIT_SOCKET;
+}
+
+
+/*
+*
+*/
+int64_t TransmitPath::launch_lead_ns() const
+{
+    if (txtime_sender && txtime_sender->txtime_active())
+    {
+        return txtime_lead_ns;
+    }
+    return 0;
+}
+
+
+/*
+*
+*/
+void TransmitPath::close()
+{
+    flush();
+    if (transmit_socket.is_open())
+    {
+        transmit_socket.close();
+    }
+}
+
+
+/*
+*
+*/
+void TransmitPath::print_statistics()
+{
+    if (batch_sender)
+    {
+        batch_sender->print_statistics(path_name + " batch sender");
+    }
+    if (gso_sender)
+    {
+        gso_sender->print_statistics(path_name + " GSO sender");
+    }
+    if (txtime_sender)
+    {
+        txtime_sender->print_statistics(path_name + " TxTime sender");
+    }
+    if (packet_ring_sender)
+    {
+        packet_ring_sender->print_statistics(path_name + " packet ring sender");
+    }
+    if (tx_timestamps)
+    {
+        tx_timestamps->print_statistics(path_name + " TX timestamping");
+    }
+}
+
+
+/*
+*
+*/
+std::map<uint32_t, struct transmission_plan> traffic_generator::compile_transmission_plans(
+    std::map<uint32_t, struct rscmng::config::service_settings>& service_settings,
+    uint32_t client_id,
+    DataMessageVersion message_version,
+    TransmitPath& transmit_path
+)
+{
+    std::map<uint32_t, struct transmission_plan> transmission_plans;
+    boost::asio::io_context resolver_context;
+    boost::asio::ip::udp::resolver resolver(resolver_context);
+
+    // Modes replaying the same recording with the same fragment size share one mapping
+    std::map<std::string, std::shared_ptr<PayloadSource>> mapped_sources;
+
+    for (auto& setting_iterator : service_settings)
+    {
+        uint32_t mode_id = setting_iterator.first;
+        auto& settings = setting_iterator.second;
+
+        struct transmission_plan plan;
+        plan.mode = mode_id;
+        plan.settings = &settings;
+        try
+        {
+            plan.destination = *resolver.resolve(boost::asio::ip::udp::v4(), settings.ip_address, std::to_string(settings.port)).begin();
+        }
+        catch (const boost::system::system_error& error)
+        {
+            RM_logError("Traffic Generator mode " << mode_id << " destination " << settings.ip_address << " not resolvable: " << error.what())
+            continue;
+        }
+        plan.header_template.prepare(
+            settings.service_priority,
+            client_id,
+            settings.service_id,
+            0,
+            0,
+            message_version,
+            static_cast<int32_t>(mode_id)
+        );
+        transmit_path.prepare_destination(plan.destination);
+        plan.max_payload = transmit_path.max_payload(plan.header_template, plan.destination);
+
+        settings.number_packets = static_cast<uint32_t>((settings.object_size * 1024 + plan.max_payload - 1) / plan.max_payload);
+        // Serialization time of full datagrams of this plan, header and payload
+        settings.estimated_transmission_time_ms = settings.number_packets * (settings.inter_packet_gap.count() / 1e6 + (plan.header_template.size() + plan.max_payload) * 8.0 / 1e9) * 1e3;
+        plan.number_packets = settings.number_packets;
+        plan.header_template.begin_object(0, settings.number_packets);
+        plan.inter_packet_gap_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(settings.inter_packet_gap).count();
+        plan.deadline_ns = static_cast<int64_t>(settings.deadline) * 1000000L;
+        plan.estimated_transmission_time_ms = settings.estimated_transmission_time_ms;
+
+        if (!settings.payload_source.empty())
+        {
+            std::string source_key = settings.payload_source + ":" + std::to_string(plan.max_payload);
+            if (mapped_sources.find(source_key) == mapped_sources.end())
+            {
+                mapped_sources[source_key] = std::make_shared<PayloadSource>(settings.payload_source, plan.max_payload);
+            }
+            if (mapped_sources[source_key]->valid())
+            {
+                plan.payload_source = mapped_sources[source_key];
+            }
+            else
+            {
+                RM_logWarning("Traffic Generator mode " << mode_id << " falls back to the dummy payload")
+            }
+        }
+
+        // Releases of the traffic model, compiled once for the period of the mode
+        std::unique_ptr<TrafficModel> traffic_model = make_traffic_model(settings);
+        plan.schedule = std::make_shared<TrafficSchedule>(*traffic_model, plan.deadline_ns, settings.traffic_model.schedule_periods, settings.traffic_model.seed);
+        if (plan.schedule->release_count() == 0)
+        {
+            RM_logWarning("Traffic Generator mode " << mode_id << " traffic model releases no objects, using PERIODIC")
+            PeriodicModel periodic_model(SizeDistribution(settings.traffic_model, static_cast<uint64_t>(settings.object_size) * 1024));
+            plan.schedule = std::make_shared<TrafficSchedule>(periodic_model, plan.deadline_ns, 1, settings.traffic_model.seed);
+        }
+
+        transmission_plans[mode_id] = plan;
+
+        RM_logInfo("########");
+        RM_logInfo("# Sending Mode      : " << std::to_string(mode_id));
+        RM_logInfo("# Destination       : " << plan.destination.address().to_string() << "  " << plan.destination.port());
+        RM_logInfo("# Service ID        : " << settings.service_id);
+        RM_logInfo("# Deadline          : " << settings.deadline << " ms");
+        RM_logInfo("# Object size       : " << settings.object_size << " KB");
+        RM_logInfo("# Number of packets : " << settings.number_packets);
+        RM_logInfo("# Inter packet gap  : " << settings.inter_packet_gap.count());
+        RM_logInfo("# Slot offset       : " << settings.slot_offset);
+        RM_logInfo("# Slot length       : " << settings.slot_length);
+        RM_logInfo("# Estimated object transmission time : " << settings.estimated_transmission_time_ms << " ms");
+        if (plan.payload_source)
+        {
+            RM_logInfo("# Payload source    : " << plan.payload_source->path() << " (" << plan.payload_source->object_count() << " objects)");
+        }
+        RM_logInfo("# Traffic schedule  : " << plan.schedule->release_count() << " objects in " << plan.schedule->period_count() << " periods");
+        RM_logInfo("########");
+    }
+    return transmission_plans;
+}
+
+
+/*
+*
+*/
+struct payload_object traffic_generator::next_payload(const struct transmission_plan& plan, uint64_t size_bytes, const std::vector<char>& dummy_payload)
+{
+    if (plan.payload_source)
+    {
+        return plan.payload_source->next_object();
+    }
+
+    // Every fragment references the same dummy buffer
+    struct payload_object object;
+    object.data = dummy_payload.data();
+    object.size = size_bytes;
+    object.fragment_stride = 0;
+    object.fragment_count = static_cast<uint32_t>((size_bytes + plan.max_payload - 1) / plan.max_payload);
+    if (object.fragment_count == 0)
+    {
+        object.fragment_count = 1;
+    }
+    return object;
+}
+
+
+/*
+*
+*/
+void traffic_generator::resume_object(struct transmission_state& state)
+{
+    state.header_template = state.plan->header_template;
+    state.header_template.begin_object(state.object_number, state.payload.fragment_count);
+}
+
+
 /*
 *
 */
@@ -40,20 +536,24 @@ TrafficGenerator::TrafficGenerator(
     service_settings_struct(service_settings),
     client_configuration_struct(client_configuration),
     experiment_parameter_struct(experiment_parameter),
-    traffic_source_type(traffic_type),
-    traffic_socket(traffic_context),
     traffic_pattern(traffic_pattern),
-    traffic_endpoint_local(udp::endpoint(boost::asio::ip::address::from_string(client_configuration.rm_control_local_ip[0]), 10000))   
+    packet_pacing(CLOCK_MONOTONIC, traffic_pattern.pacing_strategy, traffic_pattern.pacing_spin_margin),
+    object_timeline(timeline_clock_from_string(experiment_parameter.timeline_clock)),
+    object_pacing(object_timeline.clock_id(), traffic_pattern.pacing_strategy, traffic_pattern.pacing_spin_margin),
+    traffic_source_type(traffic_type)
 {
-    traffic_socket.open(traffic_endpoint_local.protocol());
-    traffic_socket.set_option(boost::asio::socket_base::reuse_address(true));
-    traffic_socket.set_option(boost::asio::socket_base::broadcast(true));
-    traffic_socket.bind(traffic_endpoint_local);
+    transmit_path.reset(new TransmitPath(
+        udp::endpoint(boost::asio::ip::address::from_string(client_configuration.rm_control_local_ip[0]), 10000),
+        traffic_pattern,
+        "Traffic Generator"
+    ));
+    transmission_plans = compile_transmission_plans(service_settings_struct, client_configuration.client_id, traffic_pattern.message_version, *transmit_path);
 
-    mode_global = 0;
     stop_thread = false;
-    global_period_timestamp = {0,0};
-    global_update_period = false;
+    mode_notify_ns = 0;
+    sent_fragment_count = 0;
+    sent_byte_count = 0;
+    thread_cpu_ns = 0;
 
     RM_logInfo("Traffic Generator constructor done.")
 }
@@ -82,13 +582,9 @@ void TrafficGenerator::start()
 */
 void TrafficGenerator::stop() 
 {
-    {
-        std::lock_guard<std::mutex> lock(global_mutex);
-        traffic_generator_control = THREAD_STOP;
-        stop_thread = true;
-    }
-    generator_conditioning_variable.notify_one();
-    traffic_generator.join();
+    stop_thread = true;
+    generator_control.publish_state(THREAD_STOP);
+    join();
 }
 
 
@@ -97,11 +593,7 @@ void TrafficGenerator::stop()
 */
 void TrafficGenerator::notify_generator(TrafficSourceControl state) 
 {
-        {
-            std::lock_guard<std::mutex> lock(global_mutex);
-            traffic_generator_control = state;
-        }
-        generator_conditioning_variable.notify_one();
+        generator_control.publish_state(state);
         RM_logInfo("Traffic Generator recieve notification: " << state)
 }
 
@@ -111,12 +603,8 @@ void TrafficGenerator::notify_generator(TrafficSourceControl state)
 */
 void TrafficGenerator::notify_generator_mode_change(TrafficSourceControl state, uint32_t mode) 
 {
-        {
-            std::lock_guard<std::mutex> lock(global_mutex);            
-            mode_global = mode;
-            traffic_generator_control = state;         
-        }                
-        generator_conditioning_variable.notify_one();
+        stamp_mode_notification();
+        generator_control.publish_mode(state, mode);
         RM_logInfo("Traffic Generator Reconfiguration with new mode: " << std::to_string(mode))
         
 }
@@ -127,14 +615,8 @@ void TrafficGenerator::notify_generator_mode_change(TrafficSourceControl state,
 */
 void TrafficGenerator::notify_generator_timestamp(TrafficSourceControl state, struct timespec timestamp, uint32_t mode, bool update_period)
 {
-        {
-            std::lock_guard<std::mutex> lock(global_mutex);            
-            mode_global = mode;
-            global_update_period = update_period;
-            global_period_timestamp = timestamp;
-            traffic_generator_control = state;         
-        }                
-        generator_conditioning_variable.notify_one();
+        stamp_mode_notification();
+        generator_control.publish_timestamp(state, timestamp, mode, update_period);
         RM_logInfo("Traffic Generator Reconfiguration with new mode: " << std::to_string(mode) << " at timestamp " << timestamp.tv_sec  << " s, " << timestamp.tv_nsec << " ns")
 }
 
@@ -144,266 +626,162 @@ void TrafficGenerator::notify_generator_timestamp(TrafficSourceControl state, st
 */
 void TrafficGenerator::precise_wait_us(double microseconds) 
 {
-    auto start = std::chrono::high_resolution_clock::now();
-    auto duration = std::chrono::duration<double, std::micro>(microseconds);
-    
-    while (std::chrono::high_resolution_clock::now() - start < duration);
+    packet_pacing.wait_for(std::chrono::nanoseconds(static_cast<int64_t>(microseconds * 1000.0)));
 }
 
 
 /*
 *
 */
-void TrafficGenerator::send_objects_dynamic_change()
+void TrafficGenerator::print_pacing_statistics()
 {
-    RM_logInfo("Traffic Generator Sending Thread " << std::to_string(thread_id) << " ObjectsBurstShaped IP started");
+    packet_pacing.print_statistics("Traffic Generator packet pacing");
+    object_pacing.print_statistics("Traffic Generator object pacing");
+    mode_switch_latency.print("Traffic Generator mode switch notify to first fragment");
+    packet_gap_error.print("Traffic Generator inter packet gap error");
+}
 
-    // Time vars
-    struct timespec time_now = {0,0};
-    struct timespec time_send = {0,0};
-    auto object_transmission_start = std::chrono::steady_clock::now();
-    auto current_time = std::chrono::steady_clock::now();
-    auto local_timepoint = std::chrono::steady_clock::now();
-    struct timespec local_timestamp;
 
-    long number_object = 1;
-    boost::asio::io_context io_context;
-    boost::asio::ip::udp::resolver resolver(io_context);
-    boost::asio::ip::udp::endpoint traffic_endpoint_target_new;
+/*
+*
+*/
+const LogLinearHistogram& TrafficGenerator::inter_packet_gap_error() const
+{
+    return packet_gap_error;
+}
 
-    // Per-thread buffers (reserve once)
-    std::vector<char> dummy_payload(demonstrator::MAX_PROTOCOL_MESSAGE_LENGTH, 'A');
-    std::vector<char> data_message_buffer;
-    data_message_buffer.reserve(demonstrator::MAX_PROTOCOL_MESSAGE_LENGTH);
 
-    // Log available modes
-    for (auto& setting_iterator : service_settings_struct)
-    {
-        uint32_t mode_id = setting_iterator.first;
-        auto& service_struct_iterator = setting_iterator.second;
+/*
+*
+*/
+const LogLinearHistogram& TrafficGenerator::object_start_lateness() const
+{
+    return object_pacing.lateness();
+}
 
-        service_struct_iterator.number_packets = static_cast<uint32_t>((service_struct_iterator.object_size * 1024 + demonstrator::MAX_PROTOCOL_MESSAGE_LENGTH - 1) / demonstrator::MAX_PROTOCOL_MESSAGE_LENGTH);
-        service_struct_iterator.estimated_transmission_time_ms = service_struct_iterator.number_packets * (service_struct_iterator.inter_packet_gap.count() / 1e6 + demonstrator::MAX_PROTOCOL_MESSAGE_LENGTH * 8.0 / 1e9) * 1e3;
-               
-        RM_logInfo("########");
-        RM_logInfo("# Sending Mode      : " << std::to_string(mode_id));
-        RM_logInfo("# Sending Thread Mode, Thread ID " << std::to_string(thread_id) << " Destination IP : " << service_struct_iterator.ip_address << "  " << service_struct_iterator.port);
-        RM_logInfo("# Service ID        : " << service_struct_iterator.service_id);
-        RM_logInfo("# Deadline          : " << service_struct_iterator.deadline << " ms");
-        RM_logInfo("# Object size       : " << service_struct_iterator.object_size << " KB");
-        RM_logInfo("# Number of packets : " << service_struct_iterator.number_packets);
-        RM_logInfo("# Inter packet gap  : " << service_struct_iterator.inter_packet_gap.count());
-        RM_logInfo("# Slot offset       : " << service_struct_iterator.slot_offset);
-        RM_logInfo("# Slot length       : " << service_struct_iterator.slot_length);
-        RM_logInfo("# Estimated object transmission time : " << service_struct_iterator.estimated_transmission_time_ms << " ms");
-        RM_logInfo("########");
-    }
 
-    // Validate initial mode_global
-    uint32_t current_mode = -1;
-    rscmng::config::service_settings current_settings;
-    const rscmng::config::service_settings* current_settings_ptr = nullptr;
+/*
+*
+*/
+uint64_t TrafficGenerator::fragments_sent() const
+{
+    return sent_fragment_count;
+}
 
-    traffic_pattern.info_flag = false;
-    RM_logInfo("Traffic Generator ready for loop!") 
-    while (true)
-    {
-        // Wait for permission to send
-        std::unique_lock<std::mutex> lock(global_mutex);
-        generator_conditioning_variable.wait(lock, [&] {
-            return (traffic_generator_control == THREAD_TRANSMISSION);
-        });
-        lock.unlock();
 
+/*
+*
+*/
+uint64_t TrafficGenerator::bytes_sent() const
+{
+    return sent_byte_count;
+}
 
-        if (current_mode != mode_global)
-        {
-            RM_logInfo("Traffic Generator change mode to: " << std::to_string(mode_global));
 
-            current_mode = mode_global;
-            auto iterator = service_settings_struct.find(current_mode);
-            if (iterator != service_settings_struct.end())
-            {
-                current_settings_ptr = &iterator->second;
-            }
-            else
-            {
-                RM_logInfo("Traffic Generator mode_global points to unknown setting: " << std::to_string(current_mode));
-                break;
-            }
+/*
+*
+*/
+int64_t TrafficGenerator::thread_cpu_time_ns() const
+{
+    return thread_cpu_ns;
+}
 
-            const auto& settings = *current_settings_ptr;
-            RM_logInfo("########");
-            RM_logInfo("# Sending Mode      : " << std::to_string(iterator->first));
-            RM_logInfo("# Sending Thread Mode, Thread ID " << std::to_string(thread_id) << " Destination IP : " << settings.ip_address << "  " << settings.port);
-            RM_logInfo("# Service ID        : " << settings.service_id);
-            RM_logInfo("# Deadline          : " << settings.deadline << " ms");
-            RM_logInfo("# Object size       : " << settings.object_size << " KB");
-            RM_logInfo("# Number of packets : " << settings.number_packets);
-            RM_logInfo("# Inter packet gap  : " << settings.inter_packet_gap.count());
-            RM_logInfo("# Slot offset       : " << settings.slot_offset);
-            RM_logInfo("# Slot length       : " << settings.slot_length);
-            RM_logInfo("# Estimated object transmission time : " << settings.estimated_transmission_time_ms << " ms");
-            RM_logInfo("########");
-
-            // Rebuild the endpoint dynamically
-            auto results = resolver.resolve(
-                boost::asio::ip::udp::v4(),
-                settings.ip_address,
-                std::to_string(settings.port)
-            );
-
-            // Pick first resolved address
-            traffic_endpoint_target_new = *results.begin();
-            //update period
-            if (global_update_period)
-            {
-                local_timestamp = global_period_timestamp;
-                local_timepoint = std::chrono::steady_clock::time_point{
-                std::chrono::seconds(global_period_timestamp.tv_sec) + std::chrono::nanoseconds(global_period_timestamp.tv_nsec)
-                };
-                global_update_period = false;
-            }
-            
-            RM_logInfo("Traffic Generator Updated endpoint to " << traffic_endpoint_target_new.address().to_string() << ":" << traffic_endpoint_target_new.port())
-            RM_logInfo("Traffic Generator Updated period   to " << local_timestamp.tv_sec << " s " << local_timestamp.tv_nsec << " ns")
-        }
-        
-        // Convert sizes to bytes and compute fragments
-        uint64_t remaining_bytes = current_settings_ptr->object_size * 1024;
-        size_t payload_size = static_cast<size_t>(std::min<uint64_t>(remaining_bytes, demonstrator::MAX_PROTOCOL_MESSAGE_LENGTH));
-        uint32_t number_packet = 0;
-
-        DataMessage data_message(
-            current_settings_ptr->service_priority,
-            client_configuration_struct.client_id,
-            current_settings_ptr->service_id,
-            number_object,
-            number_packet,
-            current_settings_ptr->number_packets,
-            dummy_payload.data(),    // pointer to payload; ensure you only read payload_size bytes
-            payload_size,
-            time_send
-        );
 
-        // Ensure data_message_buffer is large enough
-        if (data_message.length > data_message_buffer.size())
-        {
-            data_message_buffer.resize(data_message.length);
-        }
- 
-        //uint8_t interface_swap = 0;
-        clock_gettime(CLOCK_REALTIME, &time_now);
-        RM_logInfo("Traffic Genarator Object: " << number_object << " transmission start now: " << time_now.tv_sec << " s, " << time_now.tv_nsec << " ns");
-        
-        while(number_packet < current_settings_ptr->number_packets)
-        {
-            // Wait for permission to send
-            std::unique_lock<std::mutex> lock(global_mutex);
-            generator_conditioning_variable.wait(lock, [&] {
-                return (traffic_generator_control == THREAD_TRANSMISSION) || 
-                        traffic_generator_control == THREAD_TRANSMISSION_FINISH_OBJECT;
-            });
-            lock.unlock();
+/*
+*
+*/
+void TrafficGenerator::send_objects(bool mode_change_within_object)
+{
+    RM_logInfo("Traffic Generator Sending Thread " << std::to_string(thread_id) << " ObjectsBurstShaped IP started");
 
-            clock_gettime(CLOCK_REALTIME, &time_send);
-            data_message.set_timestamp(time_send);            
+    struct timespec time_now = {0,0};
 
-            // Sendout
-            data_message.dataToNet(data_message_buffer.data());
-            traffic_socket.send_to(boost::asio::buffer(data_message_buffer.data(), data_message.length), traffic_endpoint_target_new);
+    // Per-thread buffers (reserve once)
+    std::vector<char> dummy_payload(DataMessageTemplate::max_payload(traffic_pattern.message_version), 'A');
+    struct transmission_state state;
 
+    traffic_pattern.info_flag = false;
+    RM_logInfo("Traffic Generator ready for loop!") 
+    while (true)
+    {
+        // Wait for permission to send, blocks only while paused
+        if (generator_control.await_transmission(false) == THREAD_STOP)
+        {
+            break;
+        }
+        if (!apply_control(generator_control.snapshot(), state))
+        {
+            break;
+        }
 
-            ++number_packet;
-            payload_size = static_cast<size_t>(std::min<uint64_t>(remaining_bytes, demonstrator::MAX_PROTOCOL_MESSAGE_LENGTH));
-            data_message.set_payload_size(payload_size);
-            data_message.set_packet_number(number_packet);
+        begin_object(state, dummy_payload);
 
-            // Ensure data_message_buffer is large enough
-            if (data_message.length > data_message_buffer.size())
-            {
-                data_message_buffer.resize(data_message.length);
-            }
-            // Update remaining bytes
-            if (remaining_bytes > payload_size)
-            {
-                remaining_bytes -= payload_size;
-            }
-            else
+        while (state.fragment_number < state.payload.fragment_count)
+        {
+            // Asynchronous mode changes take effect with the next fragment of the running object
+            if (mode_change_within_object)
             {
-                remaining_bytes = 0;
+                uint32_t previous_mode = state.mode;
+                if (!apply_control(generator_control.snapshot(), state))
+                {
+                    break;
+                }
+                if (state.mode != previous_mode)
+                {
+                    resume_object(state);
+                }
             }
 
-
-            if (traffic_pattern.info_flag)
+            // Wait for permission to send, lock free unless paused
+            if (generator_control.await_transmission(true) == THREAD_STOP)
             {
-                clock_gettime(CLOCK_REALTIME, &time_now);
-                RM_logInfo("Mode " << std::to_string(current_mode) << " Fragment " << number_packet << " from Object: " << number_object << " start now: " << time_now.tv_sec << " s, " << time_now.tv_nsec << " ns");
+                RM_logInfo("Traffic Generator Thread stopped during transmitting object: " << state.object_number << " fragment number: " << state.fragment_number);
+                break;
             }
 
+            send_fragment(state);
+
             if (stop_thread)
             {
-                RM_logInfo("Traffic Generator Thread stopped during transmitting object: " << number_object << " fragment number: " << number_packet);
+                RM_logInfo("Traffic Generator Thread stopped during transmitting object: " << state.object_number << " fragment number: " << state.fragment_number);
                 break;
             }
-            // Pace
-            precise_wait_us(traffic_pattern.inter_packet_gap.count());
         }   
         
-        if (traffic_pattern.auto_traffic_termination > 0 && number_object >= traffic_pattern.auto_traffic_termination)
+        if (traffic_pattern.auto_traffic_termination > 0 && state.object_number >= traffic_pattern.auto_traffic_termination)
         {
             break;
         }      
 
-        number_object++;
+        state.object_number++;
 
         if (stop_thread)
         {
             break;
         }
 
-        struct timespec target_time = local_timestamp;
-        target_time.tv_nsec += current_settings_ptr->deadline * 1000000L;
-        if (target_time.tv_nsec >= 1000000000L) 
-        {
-            target_time.tv_sec += target_time.tv_nsec / 1000000000L;
-            target_time.tv_nsec %= 1000000000L;
-        }
-        if (traffic_pattern.info_flag)
-        {
-            RM_logInfo("target time before waiting : " << target_time.tv_sec << " s, " << target_time.tv_nsec << " ns");
-            clock_gettime(CLOCK_REALTIME, &time_now);
-            RM_logInfo("current_time before waiting: " << time_now.tv_sec << " s, " << time_now.tv_nsec << " ns");
-        }
+        transmit_path->drain_timestamps();
 
-        while (true)
+        // Next release on the timeline clock, computed from the anchor so no error accumulates
+        ++state.schedule_entry;
+        int64_t object_lateness_ns = wait_for_release(*state.plan->schedule, state.object_slot, state.schedule_entry, true);
+        if (object_lateness_ns < 0)
         {
-            if (traffic_generator_control == THREAD_TRANSMISSION_FINISH_OBJECT)
-            {
-                RM_logInfo("Traffic Generator Thread interrupted by change");
-                break;
-            }
-
-            clock_gettime(CLOCK_REALTIME, &time_now);
-
-            if ((time_now.tv_sec > target_time.tv_sec) ||
-                (time_now.tv_sec == target_time.tv_sec && time_now.tv_nsec >= target_time.tv_nsec))
-            {
-                break;
-            }
+            RM_logInfo("Traffic Generator Thread interrupted by change");
         }
 
         if (traffic_pattern.info_flag)
         {
-            clock_gettime(CLOCK_REALTIME, &time_now);
-            RM_logInfo("current_time after waiting : " << time_now.tv_sec << " s, " << time_now.tv_nsec << " ns");
+            time_now = object_pacing.now();
+            RM_logInfo("current_time after waiting : " << time_now.tv_sec << " s, " << time_now.tv_nsec << " ns" << " lateness: " << object_lateness_ns << " ns");
+            print_pacing_statistics();
         }
 
-        local_timestamp = target_time;
-
     } // while(true)
 
-    traffic_socket.close();
+    transmit_path->close();
+    print_pacing_statistics();
+    transmit_path->print_statistics();
     RM_logInfo("Traffic Generator Closing of sending thread: " << thread_id)
 }
 
@@ -411,308 +789,229 @@ void TrafficGenerator::send_objects_dynamic_change()
 /*
 *
 */
-void TrafficGenerator::send_objects_dynamic_change_asynchron()
+const struct transmission_plan* TrafficGenerator::plan_for(uint32_t mode) const
 {
-    RM_logInfo("Traffic Generator Sending Thread " << std::to_string(thread_id) << " ObjectsBurstShaped IP started");
+    auto plan_iterator = transmission_plans.find(mode);
+    if (plan_iterator == transmission_plans.end())
+    {
+        return nullptr;
+    }
+    return &plan_iterator->second;
+}
 
-    // Time vars
-    struct timespec time_now = {0,0};
-    struct timespec time_send = {0,0};
-    auto object_transmission_start = std::chrono::steady_clock::now();
-    auto current_time = std::chrono::steady_clock::now();
-    auto local_timepoint = std::chrono::steady_clock::now();
-    struct timespec local_timestamp;
 
-    long number_object = 1;
-    boost::asio::io_context io_context;
-    boost::asio::ip::udp::resolver resolver(io_context);
-    boost::asio::ip::udp::endpoint traffic_endpoint_target_new;
+/*
+*
+*/
+void TrafficGenerator::stamp_mode_notification()
+{
+    struct timespec time_notify;
+    clock_gettime(CLOCK_MONOTONIC, &time_notify);
+    mode_notify_ns.store(static_cast<int64_t>(time_notify.tv_sec) * 1000000000L + time_notify.tv_nsec, std::memory_order_release);
+}
 
-    // Per-thread buffers (reserve once)
-    std::vector<char> dummy_payload(demonstrator::MAX_PROTOCOL_MESSAGE_LENGTH, 'A');
-    std::vector<char> data_message_buffer;
-    data_message_buffer.reserve(demonstrator::MAX_PROTOCOL_MESSAGE_LENGTH);
 
-    // Log available modes
-    for (auto& setting_iterator : service_settings_struct)
-    {
-        uint32_t mode_id = setting_iterator.first;
-        auto& service_struct_iterator = setting_iterator.second;
+/*
+*
+*/
+void TrafficGenerator::record_mode_switch(const struct transmission_plan& plan, int64_t notify_ns, const struct timespec& period_start)
+{
+    struct timespec time_first_fragment;
+    clock_gettime(CLOCK_MONOTONIC, &time_first_fragment);
+    int64_t switch_latency_ns = static_cast<int64_t>(time_first_fragment.tv_sec) * 1000000000L + time_first_fragment.tv_nsec - notify_ns;
+    mode_switch_latency.record(switch_latency_ns > 0 ? switch_latency_ns : 0);
 
-        service_struct_iterator.number_packets = static_cast<uint32_t>((service_struct_iterator.object_size * 1024 + demonstrator::MAX_PROTOCOL_MESSAGE_LENGTH - 1) / demonstrator::MAX_PROTOCOL_MESSAGE_LENGTH);
-        service_struct_iterator.estimated_transmission_time_ms = service_struct_iterator.number_packets * (service_struct_iterator.inter_packet_gap.count() / 1e6 + demonstrator::MAX_PROTOCOL_MESSAGE_LENGTH * 8.0 / 1e9) * 1e3;
-               
-        RM_logInfo("########");
-        RM_logInfo("# Sending Mode      : " << std::to_string(mode_id));
-        RM_logInfo("# Sending Thread Mode, Thread ID " << std::to_string(thread_id) << " Destination IP : " << service_struct_iterator.ip_address << "  " << service_struct_iterator.port);
-        RM_logInfo("# Service ID        : " << service_struct_iterator.service_id);
-        RM_logInfo("# Deadline          : " << service_struct_iterator.deadline << " ms");
-        RM_logInfo("# Object size       : " << service_struct_iterator.object_size << " KB");
-        RM_logInfo("# Number of packets : " << service_struct_iterator.number_packets);
-        RM_logInfo("# Inter packet gap  : " << service_struct_iterator.inter_packet_gap.count());
-        RM_logInfo("# Slot offset       : " << service_struct_iterator.slot_offset);
-        RM_logInfo("# Slot length       : " << service_struct_iterator.slot_length);
-        RM_logInfo("# Estimated object transmission time : " << service_struct_iterator.estimated_transmission_time_ms << " ms");
-        RM_logInfo("########");
-    }
+    RM_logInfo("Traffic Generator mode " << plan.mode << " to " << plan.destination.address().to_string() << ":" << plan.destination.port()
+        << " first fragment " << switch_latency_ns << " ns after notification, period " << period_start.tv_sec << " s " << period_start.tv_nsec << " ns")
+}
 
-    // Validate initial mode_global
-    uint32_t current_mode = -1;
-    rscmng::config::service_settings current_settings;
-    const rscmng::config::service_settings* current_settings_ptr = nullptr;
 
-    traffic_pattern.info_flag = false;
-    RM_logInfo("Traffic Generator ready for loop!") 
-    while (true)
+/*
+*
+*/
+int64_t TrafficGenerator::wait_for_release(const TrafficSchedule& schedule, uint64_t& object_slot, uint32_t& schedule_entry, bool wait_slot_start)
+{
+    // Periods without a release are skipped, compiled schedules release at least one object
+    while (schedule_entry >= schedule.objects_in_period(object_slot))
     {
-        // Wait for permission to send
-        std::unique_lock<std::mutex> lock(global_mutex);
-        generator_conditioning_variable.wait(lock, [&] {
-            return (traffic_generator_control == THREAD_TRANSMISSION);
-        });
-        lock.unlock();
-       
-        if (current_mode != mode_global)
-        {
-            RM_logInfo("Traffic Generator change mode to: " << std::to_string(mode_global));
-
-            current_mode = mode_global;
-            auto iterator = service_settings_struct.find(current_mode);
-            if (iterator != service_settings_struct.end())
-            {
-                current_settings_ptr = &iterator->second;
-            }
-            else
-            {
-                RM_logInfo("Traffic Generator mode_global points to unknown setting: " << std::to_string(current_mode));
-                break;
-            }
-
-            const auto& settings = *current_settings_ptr;
-            RM_logInfo("########");
-            RM_logInfo("# Sending Mode      : " << std::to_string(iterator->first));
-            RM_logInfo("# Sending Thread Mode, Thread ID " << std::to_string(thread_id) << " Destination IP : " << settings.ip_address << "  " << settings.port);
-            RM_logInfo("# Service ID        : " << settings.service_id);
-            RM_logInfo("# Deadline          : " << settings.deadline << " ms");
-            RM_logInfo("# Object size       : " << settings.object_size << " KB");
-            RM_logInfo("# Number of packets : " << settings.number_packets);
-            RM_logInfo("# Inter packet gap  : " << settings.inter_packet_gap.count());
-            RM_logInfo("# Slot offset       : " << settings.slot_offset);
-            RM_logInfo("# Slot length       : " << settings.slot_length);
-            RM_logInfo("# Estimated object transmission time : " << settings.estimated_transmission_time_ms << " ms");
-            RM_logInfo("########");
-
-            // Rebuild the endpoint dynamically
-            auto results = resolver.resolve(
-                boost::asio::ip::udp::v4(),
-                settings.ip_address,
-                std::to_string(settings.port)
-            );
-
-            // Pick first resolved address
-            traffic_endpoint_target_new = *results.begin();
-            //update period
-            if (global_update_period)
-            {
-                local_timestamp = global_period_timestamp;
-                local_timepoint = std::chrono::steady_clock::time_point{
-                std::chrono::seconds(global_period_timestamp.tv_sec) + std::chrono::nanoseconds(global_period_timestamp.tv_nsec)
-                };
-                global_update_period = false;
-            }
-            
-            RM_logInfo("Traffic Generator Updated endpoint to " << traffic_endpoint_target_new.address().to_string() << ":" << traffic_endpoint_target_new.port())
-            RM_logInfo("Traffic Generator Updated period   to " << local_timestamp.tv_sec << " s " << local_timestamp.tv_nsec << " ns")
-        }
+        ++object_slot;
+        schedule_entry = 0;
+    }
 
-        
-        // Convert sizes to bytes and compute fragments
-        uint64_t remaining_bytes = current_settings_ptr->object_size * 1024;
-        size_t payload_size = static_cast<size_t>(std::min<uint64_t>(remaining_bytes, demonstrator::MAX_PROTOCOL_MESSAGE_LENGTH));
-        uint32_t number_packet = 0;
-
-        DataMessage data_message(
-            current_settings_ptr->service_priority,
-            client_configuration_struct.client_id,
-            current_settings_ptr->service_id,
-            number_object,
-            number_packet,
-            current_settings_ptr->number_packets,
-            dummy_payload.data(),    // pointer to payload; ensure you only read payload_size bytes
-            payload_size,
-            time_send
-        );
+    const struct object_release& release = schedule.release(object_slot, schedule_entry);
+    if (!wait_slot_start && release.offset_ns == 0)
+    {
+        return 0;
+    }
 
-        // Ensure data_message_buffer is large enough
-        if (data_message.length > data_message_buffer.size())
-        {
-            data_message_buffer.resize(data_message.length);
-        }
- 
-        //uint8_t interface_swap = 0;
-        clock_gettime(CLOCK_REALTIME, &time_now);
-        RM_logInfo("Traffic Genarator Object: " << number_object << " transmission start now: " << time_now.tv_sec << " s, " << time_now.tv_nsec << " ns");
-        
-        while(number_packet < current_settings_ptr->number_packets)
-        {
-            if (current_mode != mode_global)
-            {
-                RM_logInfo("Traffic Generator change mode to: " << std::to_string(mode_global));
+    struct timespec target_time = HyperperiodTimeline::to_timespec(object_timeline.slot_start(object_slot) + release.offset_ns);
+    if (traffic_pattern.info_flag)
+    {
+        struct timespec time_now = object_pacing.now();
+        RM_logInfo("target time before waiting : " << target_time.tv_sec << " s, " << target_time.tv_nsec << " ns");
+        RM_logInfo("current_time before waiting: " << time_now.tv_sec << " s, " << time_now.tv_nsec << " ns");
+    }
 
-                current_mode = mode_global;
-                auto iterator = service_settings_struct.find(current_mode);
-                if (iterator != service_settings_struct.end())
-                {
-                    current_settings_ptr = &iterator->second;
-                }
-                else
-                {
-                    RM_logInfo("Traffic Generator mode_global points to unknown setting: " << std::to_string(current_mode));
-                    break;
-                }
+    return object_pacing.wait_until(target_time, [this] {
+        return generator_control.state() == THREAD_TRANSMISSION_FINISH_OBJECT;
+    });
+}
 
-                const auto& settings = *current_settings_ptr;
-                RM_logInfo("########");
-                RM_logInfo("# Sending Mode      : " << std::to_string(iterator->first));
-                RM_logInfo("# Sending Thread Mode, Thread ID " << std::to_string(thread_id) << " Destination IP : " << settings.ip_address << "  " << settings.port);
-                RM_logInfo("# Service ID        : " << settings.service_id);
-                RM_logInfo("# Deadline          : " << settings.deadline << " ms");
-                RM_logInfo("# Object size       : " << settings.object_size << " KB");
-                RM_logInfo("# Number of packets : " << settings.number_packets);
-                RM_logInfo("# Inter packet gap  : " << settings.inter_packet_gap.count());
-                RM_logInfo("# Slot offset       : " << settings.slot_offset);
-                RM_logInfo("# Slot length       : " << settings.slot_length);
-                RM_logInfo("# Estimated object transmission time : " << settings.estimated_transmission_time_ms << " ms");
-                RM_logInfo("########");
-
-                // Rebuild the endpoint dynamically
-                auto results = resolver.resolve(
-                    boost::asio::ip::udp::v4(),
-                    settings.ip_address,
-                    std::to_string(settings.port)
-                );
-
-                traffic_endpoint_target_new = *results.begin();                
-                if (global_update_period)
-                {
-                    local_timestamp = global_period_timestamp;
-                    local_timepoint = std::chrono::steady_clock::time_point{
-                    std::chrono::seconds(global_period_timestamp.tv_sec) + std::chrono::nanoseconds(global_period_timestamp.tv_nsec)
-                    };
-                    global_update_period = false;
-                }
-                
-                RM_logInfo("Traffic Generator Updated endpoint to " << traffic_endpoint_target_new.address().to_string() << ":" << traffic_endpoint_target_new.port())
-                RM_logInfo("Traffic Generator Updated period   to " << local_timestamp.tv_sec << " s " << local_timestamp.tv_nsec << " ns")
-            }
 
-            // Wait for permission to send
-            std::unique_lock<std::mutex> lock(global_mutex);
-            generator_conditioning_variable.wait(lock, [&] {
-                return (traffic_generator_control == THREAD_TRANSMISSION) || 
-                        traffic_generator_control == THREAD_TRANSMISSION_FINISH_OBJECT;
-            });
-            lock.unlock();
+/*
+*
+*/
+bool TrafficGenerator::apply_control(const control_snapshot& control, struct transmission_state& state)
+{
+    if (control.mode == state.mode)
+    {
+        return true;
+    }
 
-            clock_gettime(CLOCK_REALTIME, &time_send);
-            data_message.set_timestamp(time_send);            
+    // Mode switch, the plan of every mode is compiled at construction
+    const struct transmission_plan* next_plan = plan_for(control.mode);
+    if (next_plan == nullptr)
+    {
+        RM_logInfo("Traffic Generator mode points to unknown setting: " << std::to_string(control.mode));
+        return false;
+    }
+    state.mode = control.mode;
+    state.plan = next_plan;
+    state.switch_notify_ns = mode_notify_ns.load(std::memory_order_acquire);
 
-            // Sendout
-            data_message.dataToNet(data_message_buffer.data());
-            traffic_socket.send_to(boost::asio::buffer(data_message_buffer.data(), data_message.length), traffic_endpoint_target_new);
+    if (control.period_version != state.period_version)
+    {
+        // Period timestamps are CLOCK_REALTIME, the timeline anchors once on its own clock
+        object_timeline.anchor(object_timeline.from_realtime(control.period_timestamp), next_plan->deadline_ns);
+        state.period_version = control.period_version;
+    }
+    else if (object_timeline.anchored() && object_timeline.period() != next_plan->deadline_ns)
+    {
+        // New period from the start of the current object on
+        object_timeline.rebase(state.object_slot, next_plan->deadline_ns);
+    }
+    else
+    {
+        return true;
+    }
+    state.object_slot = 0;
+    state.schedule_entry = 0;
+    state.release_pending = true;
+    return true;
+}
 
 
-            ++number_packet;
-            payload_size = static_cast<size_t>(std::min<uint64_t>(remaining_bytes, demonstrator::MAX_PROTOCOL_MESSAGE_LENGTH));
-            data_message.set_payload_size(payload_size);
-            data_message.set_packet_number(number_packet);
+/*
+*
+*/
+void TrafficGenerator::begin_object(struct transmission_state& state, const std::vector<char>& dummy_payload)
+{
+    const struct transmission_plan& plan = *state.plan;
 
-            // Ensure data_message_buffer is large enough
-            if (data_message.length > data_message_buffer.size())
-            {
-                data_message_buffer.resize(data_message.length);
-            }
-            // Update remaining bytes
-            if (remaining_bytes > payload_size)
-            {
-                remaining_bytes -= payload_size;
-            }
-            else
-            {
-                remaining_bytes = 0;
-            }
+    // Without a period timestamp the timeline starts with the first object
+    if (!object_timeline.anchored())
+    {
+        object_timeline.anchor(object_timeline.now(), plan.deadline_ns);
+        state.object_slot = 0;
+        state.schedule_entry = 0;
+    }
+    // After a new anchor the first release may lie inside its slot
+    if (state.release_pending)
+    {
+        wait_for_release(*plan.schedule, state.object_slot, state.schedule_entry, false);
+        state.release_pending = false;
+    }
+    const struct object_release& release = plan.schedule->release(state.object_slot, state.schedule_entry);
 
+    // Object payload (mapped frame or dummy payload), its size determines the fragment count
+    state.payload = next_payload(plan, release.size_bytes, dummy_payload);
+    state.remaining_bytes = state.payload.size;
+    state.fragment_payload = plan.max_payload;
+    state.payload_size = static_cast<size_t>(std::min<uint64_t>(state.remaining_bytes, state.fragment_payload));
+    state.fragment_number = 0;
 
-            if (traffic_pattern.info_flag)
-            {
-                clock_gettime(CLOCK_REALTIME, &time_now);
-                RM_logInfo("Mode " << std::to_string(current_mode) << " Fragment " << number_packet << " from Object: " << number_object << " start now: " << time_now.tv_sec << " s, " << time_now.tv_nsec << " ns");
-            }
+    // Constant header fields are serialized in the plan, the payload is referenced, not copied
+    state.header_template = plan.header_template;
+    state.header_template.begin_object(state.object_number, state.payload.fragment_count);
 
-            if (stop_thread)
-            {
-                RM_logInfo("Traffic Generator Thread stopped during transmitting object: " << number_object << " fragment number: " << number_packet);
-                break;
-            }
-            // Pace
-            precise_wait_us(traffic_pattern.inter_packet_gap.count());
-        }   
-        
-        if (traffic_pattern.auto_traffic_termination > 0 && number_object >= traffic_pattern.auto_traffic_termination)
-        {
-            break;
-        }      
+    struct timespec time_now = {0,0};
+    clock_gettime(CLOCK_REALTIME, &time_now);
+    RM_logInfo("Traffic Genarator Object: " << state.object_number << " transmission start now: " << time_now.tv_sec << " s, " << time_now.tv_nsec << " ns");
+    state.fragment_deadline = packet_pacing.now();
+    // Launch times of the object are relative to its release
+    state.object_launch_time = object_timeline.to_realtime(object_timeline.slot_start(state.object_slot) + release.offset_ns);
+}
 
-        number_object++;
 
-        if (stop_thread)
-        {
-            break;
-        }
+/*
+*
+*/
+void TrafficGenerator::send_fragment(struct transmission_state& state)
+{
+    const struct transmission_plan& plan = *state.plan;
+    const int64_t inter_packet_gap_ns = plan.inter_packet_gap_ns;
 
-        struct timespec target_time = local_timestamp;
-        target_time.tv_nsec += current_settings_ptr->deadline * 1000000L;
-        if (target_time.tv_nsec >= 1000000000L) 
-        {
-            target_time.tv_sec += target_time.tv_nsec / 1000000000L;
-            target_time.tv_nsec %= 1000000000L;
-        }
-        if (traffic_pattern.info_flag)
+    struct timespec time_send = {0,0};
+    clock_gettime(CLOCK_REALTIME, &time_send);
+    state.header_template.patch(state.fragment_number, time_send, state.payload_size);
+    if (state.fragment_number > 0)
+    {
+        // Deviation of the achieved from the configured gap between consecutive fragments of an object
+        int64_t gap_error_ns = PacingEngine::diff_ns(time_send, state.previous_send) - inter_packet_gap_ns;
+        packet_gap_error.record(gap_error_ns < 0 ? -gap_error_ns : gap_error_ns);
+    }
+    state.previous_send = time_send;
+    transmit_path->register_fragment(plan.settings->service_id, state.object_number, state.fragment_number, time_send);
+
+    // Sendout
+    uint32_t fragments_sent = transmit_path->transmit_fragment(
+        state.header_template,
+        state.payload.data + state.payload.fragment_stride * state.fragment_number,
+        state.payload_size,
+        plan.destination,
+        state.fragment_number + 1 >= state.payload.fragment_count,
+        PacingEngine::add_ns(state.object_launch_time, inter_packet_gap_ns * state.fragment_number)
+    );
+    ++sent_fragment_count;
+    sent_byte_count += state.header_template.size() + state.payload_size;
+    transmit_path->poll_timestamps();
+
+    if (state.switch_notify_ns >= 0)
+    {
+        if (state.switch_notify_ns > 0)
         {
-            RM_logInfo("target time before waiting : " << target_time.tv_sec << " s, " << target_time.tv_nsec << " ns");
-            clock_gettime(CLOCK_REALTIME, &time_now);
-            RM_logInfo("current_time before waiting: " << time_now.tv_sec << " s, " << time_now.tv_nsec << " ns");
+            record_mode_switch(plan, state.switch_notify_ns, state.object_launch_time);
         }
+        state.switch_notify_ns = -1;
+    }
 
-        while (true)
-        {
-            if (traffic_generator_control == THREAD_TRANSMISSION_FINISH_OBJECT)
-            {
-                RM_logInfo("Traffic Generator Thread interrupted by change");
-                break;
-            }
+    ++state.fragment_number;
+    // The last fragment carries the rest of the object
+    state.remaining_bytes -= std::min<uint64_t>(state.remaining_bytes, state.payload_size);
+    state.payload_size = static_cast<size_t>(std::min<uint64_t>(state.remaining_bytes, state.fragment_payload));
 
-            clock_gettime(CLOCK_REALTIME, &time_now);
+    if (traffic_pattern.info_flag)
+    {
+        struct timespec time_now = {0,0};
+        clock_gettime(CLOCK_REALTIME, &time_now);
+        RM_logInfo("Mode " << std::to_string(state.mode) << " Fragment " << state.fragment_number << " from Object: " << state.object_number << " start now: " << time_now.tv_sec << " s, " << time_now.tv_nsec << " ns");
+    }
 
-            if ((time_now.tv_sec > target_time.tv_sec) ||
-                (time_now.tv_sec == target_time.tv_sec && time_now.tv_nsec >= target_time.tv_nsec))
-            {
-                break;
-            }
+    // Pace against absolute deadlines (once per batch), rebase after a stall to avoid a catch-up burst
+    // The launch time backend paces itself
+    if (inter_packet_gap_ns > 0 && fragments_sent > 0 && transmit_path->backend() != TRANSMIT_TXTIME && !stop_thread)
+    {
+        state.fragment_deadline = PacingEngine::add_ns(state.fragment_deadline, inter_packet_gap_ns * fragments_sent);
+        int64_t lateness_ns = packet_pacing.wait_until(state.fragment_deadline);
+        if (lateness_ns > inter_packet_gap_ns * fragments_sent)
+        {
+            state.fragment_deadline = packet_pacing.now();
         }
-
         if (traffic_pattern.info_flag)
         {
-            clock_gettime(CLOCK_REALTIME, &time_now);
-            RM_logInfo("current_time after waiting : " << time_now.tv_sec << " s, " << time_now.tv_nsec << " ns");
+            RM_logInfo("Mode " << std::to_string(state.mode) << " Fragment " << state.fragment_number << " from Object: " << state.object_number << " pacing lateness: " << lateness_ns << " ns");
         }
-
-        local_timestamp = target_time;
-
-    } // while(true)
-
-    traffic_socket.close();
-    RM_logInfo("Traffic Generator Closing of sending thread: " << thread_id)
+    }
 }
 
 
@@ -722,16 +1021,22 @@ void TrafficGenerator::send_objects_dynamic_change_asynchron()
 void TrafficGenerator::thread_type_select ()
 {
     RM_logInfo("Traffic Generator Thread is starting ..." << "\n")
+    RealtimeProfile::instance().apply(RT_THREAD_GENERATOR);
     if (experiment_parameter_struct.synchronous_start_mode == true)
     {
         RM_logInfo("Sending Thread " << thread_id << " OBJECT_BURST_DYNAMIC_CHANGE" << " SYNCHRONOUS\n")
-        send_objects_dynamic_change();
+        send_objects(false);
     }
     else if (experiment_parameter_struct.synchronous_start_mode == false)
     {
         RM_logInfo("Sending Thread " << thread_id << " OBJECT_BURST_DYNAMIC_CHANGE" << " ASYNCHRONOUS\n")
-        send_objects_dynamic_change_asynchron();
+        send_objects(true);
     }  
+    RealtimeProfile::log_page_faults("Traffic Generator thread " + std::to_string(thread_id), true);
+
+    struct timespec thread_cpu_time;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &thread_cpu_time);
+    thread_cpu_ns = HyperperiodTimeline::to_ns(thread_cpu_time);
 }
 
 
@@ -740,6 +1045,8 @@ void TrafficGenerator::thread_type_select ()
 */
 void TrafficGenerator::join()
 {
-    traffic_generator.join();
-
+    if (traffic_generator.joinable())
+    {
+        traffic_generator.join();
+    }
 }
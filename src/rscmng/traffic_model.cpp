@@ -0,0 +1,544 @@
+// Copyright (C) 2025 IDA
+//
+// This file is part of a project licensed under the GNU Lesser General Public License v3.0.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <limits>
+
+#include <rscmng/traffic_model.hpp>
+
+
+using namespace traffic_generator;
+
+
+/*
+*
+*/
+SizeDistribution::SizeDistribution(const struct rscmng::config::traffic_model_settings& settings, uint64_t mean_bytes)
+:
+    distribution_type(SIZE_CONSTANT),
+    mean_bytes(static_cast<double>(mean_bytes)),
+    min_bytes(settings.size_min_kb * 1024.0),
+    max_bytes(settings.size_max_kb * 1024.0),
+    stddev_bytes(settings.size_stddev_kb * 1024.0)
+{
+    if (settings.size_distribution == "UNIFORM")
+    {
+        distribution_type = SIZE_UNIFORM;
+    }
+    else if (settings.size_distribution == "NORMAL")
+    {
+        distribution_type = SIZE_NORMAL;
+    }
+    else if (settings.size_distribution == "EXPONENTIAL")
+    {
+        distribution_type = SIZE_EXPONENTIAL;
+    }
+    else if (settings.size_distribution != "CONSTANT")
+    {
+        RM_logWarning("Unknown object size distribution " << settings.size_distribution << ", using CONSTANT")
+    }
+
+    // Without SIZE_MIN / SIZE_MAX the sizes stay within [1 byte, 2 x OBJECT_SIZE]
+    if (min_bytes < 1)
+    {
+        min_bytes = 1;
+    }
+    if (max_bytes <= 0)
+    {
+        max_bytes = std::max(2.0 * this->mean_bytes, min_bytes);
+        if (distribution_type != SIZE_CONSTANT)
+        {
+            RM_logInfo("Object size distribution " << settings.size_distribution << " without " << TRAFFIC_MODEL_SIZE_MAX
+                << ", sizes bounded to [" << min_bytes << ", " << max_bytes << "] bytes")
+        }
+    }
+    if (max_bytes < min_bytes)
+    {
+        RM_logWarning("Object size distribution " << TRAFFIC_MODEL_SIZE_MAX << " below " << TRAFFIC_MODEL_SIZE_MIN << ", using " << min_bytes << " bytes")
+        max_bytes = min_bytes;
+    }
+    max_bytes = std::min(max_bytes, static_cast<double>(std::numeric_limits<uint32_t>::max()));
+
+    if (distribution_type == SIZE_NORMAL && stddev_bytes <= 0)
+    {
+        stddev_bytes = this->mean_bytes / 4.0;
+        RM_logWarning("Object size distribution NORMAL without " << TRAFFIC_MODEL_SIZE_STDDEV << ", using " << stddev_bytes << " bytes (OBJECT_SIZE / 4)")
+    }
+
+    // Mean of the exponential distribution truncated to [SIZE_MIN, SIZE_MAX]
+    if (distribution_type == SIZE_EXPONENTIAL && this->mean_bytes > 0)
+    {
+        const double rate = 1.0 / this->mean_bytes;
+        const double tail_min = std::exp(-rate * min_bytes);
+        const double tail_max = std::exp(-rate * max_bytes);
+        const double truncated_mean = this->mean_bytes + (min_bytes * tail_min - max_bytes * tail_max) / (tail_min - tail_max);
+        if (std::abs(truncated_mean - this->mean_bytes) > 0.05 * this->mean_bytes)
+        {
+            RM_logWarning("Object size distribution EXPONENTIAL truncated to [" << min_bytes << ", " << max_bytes
+                << "] bytes has a mean of " << std::llround(truncated_mean) << " bytes instead of " << this->mean_bytes)
+        }
+    }
+}
+
+
+/*
+*
+*/
+uint32_t SizeDistribution::sample(std::mt19937_64& generator) const
+{
+    if (distribution_type == SIZE_CONSTANT)
+    {
+        return static_cast<uint32_t>(std::llround(std::min(std::max(mean_bytes, min_bytes), max_bytes)));
+    }
+
+    double size = mean_bytes;
+    for (uint32_t draw = 0; draw < SIZE_DISTRIBUTION_MAX_REDRAWS; draw++)
+    {
+        switch (distribution_type)
+        {
+            case SIZE_UNIFORM:
+            {
+                std::uniform_real_distribution<double> uniform(min_bytes, max_bytes);
+                size = uniform(generator);
+                break;
+            }
+            case SIZE_NORMAL:
+            {
+                std::normal_distribution<double> normal(mean_bytes, stddev_bytes);
+                size = normal(generator);
+                break;
+            }
+            case SIZE_EXPONENTIAL:
+            {
+                std::exponential_distribution<double> exponential(1.0 / std::max(mean_bytes, 1.0));
+                size = exponential(generator);
+                break;
+            }
+            default:
+                break;
+        }
+        if (size >= min_bytes && size <= max_bytes)
+        {
+            break;
+        }
+    }
+
+    // Bounds far in the tail: clamp after the last draw
+    size = std::min(std::max(size, min_bytes), max_bytes);
+    return static_cast<uint32_t>(std::llround(size));
+}
+
+
+/*
+*
+*/
+bool SizeDistribution::constant() const
+{
+    return distribution_type == SIZE_CONSTANT;
+}
+
+
+/*
+*
+*/
+uint32_t TrafficModel::natural_periods(int64_t period_ns) const
+{
+    (void)period_ns;
+    return 0;
+}
+
+
+/*
+*
+*/
+PeriodicModel::PeriodicModel(const SizeDistribution& sizes)
+:
+    sizes(sizes)
+{
+
+}
+
+
+/*
+*
+*/
+void PeriodicModel::generate(int64_t period_ns, uint32_t periods, std::mt19937_64& generator, std::vector<struct object_release>& releases) const
+{
+    for (uint32_t period = 0; period < periods; period++)
+    {
+        struct object_release release;
+        release.offset_ns = static_cast<int64_t>(period) * period_ns;
+        release.size_bytes = sizes.sample(generator);
+        releases.push_back(release);
+    }
+}
+
+
+/*
+*
+*/
+uint32_t PeriodicModel::natural_periods(int64_t period_ns) const
+{
+    (void)period_ns;
+    // A constant object needs a single period
+    return sizes.constant() ? 1 : 0;
+}
+
+
+/*
+*
+*/
+std::string PeriodicModel::name() const
+{
+    return "PERIODIC";
+}
+
+
+/*
+*
+*/
+PoissonModel::PoissonModel(double rate_per_second, const SizeDistribution& sizes)
+:
+    rate_per_second(rate_per_second),
+    sizes(sizes)
+{
+
+}
+
+
+/*
+*
+*/
+void PoissonModel::generate(int64_t period_ns, uint32_t periods, std::mt19937_64& generator, std::vector<struct object_release>& releases) const
+{
+    if (rate_per_second <= 0)
+    {
+        return;
+    }
+
+    const double horizon_ns = static_cast<double>(period_ns) * periods;
+    std::exponential_distribution<double> inter_arrival(rate_per_second / 1e9);
+
+    for (double arrival_ns = inter_arrival(generator); arrival_ns < horizon_ns; arrival_ns += inter_arrival(generator))
+    {
+        struct object_release release;
+        release.offset_ns = static_cast<int64_t>(arrival_ns);
+        release.size_bytes = sizes.sample(generator);
+        releases.push_back(release);
+    }
+}
+
+
+/*
+*
+*/
+std::string PoissonModel::name() const
+{
+    return "POISSON";
+}
+
+
+/*
+*
+*/
+OnOffModel::OnOffModel(double rate_per_second, uint32_t mean_on_ms, uint32_t mean_off_ms, const SizeDistribution& sizes)
+:
+    rate_per_second(rate_per_second),
+    mean_on_ns(mean_on_ms * 1e6),
+    mean_off_ns(mean_off_ms * 1e6),
+    sizes(sizes)
+{
+
+}
+
+
+/*
+*
+*/
+void OnOffModel::generate(int64_t period_ns, uint32_t periods, std::mt19937_64& generator, std::vector<struct object_release>& releases) const
+{
+    const double horizon_ns = static_cast<double>(period_ns) * periods;
+    // Without a rate the source sends one object per period while on
+    const double arrival_gap_ns = rate_per_second > 0 ? 1e9 / rate_per_second : static_cast<double>(period_ns);
+    std::exponential_distribution<double> on_phase(1.0 / std::max(mean_on_ns, 1.0));
+    std::exponential_distribution<double> off_phase(1.0 / std::max(mean_off_ns, 1.0));
+
+    double phase_start_ns = 0;
+    while (phase_start_ns < horizon_ns)
+    {
+        double phase_end_ns = std::min(phase_start_ns + on_phase(generator), horizon_ns);
+        for (double arrival_ns = phase_start_ns; arrival_ns < phase_end_ns; arrival_ns += arrival_gap_ns)
+        {
+            struct object_release release;
+            release.offset_ns = static_cast<int64_t>(arrival_ns);
+            release.size_bytes = sizes.sample(generator);
+            releases.push_back(release);
+        }
+        phase_start_ns = phase_end_ns + (mean_off_ns > 0 ? off_phase(generator) : 0);
+    }
+}
+
+
+/*
+*
+*/
+std::string OnOffModel::name() const
+{
+    return "ON_OFF";
+}
+
+
+/*
+*
+*/
+TraceModel::TraceModel(std::string trace_path)
+:
+    trace_path(trace_path)
+{
+    std::ifstream trace_file(trace_path);
+    if (!trace_file.is_open())
+    {
+        RM_logWarning("Traffic trace " << trace_path << " not readable")
+        return;
+    }
+
+    std::string line;
+    double first_time_ms = -1;
+    while (std::getline(trace_file, line))
+    {
+        size_t comment = line.find('#');
+        if (comment != std::string::npos)
+        {
+            line.erase(comment);
+        }
+
+        std::istringstream record_stream(line);
+        double time_ms;
+        double size_bytes;
+        if (!(record_stream >> time_ms >> size_bytes))
+        {
+            continue;
+        }
+        if (first_time_ms < 0)
+        {
+            first_time_ms = time_ms;
+        }
+
+        struct object_release record;
+        record.offset_ns = static_cast<int64_t>(std::llround((time_ms - first_time_ms) * 1e6));
+        record.size_bytes = static_cast<uint32_t>(std::max(size_bytes, 1.0));
+        records.push_back(record);
+    }
+
+    std::sort(records.begin(), records.end(), [](const struct object_release& a, const struct object_release& b) {
+        return a.offset_ns < b.offset_ns;
+    });
+    RM_logInfo("Traffic trace " << trace_path << " loaded " << records.size() << " objects")
+}
+
+
+/*
+*
+*/
+bool TraceModel::valid() const
+{
+    return !records.empty();
+}
+
+
+/*
+*
+*/
+void TraceModel::generate(int64_t period_ns, uint32_t periods, std::mt19937_64& generator, std::vector<struct object_release>& releases) const
+{
+    (void)generator;
+    const int64_t horizon_ns = period_ns * periods;
+    for (const auto& record : records)
+    {
+        if (record.offset_ns >= horizon_ns)
+        {
+            break;
+        }
+        releases.push_back(record);
+    }
+}
+
+
+/*
+*
+*/
+uint32_t TraceModel::natural_periods(int64_t period_ns) const
+{
+    if (records.empty() || period_ns <= 0)
+    {
+        return 1;
+    }
+    return static_cast<uint32_t>(records.back().offset_ns / period_ns + 1);
+}
+
+
+/*
+*
+*/
+std::string TraceModel::name() const
+{
+    return "TRACE " + trace_path;
+}
+
+
+/*
+*
+*/
+TrafficSchedule::TrafficSchedule(const TrafficModel& model, int64_t period_ns, uint32_t periods, uint32_t seed)
+:
+    compiled_bytes(0)
+{
+    if (period_ns <= 0)
+    {
+        period_ns = 1;
+    }
+    uint32_t natural_periods = model.natural_periods(period_ns);
+    if (natural_periods > 0)
+    {
+        periods = natural_periods;
+    }
+    if (periods == 0)
+    {
+        periods = 1;
+    }
+
+    std::mt19937_64 generator(seed);
+    std::vector<struct object_release> generated;
+    model.generate(period_ns, periods, generator, generated);
+
+    // Bucket the releases by period, offsets become relative to the period start
+    period_begin.assign(periods + 1, 0);
+    for (const auto& release : generated)
+    {
+        uint64_t period = static_cast<uint64_t>(release.offset_ns / period_ns);
+        if (release.offset_ns >= 0 && period < periods)
+        {
+            ++period_begin[period + 1];
+        }
+    }
+    for (uint32_t period = 0; period < periods; period++)
+    {
+        period_begin[period + 1] += period_begin[period];
+    }
+
+    releases.resize(period_begin[periods]);
+    std::vector<uint32_t> fill(period_begin.begin(), period_begin.end() - 1);
+    for (const auto& release : generated)
+    {
+        uint64_t period = static_cast<uint64_t>(release.offset_ns / period_ns);
+        if (release.offset_ns < 0 || period >= periods)
+        {
+            continue;
+        }
+        struct object_release& entry = releases[fill[period]++];
+        entry.offset_ns = release.offset_ns - static_cast<int64_t>(period) * period_ns;
+        entry.size_bytes = release.size_bytes;
+        compiled_bytes += release.size_bytes;
+    }
+
+    RM_logInfo("Traffic model " << model.name() << " compiled " << releases.size() << " objects in " << periods << " periods, "
+        << compiled_bytes / 1024 << " KB")
+}
+
+
+/*
+*
+*/
+uint32_t TrafficSchedule::objects_in_period(uint64_t period) const
+{
+    uint64_t compiled_period = period % (period_begin.size() - 1);
+    return period_begin[compiled_period + 1] - period_begin[compiled_period];
+}
+
+
+/*
+*
+*/
+const struct object_release& TrafficSchedule::release(uint64_t period, uint32_t index) const
+{
+    uint64_t compiled_period = period % (period_begin.size() - 1);
+    return releases[period_begin[compiled_period] + index];
+}
+
+
+/*
+*
+*/
+uint32_t TrafficSchedule::period_count() const
+{
+    return static_cast<uint32_t>(period_begin.size() - 1);
+}
+
+
+/*
+*
+*/
+uint64_t TrafficSchedule::release_count() const
+{
+    return releases.size();
+}
+
+
+/*
+*
+*/
+uint64_t TrafficSchedule::total_bytes() const
+{
+    return compiled_bytes;
+}
+
+
+/*
+*
+*/
+std::unique_ptr<TrafficModel> traffic_generator::make_traffic_model(const struct rscmng::config::service_settings& settings)
+{
+    const struct rscmng::config::traffic_model_settings& model_settings = settings.traffic_model;
+    SizeDistribution sizes(model_settings, static_cast<uint64_t>(settings.object_size) * 1024);
+
+    if (model_settings.type == "POISSON")
+    {
+        return std::unique_ptr<TrafficModel>(new PoissonModel(model_settings.rate_per_second, sizes));
+    }
+    if (model_settings.type == "ON_OFF")
+    {
+        return std::unique_ptr<TrafficModel>(new OnOffModel(model_settings.rate_per_second, model_settings.on_ms, model_settings.off_ms, sizes));
+    }
+    if (model_settings.type == "TRACE")
+    {
+        std::unique_ptr<TraceModel> trace_model(new TraceModel(model_settings.trace_path));
+        if (trace_model->valid())
+        {
+            return std::unique_ptr<TrafficModel>(trace_model.release());
+        }
+        RM_logWarning("Traffic trace " << model_settings.trace_path << " is empty, using PERIODIC")
+    }
+    else if (model_settings.type != "PERIODIC")
+    {
+        RM_logWarning("Unknown traffic model " << model_settings.type << ", using PERIODIC")
+    }
+    return std::unique_ptr<TrafficModel>(new PeriodicModel(sizes));
+}
@@ -27,21 +27,76 @@ using namespace traffic_statistic;
 using namespace boost::placeholders;
 
 
+/*
+*
+*/
+ReceiveBackend traffic_statistic::receive_backend_from_string(std::string backend_name)
+{
+    if (backend_name == "BATCH")
+    {
+        return RECEIVE_BATCH;
+    }
+    if (backend_name == "KERNEL")
+    {
+        return RECEIVE_KERNEL;
+    }
+    if (backend_name != "SOCKET")
+    {
+        RM_logWarning("Unknown receive backend " << backend_name << ", using SOCKET")
+    }
+    return RECEIVE_SOCKET;
+}
+
+
 /*
 *
 */
 TrafficSink::TrafficSink(
     std::string local_ip_address,
     std::vector<uint32_t> client_local_port,
-    std::condition_variable &traffic_generator_notify
+    std::condition_variable &traffic_generator_notify,
+    traffic_sink_parameter sink_parameter
 ):
-    traffic_generator_notify(traffic_generator_notify)
+    sink_parameter(sink_parameter),
+    local_ip_address(local_ip_address),
+    traffic_generator_notify(traffic_generator_notify),
+    record_writer(FILENAME_LOG)
 {
+    this->sink_parameter.shards = std::max(1U, sink_parameter.shards);
+    for (uint32_t shard = 0; shard < this->sink_parameter.shards; ++shard)
+    {
+        shard_statistics.emplace_back(new SinkStatistics(static_cast<uint32_t>(sink_parameter.service_deadlines_ns.size())));
+        for (const auto& deadline : sink_parameter.service_deadlines_ns)
+        {
+            shard_statistics.back()->register_service(deadline.first, deadline.second, sink_parameter.variable_size_services.count(deadline.first) == 0);
+        }
+    }
+
     if (local_ip_address == "" || client_local_port.empty())
     {
         RM_logInfo("Traffic sink parameter are not valid!");
         //return;
     }
+    else if (sink_parameter.event_loop && sink_parameter.receive_backend != RECEIVE_KERNEL)
+    {
+        for (size_t iterator = 0; iterator < client_local_port.size(); ++iterator)
+        {
+            register_event_port(local_ip_address, client_local_port[iterator]);
+        }
+    }
+    else if (this->sink_parameter.shards > 1)
+    {
+        for (size_t iterator = 0; iterator < client_local_port.size(); ++iterator)
+        {
+            std::vector<std::unique_ptr<udp::socket>> sockets = open_port_sockets(local_ip_address, client_local_port[iterator], false);
+            for (uint32_t shard = 0; shard < sockets.size(); ++shard)
+            {
+                traffic_generator_list.emplace_back(&TrafficSink::run_shard, this, sockets[shard].get(), shard);
+                shard_sockets.push_back(std::move(sockets[shard]));
+            }
+            RM_logInfo("Traffic sink start initialization: " << local_ip_address << " " << client_local_port[iterator] << " with " << sockets.size() << " shards");
+        }
+    }
     else
     {
         for (size_t iterator = 0; iterator < client_local_port.size(); ++iterator)
@@ -59,7 +114,17 @@ TrafficSink::TrafficSink(
 */
 TrafficSink::~TrafficSink()
 {
-
+    if (sink_parameter.event_loop && !event_ports.empty())
+    {
+        // The callbacks reference the ports, only they leave the loop, which is shared by all sinks of the host
+        for (auto& port : event_ports)
+        {
+            sink_parameter.event_loop->remove(port->socket->native_handle());
+        }
+        // Sockets before the io_context they were opened with
+        event_ports.clear();
+    }
+    print_statistics();
 }
 
 /*
@@ -67,6 +132,7 @@ TrafficSink::~TrafficSink()
 */
 void TrafficSink::initialize_sink_port(std::string local_ip_address, uint32_t local_port)
 {
+    rscmng::RealtimeProfile::instance().apply(RT_THREAD_SINK);
     boost::asio::io_context traffic_context;
     udp::endpoint traffic_endpoint_local(boost::asio::ip::address::from_string(local_ip_address), local_port);
     udp::socket traffic_socket(traffic_context);
@@ -93,72 +159,371 @@ void TrafficSink::initialize_sink_port(std::string local_ip_address, uint32_t lo
 /*
 *
 */
-void TrafficSink::handle_message(udp::socket &traffic_socket)
+void TrafficSink::handle_message(udp::socket &traffic_socket, uint32_t shard)
 {
-    DataMessage data_message;
-    FILE *fp;
-    size_t recv_length;
-    long received_object_number = 0;
-    long received_packet_number = 0;    
-    struct timespec time_received = {0,0}; 
-    struct timespec time_start = {0,0};    
-    std::chrono::system_clock::time_point time_start_2; 
-    std::vector<char> data_message_buffer(demonstrator::MAX_PROTOCOL_MESSAGE_LENGTH);
-    size_t message_buffer_size = 0;
-    udp::endpoint source_address;
+    if (sink_parameter.receive_backend == RECEIVE_BATCH)
+    {
+        std::unique_ptr<struct sink_port> port = prepare_port(traffic_socket, sink_parameter.batch_size, shard);
+        while (true)
+        {
+            receive_batch(*port);
+        }
+    }
+    else if (sink_parameter.receive_backend == RECEIVE_KERNEL)
+    {
+        receive_kernel(traffic_socket, shard);
+    }
+    else
+    {
+        std::unique_ptr<struct sink_port> port = prepare_port(traffic_socket, 0, shard);
+        receive_single(traffic_socket, *port);
+    }
+}
+
 
+/*
+*
+*/
+void TrafficSink::join()
+{
+    if (sink_parameter.event_loop && !event_ports.empty())
+    {
+        sink_parameter.event_loop->join();
+    }
+    for (auto& thread : traffic_generator_list)
+    {
+        if (thread.joinable())
+        {
+            thread.join();
+        }
+    }
+}
+
+
+/*
+*
+*/
+void TrafficSink::print_statistics()
+{
+    std::vector<SinkStatistics*> shards;
+    for (auto& statistics : shard_statistics)
+    {
+        shards.push_back(statistics.get());
+    }
+    std::lock_guard<std::mutex> lock(kernel_counter_mutex);
+    // Ports counting in the kernel never record a fragment in user space
+    if (sink_parameter.receive_backend != RECEIVE_KERNEL || kernel_counters.empty())
+    {
+        SinkStatistics::print("Traffic sink " + local_ip_address, shards);
+    }
+    for (const auto& kernel_counter : kernel_counters)
+    {
+        kernel_counter.second->print(kernel_counter.first);
+    }
+}
+
+
+/*------------------------------------- Private -----------------------------------------*/
+/*
+*
+*/
+std::unique_ptr<struct TrafficSink::sink_port> TrafficSink::prepare_port(udp::socket &traffic_socket, uint32_t batch_size, uint32_t shard)
+{
     std::string local_endpoint_str = traffic_socket.local_endpoint().address().to_string();
-    std::string filename_str = filename_log + "_" + local_endpoint_str + ".log";
-    std::string filename_str_log = filename_log + "_" + local_endpoint_str + "_all.log";
+    std::string shard_suffix = sink_parameter.shards > 1 ? "_shard" + std::to_string(shard) : "";
+    std::unique_ptr<struct sink_port> port(new struct sink_port());
+    port->name = "Traffic sink " + local_endpoint_str + ":" + std::to_string(traffic_socket.local_endpoint().port()) + shard_suffix;
+    port->shard = shard;
+    port->statistics = shard_statistics[shard].get();
+    // Records are written by the background writer, the receive path only copies them into its ring
+    port->record_ring = record_writer.create_ring(local_endpoint_str, traffic_socket.local_endpoint().port(), shard_suffix);
+    port->time_statistics = {0,0};
 
+    RxTimestampMode rx_timestamp = enable_rx_timestamps(traffic_socket.native_handle(), sink_parameter.rx_timestamp);
 
-    RM_logInfo("Traffic sink Thread " << thread_id << " is ready to receive on interface ip " << local_endpoint_str << " " <<  traffic_socket.local_endpoint().port()) 
+    if (batch_size > 0)
+    {
+        port->receiver.reset(new BatchReceiver(traffic_socket.native_handle(), batch_size, 
+            DataMessageTemplate::HEADER_LENGTH + demonstrator::MAX_PROTOCOL_MESSAGE_LENGTH, sink_parameter.gro));
+    }
 
-    while (true) 
+    RM_logInfo("Traffic sink Thread " << thread_id << " is ready to receive on interface ip " << local_endpoint_str << " " <<  traffic_socket.local_endpoint().port()
+        << (sink_parameter.shards > 1 ? " shard " + std::to_string(shard) : "")
+        << (rx_timestamp == RX_TIMESTAMP_HARDWARE ? " with hardware RX timestamps" : rx_timestamp == RX_TIMESTAMP_SOFTWARE ? " with software RX timestamps" : "")) 
+    return port;
+}
+
+
+/*
+*
+*/
+void TrafficSink::register_event_port(std::string local_ip_address, uint32_t local_port)
+{
+    std::vector<std::unique_ptr<udp::socket>> sockets = open_port_sockets(local_ip_address, local_port, true);
+    for (uint32_t shard = 0; shard < sockets.size(); ++shard)
+    {
+        // The SOCKET backend keeps one datagram per syscall
+        std::unique_ptr<struct sink_port> port = prepare_port(*sockets[shard], sink_parameter.receive_backend == RECEIVE_BATCH ? sink_parameter.batch_size : 1, shard);
+        int socket_fd = sockets[shard]->native_handle();
+        port->socket = std::move(sockets[shard]);
+
+        struct sink_port* event_port = port.get();
+        event_ports.push_back(std::move(port));
+        if (!sink_parameter.event_loop->add(socket_fd, [this, event_port]() { drain_port(*event_port); }))
+        {
+            RM_logError("Traffic sink " << local_ip_address << " " << local_port << " not registered with the event loop")
+        }
+    }
+}
+
+
+/*
+*
+*/
+std::vector<std::unique_ptr<udp::socket>> TrafficSink::open_port_sockets(std::string local_ip_address, uint32_t local_port, bool non_blocking)
+{
+    udp::endpoint traffic_endpoint_local(boost::asio::ip::address::from_string(local_ip_address), local_port);
+    std::vector<std::unique_ptr<udp::socket>> sockets;
+
+    try 
+    {       
+        // The reuseport group indexes the sockets in bind order, which the steering program relies on
+        for (uint32_t shard = 0; shard < sink_parameter.shards; ++shard)
+        {
+            std::unique_ptr<udp::socket> traffic_socket(new udp::socket(traffic_context));
+            traffic_socket->open(traffic_endpoint_local.protocol());
+            traffic_socket->set_option(boost::asio::socket_base::reuse_address(true));
+            traffic_socket->set_option(boost::asio::socket_base::broadcast(true));
+            if (sink_parameter.shards > 1)
+            {
+                int enable = 1;
+                if (setsockopt(traffic_socket->native_handle(), SOL_SOCKET, SO_REUSEPORT, &enable, sizeof(enable)) < 0)
+                {
+                    RM_logError("Traffic sink SO_REUSEPORT failed: " << strerror(errno))
+                    return std::vector<std::unique_ptr<udp::socket>>();
+                }
+            }
+            traffic_socket->bind(traffic_endpoint_local);       
+            traffic_socket->non_blocking(non_blocking);
+            sockets.push_back(std::move(traffic_socket));
+        }
+    } 
+    catch (const boost::system::system_error& e) 
+    {
+        RM_logError("Error in open_port_sockets: " << e.what());
+        return std::vector<std::unique_ptr<udp::socket>>();
+    }
+
+    if (sink_parameter.shards > 1 && sink_parameter.shard_steering)
     {
-        message_buffer_size = traffic_socket.receive_from(boost::asio::buffer(data_message_buffer, data_message_buffer.size()), source_address);
+        attach_service_steering(sockets.front()->native_handle(), sink_parameter.shards);
+    }
+    return sockets;
+}
+
+
+/*
+*
+*/
+void TrafficSink::run_shard(udp::socket* traffic_socket, uint32_t shard)
+{
+    // One core per shard keeps the reassembly state of its services in one cache
+    rscmng::RealtimeProfile::instance().apply(RT_THREAD_SINK_SHARD, static_cast<int32_t>(shard));
+    handle_message(*traffic_socket, shard);
+}
+
+
+/*
+*
+*/
+void TrafficSink::receive_kernel(udp::socket &traffic_socket, uint32_t shard)
+{
+    std::unique_ptr<KernelServiceCounter> counter(new KernelServiceCounter(traffic_socket.native_handle()));
+    if (!counter->valid())
+    {
+        RM_logWarning("Traffic sink kernel counter not available, using SOCKET")
+        std::unique_ptr<struct sink_port> port = prepare_port(traffic_socket, 0, shard);
+        receive_single(traffic_socket, *port);
+        return;
+    }
+
+    std::string name = "Traffic sink " + traffic_socket.local_endpoint().address().to_string() + ":" + std::to_string(traffic_socket.local_endpoint().port())
+        + (sink_parameter.shards > 1 ? "_shard" + std::to_string(shard) : "");
+    const KernelServiceCounter* kernel_counter = counter.get();
+    {
+        std::lock_guard<std::mutex> lock(kernel_counter_mutex);
+        kernel_counters.emplace_back(name, std::move(counter));
+    }
+    RM_logInfo(name << " counts data messages in the kernel, polled every " << sink_parameter.kernel_poll_interval.count() << " ms")
+
+    // Only the map is read, the thread sleeps between polls
+    std::map<uint64_t, struct kernel_service_counters> previous;
+    const double interval_s = sink_parameter.kernel_poll_interval.count() / 1e3;
+    while (true)
+    {
+        std::this_thread::sleep_for(sink_parameter.kernel_poll_interval);
+        std::map<uint64_t, struct kernel_service_counters> current = kernel_counter->snapshot();
+        for (const auto& service : current)
+        {
+            const struct kernel_service_counters& before = previous[service.first];
+            uint64_t packets = service.second.packets - before.packets;
+            if (packets == 0)
+            {
+                continue;
+            }
+            if (service.first == KERNEL_COUNTER_REJECTED_KEY)
+            {
+                RM_logWarning(name << " " << packets / interval_s << " datagrams/s without data message header")
+                continue;
+            }
+            RM_logInfo(name << " service " << service.first << " " << packets / interval_s << " fragments/s "
+                << (service.second.bytes - before.bytes) * 8 / interval_s / 1e6 << " Mbit/s objects started: "
+                << service.second.first_fragments - before.first_fragments << " last object: " << service.second.last_object
+                << " fragment: " << service.second.last_fragment)
+        }
+        previous = current;
+    }
+}
+
 
-        //data_message_buffer.size() = message_buffer_size;
-        data_message.netToData(data_message_buffer.data(), data_message_buffer.size());
-       
+/*
+*
+*/
+void TrafficSink::receive_single(udp::socket &traffic_socket, struct sink_port& port)
+{
+    struct timespec time_received = {0,0}; 
+    struct timespec kernel_received = {0,0}; 
+    std::vector<char> data_message_buffer(DataMessageTemplate::HEADER_LENGTH + demonstrator::MAX_PROTOCOL_MESSAGE_LENGTH);
+    rscmng::RealtimeProfile::prefault(data_message_buffer.data(), data_message_buffer.size());
+
+    // recvmsg instead of receive_from to get the receive timestamp from the control message
+    struct sockaddr_in source_address;
+    struct iovec message_iovec;
+    message_iovec.iov_base = data_message_buffer.data();
+    message_iovec.iov_len = data_message_buffer.size();
+    char message_control[RX_TIMESTAMP_CONTROL_SIZE];
+    struct msghdr message;
+    memset(&message, 0, sizeof(message));
+    message.msg_name = &source_address;
+    message.msg_iov = &message_iovec;
+    message.msg_iovlen = 1;
+
+    while (true) 
+    {
+        message.msg_namelen = sizeof(source_address);
+        message.msg_control = message_control;
+        message.msg_controllen = sizeof(message_control);
+        ssize_t received = recvmsg(traffic_socket.native_handle(), &message, 0);
+        if (received < 0)
+        {
+            if (errno != EINTR)
+            {
+                RM_logError("Traffic sink recvmsg failed: " << strerror(errno))
+            }
+            continue;
+        }
         clock_gettime(CLOCK_REALTIME, &time_received);        
-            
-        received_object_number = data_message.object_number;
-        received_packet_number = data_message.fragment_number;
-        serviceID_t service_id = data_message.service_id;
+        bool kernel_timestamped = read_rx_timestamp(message, kernel_received);
 
-        time_start = data_message.timestamp;
-        time_start_2 = data_message.time_stamp;
+        record_datagram(port, data_message_buffer.data(), static_cast<size_t>(received),
+            ntohl(source_address.sin_addr.s_addr), ntohs(source_address.sin_port), time_received, 
+            kernel_timestamped ? &kernel_received : nullptr);
 
-        if (received_packet_number == 1 && LOGGING)
+        if (time_received.tv_sec - port.time_statistics.tv_sec >= 10)
         {
-            //std::cout << "Traffic sink received frame from service: " << service_id << " " << source_address.address().to_string() << " from port " << source_address.port() << " on interface ip: " << local_endpoint_str << " on port: " << traffic_socket.local_endpoint().port() << " packet number: " << received_packet_number << " from Object number: " << received_object_number << " Time: " << time_received.tv_sec << " s "  << time_received.tv_nsec << " ns" << std::endl;
-            fp = fopen(filename_str_log.c_str(), "a");
-            fprintf(fp,"Traffic sink received frame from service: %li %c from port %i on interface ip: %i on port %i with packet number %li from object %li at time %li s %ld ns\n", service_id, source_address.address().to_string(), source_address.port(),local_endpoint_str, traffic_socket.local_endpoint().port(), received_packet_number, received_object_number, time_received.tv_sec, time_received.tv_nsec);		
-            fclose(fp);      
+            port.receive_delay.print(port.name + " kernel receive to sink");
+            port.time_statistics = time_received;
         }
-                
-        fp = fopen(filename_str.c_str(), "a");
-        fprintf(fp,"Frame started    :%s:%li:%li:%li: %ld secs %ld nsecs\n", local_endpoint_str.c_str(), received_object_number,received_packet_number, service_id, time_start.tv_sec, time_start.tv_nsec);		
-        //fprintf(fp,"Frame started 2  :%s:%li:%li: %ld secs \n", local_endpoint_str.c_str(), received_object_number, received_packet_number, time_start_2);		
-        fprintf(fp,"Frame received   :%s:%li:%li:%li: %ld secs %ld nsecs\n", local_endpoint_str.c_str(), received_object_number,received_packet_number, service_id, time_received.tv_sec, time_received.tv_nsec);						
-        fclose(fp);
+    }
+}
+
+
+/*
+*
+*/
+uint32_t TrafficSink::receive_batch(struct sink_port& port)
+{
+    struct timespec time_received = {0,0}; 
+    uint32_t received = port.receiver->receive();
+    // One receive time per batch, the kernel timestamps keep the arrival time of every datagram
+    clock_gettime(CLOCK_REALTIME, &time_received);        
+
+    for (uint32_t index = 0; index < received; ++index)
+    {
+        const struct received_datagram& datagram = port.receiver->datagram(index);
+        record_datagram(port, datagram.data, datagram.length,
+            datagram.source_address, datagram.source_port, time_received, 
+            datagram.kernel_timestamped ? &datagram.kernel_timestamp : nullptr);
+    }
 
-        data_message.clear();        
+    if (time_received.tv_sec - port.time_statistics.tv_sec >= 10)
+    {
+        port.receiver->print_statistics(port.name);
+        port.receive_delay.print(port.name + " kernel receive to sink");
+        port.time_statistics = time_received;
     }
+    return received;
 }
 
 
 /*
 *
 */
-void TrafficSink::join()
+void TrafficSink::drain_port(struct sink_port& port)
 {
-    for (auto& thread : traffic_generator_list)
+    for (uint32_t batch = 0; batch < SINK_EVENT_DRAIN_BATCHES; ++batch)
     {
-        if (thread.joinable())
+        if (receive_batch(port) == 0)
         {
-            thread.join();
+            return;
         }
     }
-}
\ No newline at end of file
+}
+
+
+/*
+*
+*/
+void TrafficSink::record_datagram(struct sink_port& port, const char* data, size_t length, 
+    uint32_t source_address, uint16_t source_port, const struct timespec& time_received, 
+    const struct timespec* kernel_received)
+{
+    // Header decoded in place, the payload is not copied
+    DataMessageView message;
+    if (!message.parse(data, length))
+    {
+        return;
+    }
+
+    if (kernel_received != nullptr)
+    {
+        int64_t delay_ns = (time_received.tv_sec - kernel_received->tv_sec) * 1000000000L + (time_received.tv_nsec - kernel_received->tv_nsec);
+        // Hardware timestamps of a NIC clock that is not synchronized may lie ahead
+        port.receive_delay.record(delay_ns > 0 ? static_cast<uint64_t>(delay_ns) : 0);
+    }
+
+    if (port.record_ring)
+    {
+        struct sink_record record;
+        record.service_id = message.service_id();
+        record.object_number = message.object_number();
+        record.fragment_number = message.fragment_number();
+        record.send_sec = message.timestamp().tv_sec;
+        record.send_nsec = message.timestamp().tv_nsec;
+        record.receive_sec = time_received.tv_sec;
+        record.receive_nsec = time_received.tv_nsec;
+        record.source_address = source_address;
+        record.source_port = source_port;
+        record.reserved = 0;
+        record.kernel_receive_sec = kernel_received != nullptr ? kernel_received->tv_sec : 0;
+        record.kernel_receive_nsec = kernel_received != nullptr ? kernel_received->tv_nsec : 0;
+        port.record_ring->push(record);
+    }
+
+    const struct timespec& fragment_received = kernel_received != nullptr ? *kernel_received : time_received;
+    port.statistics->record_fragment(message.service_id(), message.object_number(), 
+        message.fragment_number(), message.total_fragments(),
+        message.timestamp().tv_sec * 1000000000L + message.timestamp().tv_nsec,
+        fragment_received.tv_sec * 1000000000L + fragment_received.tv_nsec,
+        message.mode());
+}
@@ -0,0 +1,144 @@
+// Copyright (C) 2025 IDA
+//
+// This file is part of a project licensed under the GNU Lesser General Public License v3.0.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+
+#include <cerrno>
+
+#include <rscmng/transmit/batch_sender.hpp>
+
+
+using namespace traffic_generator;
+
+
+/*
+*
+*/
+BatchSender::BatchSender(int socket_fd, uint32_t batch_size, size_t header_size)
+:
+    socket_fd(socket_fd),
+    batch_size(batch_size > 0 ? batch_size : 1),
+    header_size(header_size),
+    queued(0),
+    syscall_count(0),
+    datagram_count(0),
+    error_count(0)
+{
+    slot_buffer.resize(this->batch_size * header_size);
+    slot_iovec.resize(2 * this->batch_size);
+    slot_destination.resize(this->batch_size);
+    slot_header.resize(this->batch_size);
+
+    // Wire the headers once, only lengths, payload references and destinations change per datagram
+    for (uint32_t slot = 0; slot < this->batch_size; ++slot)
+    {
+        slot_iovec[2 * slot].iov_base = slot_buffer.data() + slot * header_size;
+        slot_iovec[2 * slot].iov_len = 0;
+        slot_iovec[2 * slot + 1].iov_base = nullptr;
+        slot_iovec[2 * slot + 1].iov_len = 0;
+
+        memset(&slot_header[slot], 0, sizeof(struct mmsghdr));
+        slot_header[slot].msg_hdr.msg_name = &slot_destination[slot];
+        slot_header[slot].msg_hdr.msg_iov = &slot_iovec[2 * slot];
+        slot_header[slot].msg_hdr.msg_iovlen = 2;
+    }
+}
+
+
+/*
+*
+*/
+void BatchSender::queue(const char* header, size_t header_length, const char* payload, size_t payload_length, const udp::endpoint& destination)
+{
+    header_length = std::min(header_length, header_size);
+    memcpy(slot_iovec[2 * queued].iov_base, header, header_length);
+    slot_iovec[2 * queued].iov_len = header_length;
+    slot_iovec[2 * queued + 1].iov_base = const_cast<char*>(payload);
+    slot_iovec[2 * queued + 1].iov_len = payload_length;
+
+    memcpy(&slot_destination[queued], destination.data(), destination.size());
+    slot_header[queued].msg_hdr.msg_namelen = destination.size();
+    ++queued;
+}
+
+
+/*
+*
+*/
+uint32_t BatchSender::flush()
+{
+    uint32_t sent = 0;
+
+    while (sent < queued)
+    {
+        int result = sendmmsg(socket_fd, &slot_header[sent], queued - sent, 0);
+        ++syscall_count;
+
+        if (result < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            ++error_count;
+            RM_logError("Batch sender sendmmsg failed: " << strerror(errno) << ", dropping " << (queued - sent) << " datagrams")
+            break;
+        }
+        sent += result;
+    }
+
+    datagram_count += sent;
+    queued = 0;
+
+    return sent;
+}
+
+
+/*
+*
+*/
+bool BatchSender::full() const
+{
+    return queued >= batch_size;
+}
+
+
+/*
+*
+*/
+uint32_t BatchSender::pending() const
+{
+    return queued;
+}
+
+
+/*
+*
+*/
+uint32_t BatchSender::capacity() const
+{
+    return batch_size;
+}
+
+
+/*
+*
+*/
+void BatchSender::print_statistics(std::string name) const
+{
+    RM_logInfo(name << " syscalls: " << syscall_count << " datagrams: " << datagram_count << " errors: " << error_count
+        << " datagrams per syscall: " << (syscall_count > 0 ? static_cast<double>(datagram_count) / syscall_count : 0.0))
+}
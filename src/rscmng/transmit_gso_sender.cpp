@@ -0,0 +1,319 @@
+// Copyright (C) 2025 IDA
+//
+// This file is part of a project licensed under the GNU Lesser General Public License v3.0.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+
+#include <cerrno>
+#include <algorithm>
+
+#include <unistd.h>
+
+#include <rscmng/transmit/gso_sender.hpp>
+
+
+using namespace traffic_generator;
+
+
+/*
+*
+*/
+GsoSender::GsoSender(int socket_fd, size_t segment_size, size_t header_size)
+:
+    socket_fd(socket_fd),
+    segment_size(segment_size),
+    header_size(header_size),
+    max_segments(static_cast<uint32_t>(GSO_MAX_BYTES / segment_size)),
+    queued_segment_size(segment_size),
+    gso_available(false),
+    short_segment_queued(false),
+    queued(0),
+    queued_bytes(0),
+    syscall_count(0),
+    datagram_count(0),
+    fallback_count(0)
+{
+    if (max_segments > GSO_MAX_SEGMENTS)
+    {
+        max_segments = GSO_MAX_SEGMENTS;
+    }
+    if (max_segments == 0)
+    {
+        max_segments = 1;
+    }
+    header_buffer.resize(max_segments * header_size);
+    segment_iovec.resize(2 * max_segments);
+    fallback_header.resize(max_segments);
+
+    // Setting a segment size of 0 keeps the socket unchanged but fails on kernels without UDP GSO
+    int probe_size = 0;
+    gso_available = setsockopt(socket_fd, SOL_UDP, UDP_SEGMENT, &probe_size, sizeof(probe_size)) == 0;
+
+    if (gso_available)
+    {
+        RM_logInfo("GSO sender segment size " << segment_size << " bytes, " << max_segments << " segments per call")
+    }
+    else
+    {
+        RM_logWarning("GSO sender UDP_SEGMENT not supported (" << strerror(errno) << "), using sendmmsg fallback")
+    }
+}
+
+
+/*
+*
+*/
+size_t GsoSender::segment_size_for(const udp::endpoint& destination)
+{
+    auto cached = route_segment_size.find(destination);
+    if (cached != route_segment_size.end())
+    {
+        return cached->second;
+    }
+
+    // IP_MTU needs a connected socket, the sending socket is not connected, so a probe from the same local address
+    size_t destination_segment_size = segment_size;
+    int mtu = 0;
+    socklen_t mtu_length = sizeof(mtu);
+    struct sockaddr_storage local_address;
+    socklen_t local_length = sizeof(local_address);
+    int probe_fd = socket(destination.protocol().family(), SOCK_DGRAM, 0);
+    if (probe_fd >= 0 
+        && getsockname(socket_fd, reinterpret_cast<struct sockaddr*>(&local_address), &local_length) == 0)
+    {
+        // Any port, only the source address selects the route
+        reinterpret_cast<struct sockaddr_in*>(&local_address)->sin_port = 0;
+        if (bind(probe_fd, reinterpret_cast<struct sockaddr*>(&local_address), local_length) == 0
+            && connect(probe_fd, destination.data(), destination.size()) == 0
+            && getsockopt(probe_fd, IPPROTO_IP, IP_MTU, &mtu, &mtu_length) == 0
+            && mtu > static_cast<int>(UDP_IPV4_OVERHEAD))
+        {
+            destination_segment_size = std::min(segment_size, static_cast<size_t>(mtu) - UDP_IPV4_OVERHEAD);
+        }
+    }
+    if (mtu <= static_cast<int>(UDP_IPV4_OVERHEAD))
+    {
+        RM_logWarning("GSO sender route MTU of " << destination << " unknown (" << strerror(errno) << "), segment size " << destination_segment_size)
+    }
+    else
+    {
+        RM_logInfo("GSO sender route MTU of " << destination << " " << mtu << " bytes, segment size " << destination_segment_size)
+    }
+    if (probe_fd >= 0)
+    {
+        close(probe_fd);
+    }
+
+    route_segment_size[destination] = destination_segment_size;
+    return destination_segment_size;
+}
+
+
+/*
+*
+*/
+void GsoSender::queue(const char* header, size_t header_length, const char* payload, size_t payload_length, const udp::endpoint& destination)
+{
+    if (queued == 0)
+    {
+        queued_segment_size = segment_size_for(destination);
+    }
+    header_length = std::min(header_length, header_size);
+    payload_length = std::min(payload_length, queued_segment_size - header_length);
+
+    char* segment_header = header_buffer.data() + queued * header_size;
+    memcpy(segment_header, header, header_length);
+
+    segment_iovec[2 * queued].iov_base = segment_header;
+    segment_iovec[2 * queued].iov_len = header_length;
+    segment_iovec[2 * queued + 1].iov_base = const_cast<char*>(payload);
+    segment_iovec[2 * queued + 1].iov_len = payload_length;
+
+    queued_destination = destination;
+    queued_bytes += header_length + payload_length;
+    ++queued;
+
+    if (header_length + payload_length < queued_segment_size)
+    {
+        short_segment_queued = true;
+    }
+}
+
+
+/*
+*
+*/
+uint32_t GsoSender::flush()
+{
+    if (queued == 0)
+    {
+        return 0;
+    }
+
+    uint32_t sent = 0;
+
+    if (gso_available && queued > 1)
+    {
+        int result = send_offload();
+        if (result >= 0)
+        {
+            sent = queued;
+        }
+        else if (errno == EIO || errno == EINVAL || errno == ENOPROTOOPT || errno == EOPNOTSUPP)
+        {
+            RM_logWarning("GSO sender segmentation offload of " << queued << " segments of " << queued_segment_size << " bytes to "
+                << queued_destination << " rejected (" << strerror(errno) << "), switching to sendmmsg fallback")
+            gso_available = false;
+            sent = send_fallback();
+        }
+        else
+        {
+            RM_logError("GSO sender sendmsg failed: " << strerror(errno) << ", dropping " << queued << " datagrams")
+        }
+    }
+    else
+    {
+        sent = send_fallback();
+    }
+
+    datagram_count += sent;
+    queued = 0;
+    queued_bytes = 0;
+    short_segment_queued = false;
+
+    return sent;
+}
+
+
+/*
+*
+*/
+bool GsoSender::full() const
+{
+    return short_segment_queued || queued >= max_segments;
+}
+
+
+/*
+*
+*/
+uint32_t GsoSender::pending() const
+{
+    return queued;
+}
+
+
+/*
+*
+*/
+const udp::endpoint& GsoSender::destination() const
+{
+    return queued_destination;
+}
+
+
+/*
+*
+*/
+bool GsoSender::offload_active() const
+{
+    return gso_available;
+}
+
+
+/*
+*
+*/
+void GsoSender::print_statistics(std::string name) const
+{
+    RM_logInfo(name << " offload: " << (gso_available ? "active" : "fallback") << " syscalls: " << syscall_count
+        << " datagrams: " << datagram_count << " fallback calls: " << fallback_count
+        << " datagrams per syscall: " << (syscall_count > 0 ? static_cast<double>(datagram_count) / syscall_count : 0.0))
+}
+
+
+/*------------------------------------- Private -----------------------------------------*/
+/*
+*
+*/
+int GsoSender::send_offload()
+{
+    char control[CMSG_SPACE(sizeof(uint16_t))];
+    memset(control, 0, sizeof(control));
+
+    struct msghdr message;
+    memset(&message, 0, sizeof(message));
+    message.msg_name = const_cast<struct sockaddr*>(queued_destination.data());
+    message.msg_namelen = queued_destination.size();
+    // The kernel concatenates the header and payload iovecs and cuts the result into segments
+    message.msg_iov = segment_iovec.data();
+    message.msg_iovlen = 2 * queued;
+    message.msg_control = control;
+    message.msg_controllen = sizeof(control);
+
+    struct cmsghdr* control_header = CMSG_FIRSTHDR(&message);
+    control_header->cmsg_level = SOL_UDP;
+    control_header->cmsg_type = UDP_SEGMENT;
+    control_header->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+    uint16_t gso_size = static_cast<uint16_t>(queued_segment_size);
+    memcpy(CMSG_DATA(control_header), &gso_size, sizeof(gso_size));
+
+    int result;
+    do
+    {
+        result = sendmsg(socket_fd, &message, 0);
+        ++syscall_count;
+    }
+    while (result < 0 && errno == EINTR);
+
+    return result;
+}
+
+
+/*
+*
+*/
+uint32_t GsoSender::send_fallback()
+{
+    for (uint32_t segment = 0; segment < queued; ++segment)
+    {
+        memset(&fallback_header[segment], 0, sizeof(struct mmsghdr));
+        fallback_header[segment].msg_hdr.msg_name = const_cast<struct sockaddr*>(queued_destination.data());
+        fallback_header[segment].msg_hdr.msg_namelen = queued_destination.size();
+        fallback_header[segment].msg_hdr.msg_iov = &segment_iovec[2 * segment];
+        fallback_header[segment].msg_hdr.msg_iovlen = 2;
+    }
+
+    uint32_t sent = 0;
+    while (sent < queued)
+    {
+        int result = sendmmsg(socket_fd, &fallback_header[sent], queued - sent, 0);
+        ++syscall_count;
+        ++fallback_count;
+
+        if (result < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            RM_logError("GSO sender sendmmsg fallback failed: " << strerror(errno) << ", dropping " << (queued - sent) << " datagrams")
+            break;
+        }
+        sent += result;
+    }
+
+    return sent;
+}
@@ -0,0 +1,706 @@
+// Copyright (C) 2025 IDA
+//
+// This file is part of a project licensed under the GNU Lesser General Public License v3.0.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+
+#include <cerrno>
+#include <cstdio>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+#include <unistd.h>
+#include <ifaddrs.h>
+#include <net/if.h>
+#include <arpa/inet.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <linux/if_packet.h>
+#include <linux/if_ether.h>
+
+#include <rscmng/transmit/packet_ring_sender.hpp>
+
+
+using namespace traffic_generator;
+
+
+namespace
+{
+    const size_t ETHERNET_HEADER_LENGTH = 14;
+    const size_t IPV4_HEADER_LENGTH = 20;
+    const size_t UDP_HEADER_LENGTH = 8;
+
+    /*
+    *   Interval of the neighbour table lookups of an unresolved next hop
+    */
+    const std::chrono::milliseconds NEXT_HOP_RETRY_INTERVAL(100);
+
+    /*
+    *   Time resolve() waits for the neighbour table to complete a probed entry
+    */
+    const std::chrono::milliseconds NEXT_HOP_RESOLUTION_TIMEOUT(1000);
+
+    /*
+    *   Discard service, target port of the resolution probes
+    */
+    const uint16_t PROBE_PORT = 9;
+
+    /*
+    *   Start of the frame data behind the TPACKET_V2 header
+    */
+    const size_t FRAME_DATA_OFFSET = TPACKET_ALIGN(sizeof(struct tpacket2_hdr));
+
+    /*
+    *   Internet checksum of an IPv4 header
+    */
+    uint16_t ipv4_checksum(const uint8_t* header)
+    {
+        uint32_t sum = 0;
+        for (size_t offset = 0; offset < IPV4_HEADER_LENGTH; offset += 2)
+        {
+            sum += (static_cast<uint32_t>(header[offset]) << 8) | header[offset + 1];
+        }
+        while (sum >> 16)
+        {
+            sum = (sum & 0xFFFF) + (sum >> 16);
+        }
+        return htons(static_cast<uint16_t>(~sum));
+    }
+
+    /*
+    *   Copy [offset, offset + length) of the concatenation of three buffers
+    */
+    void copy_range(char* target, size_t offset, size_t length, const char* const* parts, const size_t* part_lengths)
+    {
+        for (int part = 0; part < 3 && length > 0; ++part)
+        {
+            if (offset >= part_lengths[part])
+            {
+                offset -= part_lengths[part];
+                continue;
+            }
+            size_t chunk = std::min(part_lengths[part] - offset, length);
+            memcpy(target, parts[part] + offset, chunk);
+            target += chunk;
+            length -= chunk;
+            offset = 0;
+        }
+    }
+
+    /*
+    *   IPv4 setting of an interface, -1 if not readable
+    */
+    int interface_setting(const std::string& interface_name, const std::string& setting)
+    {
+        std::ifstream setting_file("/proc/sys/net/ipv4/conf/" + interface_name + "/" + setting);
+        int value = -1;
+        setting_file >> value;
+        return value;
+    }
+}
+
+
+/*
+*
+*/
+PacketRingSender::PacketRingSender(const udp::endpoint& source, uint32_t batch_size, size_t max_datagram_size)
+:
+    packet_socket(-1),
+    ring(nullptr),
+    ring_size(0),
+    frame_size(0),
+    frame_count(0),
+    frame_index(0),
+    batch_size(batch_size > 0 ? batch_size : 1),
+    queued(0),
+    queued_frames(0),
+    interface_index(0),
+    interface_loopback(false),
+    interface_mtu(1500),
+    interface_address(0),
+    interface_netmask(0),
+    source_port(htons(source.port())),
+    ip_identification(0),
+    kick_count(0),
+    frame_sent_count(0),
+    datagram_count(0),
+    fragmented_count(0),
+    error_count(0),
+    unresolved_count(0)
+{
+    memset(source_mac, 0, sizeof(source_mac));
+
+    // Protocol 0, the socket only transmits
+    packet_socket = socket(AF_PACKET, SOCK_RAW, 0);
+    if (packet_socket < 0)
+    {
+        RM_logWarning("Packet ring sender socket failed: " << strerror(errno))
+        return;
+    }
+    if (!source.address().is_v4() || !resolve_interface(source.address().to_v4()))
+    {
+        RM_logWarning("Packet ring sender no IPv4 interface owns " << source.address().to_string())
+        return;
+    }
+
+    int packet_version = TPACKET_V2;
+    int packet_loss = 1;
+    if (setsockopt(packet_socket, SOL_PACKET, PACKET_VERSION, &packet_version, sizeof(packet_version)) < 0)
+    {
+        RM_logWarning("Packet ring sender TPACKET_V2 not supported: " << strerror(errno))
+        return;
+    }
+    // Malformed frames are skipped and flagged instead of stalling the ring
+    setsockopt(packet_socket, SOL_PACKET, PACKET_LOSS, &packet_loss, sizeof(packet_loss));
+
+    // Largest frame of a datagram that is not split, frames must be a power of two to fill the blocks
+    size_t largest_frame = FRAME_DATA_OFFSET + ETHERNET_HEADER_LENGTH + IPV4_HEADER_LENGTH + UDP_HEADER_LENGTH + max_datagram_size;
+    frame_size = TPACKET_ALIGNMENT;
+    while (frame_size < largest_frame)
+    {
+        frame_size <<= 1;
+    }
+    size_t block_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    while (block_size < frame_size * 8)
+    {
+        block_size <<= 1;
+    }
+    uint32_t frames_per_block = static_cast<uint32_t>(block_size / frame_size);
+    // Room for a few batches, fragmented datagrams take several frames
+    uint32_t wanted_frames = std::max<uint32_t>(this->batch_size * 4, 64);
+    uint32_t block_count = (wanted_frames + frames_per_block - 1) / frames_per_block;
+
+    struct tpacket_req ring_request;
+    memset(&ring_request, 0, sizeof(ring_request));
+    ring_request.tp_block_size = static_cast<unsigned int>(block_size);
+    ring_request.tp_block_nr = block_count;
+    ring_request.tp_frame_size = static_cast<unsigned int>(frame_size);
+    ring_request.tp_frame_nr = block_count * frames_per_block;
+    if (setsockopt(packet_socket, SOL_PACKET, PACKET_TX_RING, &ring_request, sizeof(ring_request)) < 0)
+    {
+        RM_logWarning("Packet ring sender PACKET_TX_RING failed: " << strerror(errno))
+        return;
+    }
+    frame_count = ring_request.tp_frame_nr;
+    ring_size = block_size * block_count;
+
+    void* mapping = mmap(nullptr, ring_size, PROT_READ | PROT_WRITE, MAP_SHARED, packet_socket, 0);
+    if (mapping == MAP_FAILED)
+    {
+        RM_logWarning("Packet ring sender mmap failed: " << strerror(errno))
+        ring_size = 0;
+        return;
+    }
+    ring = static_cast<char*>(mapping);
+
+    struct sockaddr_ll link_address;
+    memset(&link_address, 0, sizeof(link_address));
+    link_address.sll_family = AF_PACKET;
+    link_address.sll_protocol = htons(ETH_P_IP);
+    link_address.sll_ifindex = interface_index;
+    if (bind(packet_socket, reinterpret_cast<struct sockaddr*>(&link_address), sizeof(link_address)) < 0)
+    {
+        RM_logWarning("Packet ring sender bind to " << interface_name << " failed: " << strerror(errno))
+        munmap(ring, ring_size);
+        ring = nullptr;
+        return;
+    }
+
+    if (interface_loopback)
+    {
+        // Injected frames carry no route, the input route lookup drops local and 127/8 sources as martians
+        bool localnet = (ntohl(interface_address) >> 24) == 127;
+        if (interface_setting(interface_name, "accept_local") != 1 || (localnet && interface_setting(interface_name, "route_localnet") != 1))
+        {
+            RM_logWarning("Packet ring sender on " << interface_name << " needs net.ipv4.conf." << interface_name << ".accept_local=1"
+                << (localnet ? " and route_localnet=1" : "") << ", frames are dropped otherwise")
+        }
+    }
+
+    RM_logInfo("Packet ring sender on " << interface_name << " (mtu " << interface_mtu << "), " << frame_count << " frames of " << frame_size << " byte")
+}
+
+
+/*
+*
+*/
+PacketRingSender::~PacketRingSender()
+{
+    if (ring != nullptr)
+    {
+        munmap(ring, ring_size);
+    }
+    if (packet_socket >= 0)
+    {
+        close(packet_socket);
+    }
+}
+
+
+/*
+*
+*/
+bool PacketRingSender::valid() const
+{
+    return ring != nullptr;
+}
+
+
+/*
+*
+*/
+bool PacketRingSender::resolve(const boost::asio::ip::address_v4& destination)
+{
+    std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + NEXT_HOP_RESOLUTION_TIMEOUT;
+    while (next_hop_mac(destination) == nullptr)
+    {
+        if (std::chrono::steady_clock::now() >= deadline)
+        {
+            return false;
+        }
+        std::this_thread::sleep_for(NEXT_HOP_RETRY_INTERVAL);
+    }
+    return true;
+}
+
+
+/*
+*
+*/
+uint32_t PacketRingSender::queue(const char* header, size_t header_length, const char* payload, size_t payload_length, const udp::endpoint& destination)
+{
+    boost::asio::ip::address_v4 destination_address = destination.address().to_v4();
+    const uint8_t* destination_mac = next_hop_mac(destination_address);
+    if (destination_mac == nullptr)
+    {
+        // Never flooded to broadcast, the datagram is lost until the neighbour table completes the entry
+        ++unresolved_count;
+        return 0;
+    }
+    uint32_t destination_ip = htonl(destination_address.to_uint());
+
+    size_t udp_length = UDP_HEADER_LENGTH + header_length + payload_length;
+    uint8_t udp_header[UDP_HEADER_LENGTH];
+    memcpy(udp_header, &source_port, 2);
+    uint16_t destination_port = htons(destination.port());
+    memcpy(udp_header + 2, &destination_port, 2);
+    uint16_t udp_length_field = htons(static_cast<uint16_t>(udp_length));
+    memcpy(udp_header + 4, &udp_length_field, 2);
+    // Checksum 0: not computed (valid for UDP over IPv4)
+    memset(udp_header + 6, 0, 2);
+
+    const char* parts[3] = {reinterpret_cast<const char*>(udp_header), header, payload};
+    const size_t part_lengths[3] = {UDP_HEADER_LENGTH, header_length, payload_length};
+
+    // IP payload per frame, fragments other than the last carry multiples of 8 byte
+    size_t max_ip_payload = interface_mtu - IPV4_HEADER_LENGTH;
+    if (udp_length > max_ip_payload)
+    {
+        max_ip_payload &= ~static_cast<size_t>(7);
+        ++fragmented_count;
+    }
+    size_t frame_data_limit = frame_size - FRAME_DATA_OFFSET - ETHERNET_HEADER_LENGTH - IPV4_HEADER_LENGTH;
+    if (max_ip_payload > frame_data_limit)
+    {
+        max_ip_payload = frame_data_limit & ~static_cast<size_t>(7);
+    }
+
+    // All frames of the datagram are reserved first, a partly queued datagram would leave orphan fragments
+    uint32_t frame_number = static_cast<uint32_t>((udp_length + max_ip_payload - 1) / max_ip_payload);
+    uint32_t datagrams_sent = 0;
+    if (!claim_frames(frame_number, datagrams_sent))
+    {
+        ++error_count;
+        return datagrams_sent;
+    }
+
+    uint16_t identification = htons(ip_identification++);
+    for (size_t offset = 0; offset < udp_length; offset += max_ip_payload)
+    {
+        char* frame = claimed_frame();
+        size_t fragment_length = std::min(max_ip_payload, udp_length - offset);
+        bool more_fragments = offset + fragment_length < udp_length;
+
+        uint8_t* ethernet = reinterpret_cast<uint8_t*>(frame + FRAME_DATA_OFFSET);
+        memcpy(ethernet, destination_mac, 6);
+        memcpy(ethernet + 6, source_mac, 6);
+        ethernet[12] = 0x08;
+        ethernet[13] = 0x00;
+
+        uint8_t* ip = ethernet + ETHERNET_HEADER_LENGTH;
+        ip[0] = 0x45;
+        ip[1] = 0;
+        uint16_t total_length = htons(static_cast<uint16_t>(IPV4_HEADER_LENGTH + fragment_length));
+        memcpy(ip + 2, &total_length, 2);
+        memcpy(ip + 4, &identification, 2);
+        // Unfragmented datagrams set DF, fragments the offset and MF
+        uint16_t fragment_field = (udp_length > max_ip_payload)
+            ? htons(static_cast<uint16_t>((offset >> 3) | (more_fragments ? 0x2000 : 0)))
+            : htons(0x4000);
+        memcpy(ip + 6, &fragment_field, 2);
+        ip[8] = 64;
+        ip[9] = IPPROTO_UDP;
+        memset(ip + 10, 0, 2);
+        memcpy(ip + 12, &interface_address, 4);
+        memcpy(ip + 16, &destination_ip, 4);
+        uint16_t checksum = ipv4_checksum(ip);
+        memcpy(ip + 10, &checksum, 2);
+
+        copy_range(reinterpret_cast<char*>(ip + IPV4_HEADER_LENGTH), offset, fragment_length, parts, part_lengths);
+        commit_frame(frame, ETHERNET_HEADER_LENGTH + IPV4_HEADER_LENGTH + fragment_length);
+    }
+    ++queued;
+    return datagrams_sent;
+}
+
+
+/*
+*
+*/
+uint32_t PacketRingSender::flush()
+{
+    if (queued_frames == 0)
+    {
+        return 0;
+    }
+
+    // Blocking kick, returns once the kernel processed all frames marked for sending
+    while (send(packet_socket, nullptr, 0, 0) < 0)
+    {
+        if (errno == EINTR)
+        {
+            continue;
+        }
+        ++error_count;
+        RM_logError("Packet ring sender kick failed: " << strerror(errno))
+        break;
+    }
+    ++kick_count;
+
+    uint32_t sent = queued;
+    frame_sent_count += queued_frames;
+    datagram_count += queued;
+    queued = 0;
+    queued_frames = 0;
+    return sent;
+}
+
+
+/*
+*
+*/
+bool PacketRingSender::full() const
+{
+    return queued >= batch_size;
+}
+
+
+/*
+*
+*/
+uint32_t PacketRingSender::pending() const
+{
+    return queued;
+}
+
+
+/*
+*
+*/
+const std::string& PacketRingSender::interface() const
+{
+    return interface_name;
+}
+
+
+/*
+*
+*/
+void PacketRingSender::print_statistics(std::string name) const
+{
+    RM_logInfo(name << " kicks: " << kick_count << " datagrams: " << datagram_count << " frames: " << frame_sent_count
+        << " fragmented: " << fragmented_count << " errors: " << error_count << " unresolved next hop: " << unresolved_count
+        << " datagrams per kick: " << (kick_count > 0 ? static_cast<double>(datagram_count) / kick_count : 0.0))
+}
+
+
+/*------------------------------------- Private -----------------------------------------*/
+/*
+*
+*/
+bool PacketRingSender::resolve_interface(const boost::asio::ip::address_v4& address)
+{
+    uint32_t wanted_address = htonl(address.to_uint());
+    struct ifaddrs* interface_list = nullptr;
+    if (getifaddrs(&interface_list) < 0)
+    {
+        return false;
+    }
+    for (struct ifaddrs* entry = interface_list; entry != nullptr; entry = entry->ifa_next)
+    {
+        if (entry->ifa_addr == nullptr || entry->ifa_addr->sa_family != AF_INET)
+        {
+            continue;
+        }
+        if (reinterpret_cast<struct sockaddr_in*>(entry->ifa_addr)->sin_addr.s_addr != wanted_address)
+        {
+            continue;
+        }
+        interface_name = entry->ifa_name;
+        interface_loopback = (entry->ifa_flags & IFF_LOOPBACK) != 0;
+        interface_address = wanted_address;
+        if (entry->ifa_netmask != nullptr)
+        {
+            interface_netmask = reinterpret_cast<struct sockaddr_in*>(entry->ifa_netmask)->sin_addr.s_addr;
+        }
+        break;
+    }
+    freeifaddrs(interface_list);
+    if (interface_name.empty())
+    {
+        return false;
+    }
+
+    struct ifreq interface_request;
+    memset(&interface_request, 0, sizeof(interface_request));
+    strncpy(interface_request.ifr_name, interface_name.c_str(), IFNAMSIZ - 1);
+    if (ioctl(packet_socket, SIOCGIFINDEX, &interface_request) < 0)
+    {
+        return false;
+    }
+    interface_index = interface_request.ifr_ifindex;
+    if (ioctl(packet_socket, SIOCGIFHWADDR, &interface_request) == 0)
+    {
+        memcpy(source_mac, interface_request.ifr_hwaddr.sa_data, 6);
+    }
+    if (ioctl(packet_socket, SIOCGIFMTU, &interface_request) == 0 && interface_request.ifr_mtu > 0)
+    {
+        interface_mtu = static_cast<uint32_t>(interface_request.ifr_mtu);
+    }
+    return true;
+}
+
+
+/*
+*
+*/
+const uint8_t* PacketRingSender::next_hop_mac(const boost::asio::ip::address_v4& destination)
+{
+    uint32_t destination_ip = htonl(destination.to_uint());
+    auto cache_entry = next_hop_cache.find(destination_ip);
+    if (cache_entry != next_hop_cache.end())
+    {
+        return cache_entry->second.data();
+    }
+
+    std::array<uint8_t, 6> mac;
+    mac.fill(0);
+    if (!interface_loopback)
+    {
+        std::chrono::steady_clock::time_point time_now = std::chrono::steady_clock::now();
+        auto retry_entry = next_hop_retry.find(destination_ip);
+        if (retry_entry != next_hop_retry.end() && time_now < retry_entry->second)
+        {
+            return nullptr;
+        }
+
+        bool on_link = (destination_ip & interface_netmask) == (interface_address & interface_netmask);
+        uint32_t next_hop = on_link ? destination_ip : interface_gateway();
+        if (next_hop == 0 || !neighbour_mac(next_hop, mac.data()))
+        {
+            // Unresolved neighbour, probed and looked up again after the retry interval
+            if (retry_entry == next_hop_retry.end())
+            {
+                RM_logWarning("Packet ring sender no neighbour entry for " << destination.to_string() << " on " << interface_name << ", resolving")
+            }
+            if (next_hop != 0)
+            {
+                probe_neighbour(next_hop);
+            }
+            next_hop_retry[destination_ip] = time_now + NEXT_HOP_RETRY_INTERVAL;
+            return nullptr;
+        }
+        if (retry_entry != next_hop_retry.end())
+        {
+            next_hop_retry.erase(retry_entry);
+            RM_logInfo("Packet ring sender resolved next hop of " << destination.to_string() << " on " << interface_name)
+        }
+    }
+    next_hop_cache[destination_ip] = mac;
+    return next_hop_cache[destination_ip].data();
+}
+
+
+/*
+*
+*/
+void PacketRingSender::probe_neighbour(uint32_t address) const
+{
+    int probe_socket = socket(AF_INET, SOCK_DGRAM, 0);
+    if (probe_socket < 0)
+    {
+        return;
+    }
+
+    struct sockaddr_in probe_address;
+    memset(&probe_address, 0, sizeof(probe_address));
+    probe_address.sin_family = AF_INET;
+    probe_address.sin_port = htons(PROBE_PORT);
+    probe_address.sin_addr.s_addr = address;
+
+    // The kernel resolves the next hop while sending, the empty datagram itself is discarded
+    setsockopt(probe_socket, SOL_SOCKET, SO_BINDTODEVICE, interface_name.c_str(), interface_name.size());
+    if (connect(probe_socket, reinterpret_cast<struct sockaddr*>(&probe_address), sizeof(probe_address)) == 0)
+    {
+        send(probe_socket, nullptr, 0, MSG_DONTWAIT);
+    }
+    close(probe_socket);
+}
+
+
+/*
+*
+*/
+bool PacketRingSender::neighbour_mac(uint32_t address, uint8_t* mac) const
+{
+    std::ifstream neighbour_table("/proc/net/arp");
+    std::string line;
+    std::getline(neighbour_table, line);
+    while (std::getline(neighbour_table, line))
+    {
+        std::istringstream entry(line);
+        std::string ip_string, hardware_type, flags, mac_string, mask, device;
+        if (!(entry >> ip_string >> hardware_type >> flags >> mac_string >> mask >> device))
+        {
+            continue;
+        }
+        struct in_addr entry_address;
+        if (device != interface_name || inet_pton(AF_INET, ip_string.c_str(), &entry_address) != 1 || entry_address.s_addr != address)
+        {
+            continue;
+        }
+        // ATF_COM, entry is complete
+        if ((std::stoul(flags, nullptr, 16) & 0x2) == 0)
+        {
+            return false;
+        }
+        unsigned int bytes[6];
+        if (sscanf(mac_string.c_str(), "%x:%x:%x:%x:%x:%x", &bytes[0], &bytes[1], &bytes[2], &bytes[3], &bytes[4], &bytes[5]) != 6)
+        {
+            return false;
+        }
+        for (int index = 0; index < 6; ++index)
+        {
+            mac[index] = static_cast<uint8_t>(bytes[index]);
+        }
+        return true;
+    }
+    return false;
+}
+
+
+/*
+*
+*/
+uint32_t PacketRingSender::interface_gateway() const
+{
+    std::ifstream routing_table("/proc/net/route");
+    std::string line;
+    std::getline(routing_table, line);
+    while (std::getline(routing_table, line))
+    {
+        std::istringstream entry(line);
+        std::string device, destination, gateway;
+        if (!(entry >> device >> destination >> gateway))
+        {
+            continue;
+        }
+        if (device != interface_name || std::stoul(destination, nullptr, 16) != 0)
+        {
+            continue;
+        }
+        // The kernel prints the network order word as a host integer, parsing it back yields the
+        // network order value on any host (le32toh would swap it on big-endian hosts)
+        uint32_t gateway_address = static_cast<uint32_t>(std::stoul(gateway, nullptr, 16));
+        if (gateway_address != 0 && (gateway_address & interface_netmask) == (interface_address & interface_netmask))
+        {
+            return gateway_address;
+        }
+    }
+    return 0;
+}
+
+
+/*
+*
+*/
+bool PacketRingSender::claim_frames(uint32_t frame_number, uint32_t& datagrams_sent)
+{
+    if (frame_number > frame_count)
+    {
+        return false;
+    }
+
+    bool flushed = false;
+    for (uint32_t frame_offset = 0; frame_offset < frame_number; ++frame_offset)
+    {
+        char* frame = ring + static_cast<size_t>((frame_index + frame_offset) % frame_count) * frame_size;
+        struct tpacket2_hdr* frame_header = reinterpret_cast<struct tpacket2_hdr*>(frame);
+
+        uint32_t status = __atomic_load_n(&frame_header->tp_status, __ATOMIC_ACQUIRE);
+        if ((status & (TP_STATUS_SEND_REQUEST | TP_STATUS_SENDING)) && !flushed)
+        {
+            // Ring wrapped onto frames the kernel did not process yet
+            datagrams_sent += flush();
+            flushed = true;
+            status = __atomic_load_n(&frame_header->tp_status, __ATOMIC_ACQUIRE);
+        }
+        if (status & (TP_STATUS_SEND_REQUEST | TP_STATUS_SENDING))
+        {
+            return false;
+        }
+        if (status & TP_STATUS_WRONG_FORMAT)
+        {
+            ++error_count;
+            RM_logError("Packet ring sender frame rejected by the kernel")
+        }
+    }
+    return true;
+}
+
+
+/*
+*
+*/
+char* PacketRingSender::claimed_frame() const
+{
+    return ring + static_cast<size_t>(frame_index) * frame_size;
+}
+
+
+/*
+*
+*/
+void PacketRingSender::commit_frame(char* frame, size_t frame_length)
+{
+    struct tpacket2_hdr* frame_header = reinterpret_cast<struct tpacket2_hdr*>(frame);
+    frame_header->tp_len = static_cast<uint32_t>(frame_length);
+    __atomic_store_n(&frame_header->tp_status, static_cast<uint32_t>(TP_STATUS_SEND_REQUEST), __ATOMIC_RELEASE);
+    frame_index = (frame_index + 1) % frame_count;
+    ++queued_frames;
+}
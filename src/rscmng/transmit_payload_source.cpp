@@ -0,0 +1,210 @@
+// Copyright (C) 2025 IDA
+//
+// This file is part of a project licensed under the GNU Lesser General Public License v3.0.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+
+#include <cerrno>
+#include <algorithm>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <rscmng/transmit/payload_source.hpp>
+
+
+using namespace traffic_generator;
+
+
+/*
+*
+*/
+PayloadSource::PayloadSource(std::string source_path, size_t fragment_payload_size)
+:
+    source_path(source_path),
+    fragment_payload_size(fragment_payload_size > 0 ? fragment_payload_size : 1),
+    next_frame(0),
+    largest_frame(0)
+{
+    struct stat source_stat;
+    if (stat(source_path.c_str(), &source_stat) != 0)
+    {
+        RM_logWarning("Payload source " << source_path << " not accessible: " << strerror(errno))
+        return;
+    }
+
+    if (S_ISDIR(source_stat.st_mode))
+    {
+        std::vector<std::string> frame_names;
+        DIR* directory = opendir(source_path.c_str());
+        if (directory == nullptr)
+        {
+            RM_logWarning("Payload source directory " << source_path << " not readable: " << strerror(errno))
+            return;
+        }
+        for (struct dirent* entry = readdir(directory); entry != nullptr; entry = readdir(directory))
+        {
+            if (entry->d_name[0] != '.')
+            {
+                frame_names.push_back(entry->d_name);
+            }
+        }
+        closedir(directory);
+
+        // Frames are replayed in lexical order, e.g. frame_000001.bin, frame_000002.bin, ...
+        std::sort(frame_names.begin(), frame_names.end());
+        for (const auto& frame_name : frame_names)
+        {
+            std::string frame_path = source_path + "/" + frame_name;
+            struct stat frame_stat;
+            if (stat(frame_path.c_str(), &frame_stat) == 0 && S_ISREG(frame_stat.st_mode))
+            {
+                map_file(frame_path);
+            }
+        }
+    }
+    else if (S_ISREG(source_stat.st_mode))
+    {
+        map_file(source_path);
+    }
+
+    if (frames.empty())
+    {
+        RM_logWarning("Payload source " << source_path << " contains no frames")
+        return;
+    }
+    RM_logInfo("Payload source " << source_path << " mapped " << frames.size() << " frames, largest " << largest_frame << " bytes")
+}
+
+
+/*
+*
+*/
+PayloadSource::~PayloadSource()
+{
+    for (auto& frame : frames)
+    {
+        munmap(frame.address, frame.length);
+    }
+}
+
+
+/*
+*
+*/
+bool PayloadSource::valid() const
+{
+    return !frames.empty();
+}
+
+
+/*
+*
+*/
+uint32_t PayloadSource::object_count() const
+{
+    return static_cast<uint32_t>(frames.size());
+}
+
+
+/*
+*
+*/
+uint64_t PayloadSource::largest_object() const
+{
+    return largest_frame;
+}
+
+
+/*
+*
+*/
+const std::string& PayloadSource::path() const
+{
+    return source_path;
+}
+
+
+/*
+*
+*/
+struct payload_object PayloadSource::next_object()
+{
+    const struct mapped_frame& frame = frames[next_frame];
+    next_frame = (next_frame + 1) % frames.size();
+
+    struct payload_object object;
+    object.data = static_cast<const char*>(frame.address);
+    object.size = frame.length;
+    object.fragment_stride = fragment_payload_size;
+    object.fragment_count = fragment_count(frame.length);
+    return object;
+}
+
+
+/*
+*
+*/
+uint32_t PayloadSource::fragment_count(uint64_t object_size) const
+{
+    if (object_size == 0)
+    {
+        return 1;
+    }
+    return static_cast<uint32_t>((object_size + fragment_payload_size - 1) / fragment_payload_size);
+}
+
+
+/*------------------------------------- Private -----------------------------------------*/
+/*
+*
+*/
+bool PayloadSource::map_file(const std::string& file_path)
+{
+    int file_descriptor = open(file_path.c_str(), O_RDONLY);
+    if (file_descriptor < 0)
+    {
+        RM_logWarning("Payload source cannot open " << file_path << ": " << strerror(errno))
+        return false;
+    }
+
+    struct stat file_stat;
+    if (fstat(file_descriptor, &file_stat) != 0 || file_stat.st_size == 0)
+    {
+        close(file_descriptor);
+        return false;
+    }
+
+    size_t length = static_cast<size_t>(file_stat.st_size);
+    // Populate up front, a page fault in the transmit loop would show up as pacing lateness
+    void* address = mmap(nullptr, length, PROT_READ, MAP_PRIVATE | MAP_POPULATE, file_descriptor, 0);
+    close(file_descriptor);
+    if (address == MAP_FAILED)
+    {
+        RM_logWarning("Payload source cannot map " << file_path << ": " << strerror(errno))
+        return false;
+    }
+    madvise(address, length, MADV_WILLNEED);
+
+    struct mapped_frame frame;
+    frame.address = address;
+    frame.length = length;
+    frames.push_back(frame);
+    largest_frame = std::max<uint64_t>(largest_frame, length);
+    return true;
+}
@@ -0,0 +1,590 @@
+// Copyright (C) 2025 IDA
+//
+// This file is part of a project licensed under the GNU Lesser General Public License v3.0.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+
+#include <algorithm>
+#include <stdexcept>
+
+#include <rscmng/transmit_scheduler.hpp>
+
+
+using namespace rscmng;
+using namespace traffic_generator;
+
+
+/*
+*
+*/
+bool scheduled_fragment_later::operator()(const scheduled_fragment& a, const scheduled_fragment& b) const
+{
+    int64_t due_difference = PacingEngine::diff_ns(a.due, b.due);
+    if (due_difference != 0)
+    {
+        return due_difference > 0;
+    }
+    return PacingEngine::diff_ns(a.object_deadline, b.object_deadline) > 0;
+}
+
+
+/*
+*
+*/
+TransmitScheduler::scheduler_worker::scheduler_worker(const udp::endpoint& local_endpoint, const traffic_generator_parameter& traffic_pattern, clockid_t clock, uint32_t worker_index)
+:
+    notify_sequence(0),
+    transmit_path(local_endpoint, traffic_pattern, "Transmit Scheduler worker " + std::to_string(worker_index)),
+    pacing(clock, traffic_pattern.pacing_strategy, traffic_pattern.pacing_spin_margin)
+{
+
+}
+
+
+/*
+*
+*/
+TransmitScheduler::TransmitScheduler(
+    struct rscmng::config::unit_settings client_configuration,
+    struct rscmng::config::experiment_parameter experiment_parameter,
+    uint32_t worker_count,
+    traffic_generator_parameter traffic_pattern
+):
+    client_configuration_struct(client_configuration),
+    experiment_parameter_struct(experiment_parameter),
+    traffic_pattern(traffic_pattern),
+    timeline_clock(timeline_clock_from_string(experiment_parameter.timeline_clock)),
+    stop_thread(false),
+    started(false),
+    dummy_payload(DataMessageTemplate::max_payload(traffic_pattern.message_version), 'A')
+{
+    // Batching backends hold fragments back, every fragment of the scheduler has its own due time
+    if (traffic_pattern.transmit_backend != TRANSMIT_SOCKET && traffic_pattern.transmit_backend != TRANSMIT_TXTIME)
+    {
+        RM_logError("Transmit Scheduler does not support TRANSMIT_BACKEND " << client_configuration.transmit_backend << ", use SOCKET or TXTIME")
+        throw std::invalid_argument("TRANSMIT_BACKEND " + client_configuration.transmit_backend + " not supported with TRANSMIT_SCHEDULER");
+    }
+
+    udp::endpoint scheduler_endpoint_local(boost::asio::ip::address::from_string(client_configuration.rm_control_local_ip[0]), 10000);
+    if (worker_count == 0)
+    {
+        worker_count = 1;
+    }
+    for (uint32_t worker_index = 0; worker_index < worker_count; ++worker_index)
+    {
+        workers.emplace_back(new scheduler_worker(scheduler_endpoint_local, traffic_pattern, timeline_clock_id(timeline_clock), worker_index));
+    }
+
+    RM_logInfo("Transmit Scheduler constructor done, " << worker_count << " worker threads")
+}
+
+
+/*
+*
+*/
+TransmitScheduler::~TransmitScheduler()
+{
+    stop();
+}
+
+
+/*
+*
+*/
+uint32_t TransmitScheduler::add_service(std::map<uint32_t, struct rscmng::config::service_settings> service_settings)
+{
+    if (started)
+    {
+        RM_logWarning("Transmit Scheduler services can not be added while running")
+        return static_cast<uint32_t>(-1);
+    }
+
+    std::unique_ptr<scheduled_service> service(new scheduled_service());
+    service->service_settings = service_settings;
+    service->control.reset(new GeneratorControl());
+    service->worker_index = static_cast<uint32_t>(services.size() % workers.size());
+    service->timeline = HyperperiodTimeline(timeline_clock);
+
+    // Compiled once on the path of the owning worker, a mode switch only swaps the plan pointer
+    service->transmission_plans = compile_transmission_plans(
+        service->service_settings,
+        client_configuration_struct.client_id,
+        traffic_pattern.message_version,
+        workers[service->worker_index]->transmit_path
+    );
+    RM_logInfo("Transmit Scheduler service " << services.size() << " with " << service->transmission_plans.size() << " modes on worker " << service->worker_index)
+
+    services.push_back(std::move(service));
+    return static_cast<uint32_t>(services.size() - 1);
+}
+
+
+/*
+*
+*/
+void TransmitScheduler::start()
+{
+    if (started)
+    {
+        return;
+    }
+    started = true;
+    stop_thread = false;
+    for (uint32_t worker_index = 0; worker_index < workers.size(); ++worker_index)
+    {
+        workers[worker_index]->worker_thread = std::thread{&TransmitScheduler::run_worker, this, worker_index};
+    }
+}
+
+
+/*
+*
+*/
+void TransmitScheduler::stop()
+{
+    if (!started)
+    {
+        return;
+    }
+    stop_thread = true;
+    for (auto& worker : workers)
+    {
+        worker->notify_sequence.fetch_add(1, std::memory_order_release);
+        {
+            std::lock_guard<std::mutex> lock(worker->wakeup_mutex);
+        }
+        worker->wakeup_condition.notify_one();
+    }
+    for (auto& worker : workers)
+    {
+        if (worker->worker_thread.joinable())
+        {
+            worker->worker_thread.join();
+        }
+    }
+    started = false;
+}
+
+
+/*
+*
+*/
+void TransmitScheduler::notify_service(uint32_t service_index, TrafficSourceControl state)
+{
+    if (service_index >= services.size())
+    {
+        RM_logWarning("Transmit Scheduler notification for unknown service " << service_index)
+        return;
+    }
+    services[service_index]->control->publish_state(state);
+    wake_worker(service_index);
+}
+
+
+/*
+*
+*/
+void TransmitScheduler::notify_service_mode_change(uint32_t service_index, TrafficSourceControl state, uint32_t mode)
+{
+    if (service_index >= services.size())
+    {
+        RM_logWarning("Transmit Scheduler notification for unknown service " << service_index)
+        return;
+    }
+    services[service_index]->control->publish_mode(state, mode);
+    wake_worker(service_index);
+    RM_logInfo("Transmit Scheduler service " << service_index << " reconfiguration with new mode: " << mode)
+}
+
+
+/*
+*
+*/
+void TransmitScheduler::notify_service_timestamp(uint32_t service_index, TrafficSourceControl state, struct timespec timestamp, uint32_t mode, bool update_period)
+{
+    if (service_index >= services.size())
+    {
+        RM_logWarning("Transmit Scheduler notification for unknown service " << service_index)
+        return;
+    }
+    services[service_index]->control->publish_timestamp(state, timestamp, mode, update_period);
+    wake_worker(service_index);
+    RM_logInfo("Transmit Scheduler service " << service_index << " reconfiguration with new mode: " << mode << " at timestamp " << timestamp.tv_sec << " s, " << timestamp.tv_nsec << " ns")
+}
+
+
+/*
+*
+*/
+uint32_t TransmitScheduler::service_count() const
+{
+    return static_cast<uint32_t>(services.size());
+}
+
+
+/*
+*
+*/
+void TransmitScheduler::print_statistics()
+{
+    for (uint32_t service_index = 0; service_index < services.size(); ++service_index)
+    {
+        const scheduled_service& service = *services[service_index];
+        RM_logInfo("Transmit Scheduler service " << service_index << " objects: " << service.objects_sent
+            << " fragments: " << service.fragments_sent << " deadline misses: " << service.deadline_misses)
+    }
+    for (uint32_t worker_index = 0; worker_index < workers.size(); ++worker_index)
+    {
+        workers[worker_index]->pacing.print_statistics("Transmit Scheduler worker " + std::to_string(worker_index));
+        workers[worker_index]->transmit_path.print_statistics();
+    }
+}
+
+
+/*------------------------------------- Private -----------------------------------------*/
+/*
+*
+*/
+void TransmitScheduler::run_worker(uint32_t worker_index)
+{
+    RM_logInfo("Transmit Scheduler worker " << worker_index << " started")
+    RealtimeProfile::instance().apply(RT_THREAD_TRANSMIT_WORKER);
+
+    scheduler_worker& worker = *workers[worker_index];
+    fragment_queue queue;
+
+    uint64_t seen_sequence = 0;
+    bool rescan = true;
+
+    while (!stop_thread)
+    {
+        // Pick up notifications of the services owned by this worker
+        uint64_t current_sequence = worker.notify_sequence.load(std::memory_order_acquire);
+        if (rescan || current_sequence != seen_sequence)
+        {
+            seen_sequence = current_sequence;
+            rescan = false;
+            for (uint32_t service_index = 0; service_index < services.size(); ++service_index)
+            {
+                if (services[service_index]->worker_index == worker_index)
+                {
+                    refresh_service(*services[service_index], service_index, queue);
+                }
+            }
+        }
+
+        // Entries of restarted or paused services are dropped lazily
+        while (!queue.empty() && queue.top().generation != services[queue.top().service_index]->generation)
+        {
+            queue.pop();
+        }
+
+        if (queue.empty())
+        {
+            std::unique_lock<std::mutex> lock(worker.wakeup_mutex);
+            worker.wakeup_condition.wait(lock, [&] {
+                return stop_thread || worker.notify_sequence.load(std::memory_order_acquire) != seen_sequence;
+            });
+            continue;
+        }
+
+        scheduled_fragment next_fragment = queue.top();
+        int64_t lateness_ns = worker.pacing.wait_until(next_fragment.due, [&] {
+            return stop_thread || worker.notify_sequence.load(std::memory_order_relaxed) != seen_sequence;
+        });
+        if (lateness_ns < 0)
+        {
+            continue;
+        }
+
+        queue.pop();
+        dispatch(*services[next_fragment.service_index], next_fragment.service_index, queue);
+    }
+
+    RM_logInfo("Transmit Scheduler worker " << worker_index << " stopped")
+}
+
+
+/*
+*
+*/
+void TransmitScheduler::wake_worker(uint32_t service_index)
+{
+    scheduler_worker& worker = *workers[services[service_index]->worker_index];
+    worker.notify_sequence.fetch_add(1, std::memory_order_release);
+    {
+        std::lock_guard<std::mutex> lock(worker.wakeup_mutex);
+    }
+    worker.wakeup_condition.notify_one();
+}
+
+
+
+
+/*
+*
+*/
+void TransmitScheduler::refresh_service(scheduled_service& service, uint32_t service_index, fragment_queue& queue)
+{
+    control_snapshot control = service.control->snapshot();
+    struct transmission_state& state = service.state;
+
+    bool object_in_progress = state.fragment_number > 0;
+    bool transmission = control.state == THREAD_TRANSMISSION
+        || (control.state == THREAD_TRANSMISSION_FINISH_OBJECT && object_in_progress);
+
+    if (!transmission)
+    {
+        if (service.active)
+        {
+            service.active = false;
+            ++service.generation;
+        }
+        return;
+    }
+
+    // In synchronous mode a running object keeps its mode and period until its last fragment
+    bool control_changed = false;
+    if (!experiment_parameter_struct.synchronous_start_mode || !object_in_progress)
+    {
+        uint32_t previous_mode = state.mode;
+        uint64_t previous_period_version = state.period_version;
+        if (!apply_control(service, control))
+        {
+            service.active = false;
+            ++service.generation;
+            return;
+        }
+        if (object_in_progress && state.mode != previous_mode)
+        {
+            resume_object(state);
+        }
+        control_changed = state.mode != previous_mode || state.period_version != previous_period_version;
+    }
+
+    if (!service.active)
+    {
+        service.active = true;
+        ++service.generation;
+        if (object_in_progress)
+        {
+            queue_fragment(service, service_index, queue);
+        }
+        else
+        {
+            start_object(service, service_index, queue);
+        }
+    }
+    else if (!object_in_progress && control_changed)
+    {
+        // The first fragment is not out yet, release the object again with the new period or mode
+        ++service.generation;
+        start_object(service, service_index, queue);
+    }
+}
+
+
+/*
+*
+*/
+void TransmitScheduler::dispatch(scheduled_service& service, uint32_t service_index, fragment_queue& queue)
+{
+    struct transmission_state& state = service.state;
+    TransmitPath& transmit_path = workers[service.worker_index]->transmit_path;
+
+    if (!experiment_parameter_struct.synchronous_start_mode)
+    {
+        control_snapshot control = service.control->snapshot();
+        if (control.mode != state.mode)
+        {
+            if (!apply_control(service, control))
+            {
+                service.active = false;
+                ++service.generation;
+                return;
+            }
+            resume_object(state);
+        }
+    }
+
+    const struct transmission_plan& plan = *state.plan;
+
+    struct timespec time_send = {0,0};
+    clock_gettime(CLOCK_REALTIME, &time_send);
+    state.header_template.patch(state.fragment_number, time_send, state.payload_size);
+    transmit_path.register_fragment(plan.settings->service_id, state.object_number, state.fragment_number, time_send);
+
+    // Every fragment has its own due time, nothing is held back for a batch
+    uint32_t fragments_sent = transmit_path.transmit_fragment(
+        state.header_template,
+        state.payload.data + state.payload.fragment_stride * state.fragment_number,
+        state.payload_size,
+        plan.destination,
+        true,
+        PacingEngine::add_ns(state.object_launch_time, plan.inter_packet_gap_ns * state.fragment_number)
+    );
+    service.fragments_sent += fragments_sent;
+    transmit_path.poll_timestamps();
+
+    ++state.fragment_number;
+    state.remaining_bytes -= std::min<uint64_t>(state.remaining_bytes, state.payload_size);
+    state.payload_size = static_cast<size_t>(std::min<uint64_t>(state.remaining_bytes, state.fragment_payload));
+
+    if (state.fragment_number < state.payload.fragment_count)
+    {
+        queue_fragment(service, service_index, queue);
+        return;
+    }
+
+    // Object complete
+    if (service.timeline.now() > service.timeline.slot_start(state.object_slot) + plan.deadline_ns)
+    {
+        ++service.deadline_misses;
+    }
+    ++service.objects_sent;
+    ++state.object_number;
+    ++state.schedule_entry;
+    state.fragment_number = 0;
+    transmit_path.drain_timestamps();
+
+    control_snapshot control = service.control->snapshot();
+    if (control.state != THREAD_TRANSMISSION || !apply_control(service, control))
+    {
+        service.active = false;
+        ++service.generation;
+        return;
+    }
+
+    start_object(service, service_index, queue);
+}
+
+
+/*
+*
+*/
+bool TransmitScheduler::apply_control(scheduled_service& service, const control_snapshot& control)
+{
+    struct transmission_state& state = service.state;
+    bool period_changed = control.period_version != state.period_version;
+    if (control.mode == state.mode && !period_changed)
+    {
+        return true;
+    }
+
+    if (control.mode != state.mode)
+    {
+        auto plan_iterator = service.transmission_plans.find(control.mode);
+        if (plan_iterator == service.transmission_plans.end())
+        {
+            RM_logWarning("Transmit Scheduler mode points to unknown setting: " << control.mode)
+            return false;
+        }
+        state.mode = control.mode;
+        state.plan = &plan_iterator->second;
+    }
+
+    if (period_changed)
+    {
+        // Period timestamps are CLOCK_REALTIME, the timeline anchors once on its own clock
+        service.timeline.anchor(service.timeline.from_realtime(control.period_timestamp), state.plan->deadline_ns);
+        state.period_version = control.period_version;
+    }
+    else if (service.timeline.anchored() && service.timeline.period() != state.plan->deadline_ns)
+    {
+        // New period from the start of the current object on
+        service.timeline.rebase(state.object_slot, state.plan->deadline_ns);
+    }
+    else
+    {
+        return true;
+    }
+    state.object_slot = 0;
+    state.schedule_entry = 0;
+    return true;
+}
+
+
+/*
+*
+*/
+void TransmitScheduler::start_object(scheduled_service& service, uint32_t service_index, fragment_queue& queue)
+{
+    struct transmission_state& state = service.state;
+    const struct transmission_plan& plan = *state.plan;
+    const TrafficSchedule& schedule = *plan.schedule;
+    int64_t time_now = service.timeline.now();
+
+    // Without a period timestamp the first period starts now
+    if (!service.timeline.anchored())
+    {
+        service.timeline.anchor(time_now, plan.deadline_ns);
+        state.object_slot = 0;
+        state.schedule_entry = 0;
+    }
+    // After a pause or an overrun skip the periods that passed
+    uint64_t current_slot = service.timeline.slot_index(time_now);
+    if (current_slot > state.object_slot)
+    {
+        state.object_slot = current_slot;
+        state.schedule_entry = 0;
+    }
+    // Periods without a release are skipped, compiled schedules release at least one object
+    while (state.schedule_entry >= schedule.objects_in_period(state.object_slot))
+    {
+        ++state.object_slot;
+        state.schedule_entry = 0;
+    }
+
+    const struct object_release& release = schedule.release(state.object_slot, state.schedule_entry);
+    service.object_release_ns = service.timeline.slot_start(state.object_slot) + release.offset_ns + static_cast<int64_t>(plan.settings->slot_offset) * 1000000LL;
+    if (service.object_release_ns < time_now)
+    {
+        service.object_release_ns = time_now;
+    }
+    // Launch times of the object are relative to its release
+    state.object_launch_time = service.timeline.to_realtime(service.object_release_ns);
+
+    // Object payload (mapped frame or dummy payload), its size determines the fragment count
+    state.payload = next_payload(plan, release.size_bytes, dummy_payload);
+    state.remaining_bytes = state.payload.size;
+    state.fragment_payload = plan.max_payload;
+    state.payload_size = static_cast<size_t>(std::min<uint64_t>(state.remaining_bytes, state.fragment_payload));
+    state.fragment_number = 0;
+
+    // Constant header fields are serialized in the plan
+    state.header_template = plan.header_template;
+    state.header_template.begin_object(state.object_number, state.payload.fragment_count);
+
+    queue_fragment(service, service_index, queue);
+}
+
+
+/*
+*
+*/
+void TransmitScheduler::queue_fragment(scheduled_service& service, uint32_t service_index, fragment_queue& queue)
+{
+    const struct transmission_state& state = service.state;
+    const struct transmission_plan& plan = *state.plan;
+
+    scheduled_fragment next_fragment;
+    // The launch time backend hands a fragment to the kernel ahead of its launch time
+    next_fragment.due = HyperperiodTimeline::to_timespec(service.object_release_ns + plan.inter_packet_gap_ns * state.fragment_number
+        - workers[service.worker_index]->transmit_path.launch_lead_ns());
+    next_fragment.object_deadline = HyperperiodTimeline::to_timespec(service.timeline.slot_start(state.object_slot) + plan.deadline_ns);
+    next_fragment.service_index = service_index;
+    next_fragment.generation = service.generation;
+    queue.push(next_fragment);
+}
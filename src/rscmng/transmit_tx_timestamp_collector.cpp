@@ -0,0 +1,238 @@
+// Copyright (C) 2025 IDA
+//
+// This file is part of a project licensed under the GNU Lesser General Public License v3.0.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+
+#include <cerrno>
+
+#include <rscmng/transmit/tx_timestamp_collector.hpp>
+
+
+using namespace rscmng;
+using namespace traffic_generator;
+
+
+/*
+*
+*/
+TxTimestampCollector::TxTimestampCollector(int socket_fd, uint32_t capacity)
+:
+    socket_fd(socket_fd),
+    timestamping_enabled(false),
+    next_key(0),
+    pending(capacity > 0 ? capacity : 1),
+    drain_interval(std::max<uint32_t>(1, std::min<uint32_t>(64, capacity / 4))),
+    registered_since_drain(0),
+    registered_count(0),
+    matched_count(0),
+    unmatched_count(0),
+    overflow_count(0)
+{
+    for (auto& fragment : pending)
+    {
+        fragment.valid = false;
+    }
+
+    // OPT_ID numbers the datagrams from 0 on, counted from this call
+    uint32_t timestamping_flags = SOF_TIMESTAMPING_TX_SOFTWARE
+        | SOF_TIMESTAMPING_SOFTWARE
+        | SOF_TIMESTAMPING_OPT_ID
+        | SOF_TIMESTAMPING_OPT_TSONLY;
+
+    timestamping_enabled = setsockopt(socket_fd, SOL_SOCKET, SO_TIMESTAMPING, &timestamping_flags, sizeof(timestamping_flags)) == 0;
+    if (timestamping_enabled)
+    {
+        RM_logInfo("TX timestamping enabled, " << pending.size() << " fragments in flight")
+    }
+    else
+    {
+        RM_logWarning("TX timestamping SO_TIMESTAMPING not available: " << strerror(errno))
+    }
+}
+
+
+/*
+*
+*/
+bool TxTimestampCollector::active() const
+{
+    return timestamping_enabled;
+}
+
+
+/*
+*
+*/
+void TxTimestampCollector::register_fragment(serviceID_t service_id, uint32_t object_number, uint32_t fragment_number, const struct timespec& send_time)
+{
+    if (!timestamping_enabled)
+    {
+        return;
+    }
+
+    struct pending_fragment& fragment = pending[next_key % pending.size()];
+    if (fragment.valid)
+    {
+        // Completion never arrived before the slot was reused
+        ++overflow_count;
+    }
+    fragment.timestamp_key = next_key;
+    fragment.service_id = service_id;
+    fragment.object_number = object_number;
+    fragment.fragment_number = fragment_number;
+    fragment.send_time = send_time;
+    fragment.valid = true;
+
+    ++next_key;
+    ++registered_count;
+    ++registered_since_drain;
+}
+
+
+/*
+*
+*/
+uint32_t TxTimestampCollector::drain()
+{
+    char data[64];
+    char control[512];
+    uint32_t matched = 0;
+    registered_since_drain = 0;
+
+    while (true)
+    {
+        struct iovec error_iovec;
+        error_iovec.iov_base = data;
+        error_iovec.iov_len = sizeof(data);
+
+        struct msghdr message;
+        memset(&message, 0, sizeof(message));
+        message.msg_iov = &error_iovec;
+        message.msg_iovlen = 1;
+        message.msg_control = control;
+        message.msg_controllen = sizeof(control);
+
+        if (recvmsg(socket_fd, &message, MSG_ERRQUEUE | MSG_DONTWAIT) < 0)
+        {
+            break;
+        }
+
+        const struct scm_timestamping* timestamps = nullptr;
+        const struct sock_extended_err* extended_error = nullptr;
+
+        for (struct cmsghdr* control_header = CMSG_FIRSTHDR(&message); control_header != nullptr; control_header = CMSG_NXTHDR(&message, control_header))
+        {
+            if (control_header->cmsg_level == SOL_SOCKET && control_header->cmsg_type == SCM_TIMESTAMPING)
+            {
+                timestamps = reinterpret_cast<const struct scm_timestamping*>(CMSG_DATA(control_header));
+            }
+            else if ((control_header->cmsg_level == SOL_IP && control_header->cmsg_type == IP_RECVERR)
+                || (control_header->cmsg_level == SOL_IPV6 && control_header->cmsg_type == IPV6_RECVERR))
+            {
+                extended_error = reinterpret_cast<const struct sock_extended_err*>(CMSG_DATA(control_header));
+            }
+        }
+
+        if (extended_error == nullptr)
+        {
+            continue;
+        }
+
+        if (extended_error->ee_origin == SO_EE_ORIGIN_TIMESTAMPING && timestamps != nullptr)
+        {
+            if (complete(extended_error->ee_data, timestamps->ts[0]))
+            {
+                ++matched;
+            }
+        }
+        else if (foreign_error_handler)
+        {
+            foreign_error_handler(*extended_error);
+        }
+    }
+
+    return matched;
+}
+
+
+/*
+*
+*/
+uint32_t TxTimestampCollector::poll()
+{
+    if (registered_since_drain < drain_interval)
+    {
+        return 0;
+    }
+    return drain();
+}
+
+
+/*
+*
+*/
+void TxTimestampCollector::set_foreign_error_handler(std::function<void(const struct sock_extended_err&)> handler)
+{
+    foreign_error_handler = handler;
+}
+
+
+/*
+*
+*/
+const LogLinearHistogram& TxTimestampCollector::send_delay() const
+{
+    return send_delay_histogram;
+}
+
+
+/*
+*
+*/
+void TxTimestampCollector::print_statistics(std::string name)
+{
+    drain();
+    send_delay_histogram.print(name + " send delay");
+    RM_logInfo(name << " registered: " << registered_count << " matched: " << matched_count << " unmatched: " << unmatched_count
+        << " pending ring overflows: " << overflow_count)
+}
+
+
+/*------------------------------------- Private -----------------------------------------*/
+/*
+*
+*/
+bool TxTimestampCollector::complete(uint32_t timestamp_key, const struct timespec& kernel_time)
+{
+    struct pending_fragment& fragment = pending[timestamp_key % pending.size()];
+    if (!fragment.valid || fragment.timestamp_key != timestamp_key)
+    {
+        ++unmatched_count;
+        return false;
+    }
+    fragment.valid = false;
+
+    int64_t send_delay_ns = PacingEngine::diff_ns(kernel_time, fragment.send_time);
+    send_delay_histogram.record(send_delay_ns > 0 ? send_delay_ns : 0);
+    ++matched_count;
+
+    if (log_each_completion)
+    {
+        RM_logInfo("TX completion service " << fragment.service_id << " object " << fragment.object_number
+            << " fragment " << fragment.fragment_number << " send delay " << send_delay_ns << " ns")
+    }
+    return true;
+}
@@ -0,0 +1,393 @@
+// Copyright (C) 2025 IDA
+//
+// This file is part of a project licensed under the GNU Lesser General Public License v3.0.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+
+#include <cerrno>
+#include <vector>
+
+#include <unistd.h>
+#include <ifaddrs.h>
+#include <net/if.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+
+#include <rscmng/transmit/txtime_sender.hpp>
+
+
+using namespace rscmng;
+using namespace traffic_generator;
+
+
+/*
+*
+*/
+TxTimeSender::TxTimeSender(int socket_fd, bool log_only, std::chrono::microseconds lead_time, PacingStrategy strategy, std::chrono::microseconds spin_margin)
+:
+    socket_fd(socket_fd),
+    txtime_enabled(false),
+    external_error_queue(false),
+    lead_time_ns(std::chrono::duration_cast<std::chrono::nanoseconds>(lead_time).count()),
+    tai_offset_ns(0),
+    launch_pacing(CLOCK_REALTIME, strategy, spin_margin),
+    datagram_count(0),
+    clamped_count(0),
+    missed_count(0),
+    invalid_count(0),
+    error_count(0)
+{
+    struct timespec time_realtime = {0,0};
+    struct timespec time_tai = {0,0};
+    clock_gettime(CLOCK_REALTIME, &time_realtime);
+    clock_gettime(CLOCK_TAI, &time_tai);
+    tai_offset_ns = PacingEngine::diff_ns(time_tai, time_realtime);
+
+    if (!log_only)
+    {
+        struct sock_txtime txtime_config;
+        txtime_config.clockid = CLOCK_TAI;
+        txtime_config.flags = SOF_TXTIME_REPORT_ERRORS;
+
+        txtime_enabled = setsockopt(socket_fd, SOL_SOCKET, SO_TXTIME, &txtime_config, sizeof(txtime_config)) == 0;
+        if (!txtime_enabled)
+        {
+            RM_logWarning("TxTime sender SO_TXTIME not available (" << strerror(errno) << "), logging launch times only")
+        }
+    }
+
+    if (txtime_enabled)
+    {
+        // SO_TXTIME is accepted on any socket, only an ETF qdisc on the egress interface holds datagrams until their launch time
+        std::string interface_name;
+        int interface_index = egress_interface(socket_fd, interface_name);
+        int etf_present = interface_index > 0 ? etf_qdisc_present(interface_index) : -1;
+        if (etf_present == 0)
+        {
+            RM_logWarning("TxTime sender no ETF qdisc on " << interface_name << ", launch times would be ignored, logging launch times only")
+            txtime_enabled = false;
+        }
+        else if (etf_present < 0)
+        {
+            RM_logWarning("TxTime sender ETF qdisc of the egress interface " << (interface_name.empty() ? "unknown" : interface_name)
+                << " could not be verified, launch times are ignored without it")
+        }
+    }
+
+    RM_logInfo("TxTime sender " << (txtime_enabled ? "launch time scheduling" : "launch time logging")
+        << ", lead time " << lead_time_ns / 1000 << " us, TAI offset " << tai_offset_ns << " ns")
+}
+
+
+/*
+*
+*/
+uint32_t TxTimeSender::send(const struct iovec* datagram_iovec, size_t iovec_count, const udp::endpoint& destination, const struct timespec& launch_time)
+{
+    char control[CMSG_SPACE(sizeof(uint64_t))];
+    memset(control, 0, sizeof(control));
+
+    struct msghdr message;
+    memset(&message, 0, sizeof(message));
+    message.msg_name = const_cast<struct sockaddr*>(destination.data());
+    message.msg_namelen = destination.size();
+    message.msg_iov = const_cast<struct iovec*>(datagram_iovec);
+    message.msg_iovlen = iovec_count;
+
+    struct timespec intended_launch = launch_time;
+    struct timespec time_now = launch_pacing.now();
+
+    if (txtime_enabled)
+    {
+        // Work ahead by at most the lead time, launch times behind now + lead time can not be met by ETF
+        if (PacingEngine::diff_ns(intended_launch, time_now) > lead_time_ns)
+        {
+            launch_pacing.wait_until(PacingEngine::add_ns(intended_launch, -lead_time_ns));
+        }
+        else if (PacingEngine::diff_ns(intended_launch, time_now) < lead_time_ns / 2)
+        {
+            intended_launch = PacingEngine::add_ns(time_now, lead_time_ns / 2);
+            ++clamped_count;
+        }
+
+        uint64_t launch_tai_ns = static_cast<uint64_t>(intended_launch.tv_sec) * 1000000000ULL + intended_launch.tv_nsec + tai_offset_ns;
+
+        message.msg_control = control;
+        message.msg_controllen = sizeof(control);
+        struct cmsghdr* control_header = CMSG_FIRSTHDR(&message);
+        control_header->cmsg_level = SOL_SOCKET;
+        control_header->cmsg_type = SCM_TXTIME;
+        control_header->cmsg_len = CMSG_LEN(sizeof(uint64_t));
+        memcpy(CMSG_DATA(control_header), &launch_tai_ns, sizeof(launch_tai_ns));
+    }
+    else
+    {
+        launch_pacing.wait_until(intended_launch);
+    }
+
+    int result;
+    do
+    {
+        result = sendmsg(socket_fd, &message, 0);
+    }
+    while (result < 0 && errno == EINTR);
+
+    if (result < 0)
+    {
+        ++error_count;
+        RM_logError("TxTime sender sendmsg failed: " << strerror(errno))
+        return 0;
+    }
+    ++datagram_count;
+
+    if (!txtime_enabled)
+    {
+        struct timespec time_sent = launch_pacing.now();
+        int64_t send_offset_ns = PacingEngine::diff_ns(time_sent, launch_time);
+        send_offset_histogram.record(send_offset_ns > 0 ? send_offset_ns : 0);
+
+        if (log_each_datagram)
+        {
+            RM_logInfo("TxTime launch intended: " << launch_time.tv_sec << " s " << launch_time.tv_nsec << " ns"
+                << " sent: " << time_sent.tv_sec << " s " << time_sent.tv_nsec << " ns"
+                << " offset: " << send_offset_ns << " ns")
+        }
+    }
+    else if (log_each_datagram)
+    {
+        RM_logInfo("TxTime launch scheduled: " << intended_launch.tv_sec << " s " << intended_launch.tv_nsec << " ns"
+            << " handed over: " << time_now.tv_sec << " s " << time_now.tv_nsec << " ns")
+    }
+
+    if (txtime_enabled && !external_error_queue && (datagram_count & 0x3F) == 0)
+    {
+        drain_error_queue();
+    }
+
+    return 1;
+}
+
+
+/*
+*
+*/
+void TxTimeSender::drain_error_queue()
+{
+    char data[64];
+    char control[512];
+
+    while (true)
+    {
+        struct iovec error_iovec;
+        error_iovec.iov_base = data;
+        error_iovec.iov_len = sizeof(data);
+
+        struct msghdr message;
+        memset(&message, 0, sizeof(message));
+        message.msg_iov = &error_iovec;
+        message.msg_iovlen = 1;
+        message.msg_control = control;
+        message.msg_controllen = sizeof(control);
+
+        if (recvmsg(socket_fd, &message, MSG_ERRQUEUE | MSG_DONTWAIT) < 0)
+        {
+            break;
+        }
+
+        for (struct cmsghdr* control_header = CMSG_FIRSTHDR(&message); control_header != nullptr; control_header = CMSG_NXTHDR(&message, control_header))
+        {
+            if ((control_header->cmsg_level == SOL_IP && control_header->cmsg_type == IP_RECVERR)
+                || (control_header->cmsg_level == SOL_IPV6 && control_header->cmsg_type == IPV6_RECVERR))
+            {
+                handle_error(*reinterpret_cast<struct sock_extended_err*>(CMSG_DATA(control_header)));
+            }
+        }
+    }
+}
+
+
+/*
+*
+*/
+void TxTimeSender::handle_error(const struct sock_extended_err& extended_error)
+{
+    if (extended_error.ee_origin != SO_EE_ORIGIN_TXTIME)
+    {
+        return;
+    }
+    if (extended_error.ee_code == SO_EE_CODE_TXTIME_MISSED)
+    {
+        ++missed_count;
+    }
+    else if (extended_error.ee_code == SO_EE_CODE_TXTIME_INVALID_PARAM)
+    {
+        ++invalid_count;
+    }
+}
+
+
+/*
+*
+*/
+void TxTimeSender::set_external_error_queue(bool external)
+{
+    external_error_queue = external;
+}
+
+
+/*
+*
+*/
+bool TxTimeSender::txtime_active() const
+{
+    return txtime_enabled;
+}
+
+
+/*
+*
+*/
+void TxTimeSender::print_statistics(std::string name)
+{
+    if (txtime_enabled)
+    {
+        if (!external_error_queue)
+        {
+            drain_error_queue();
+        }
+        launch_pacing.print_statistics(name + " lead time");
+    }
+    else
+    {
+        send_offset_histogram.print(name + " send time - launch time");
+    }
+    RM_logInfo(name << " datagrams: " << datagram_count << " launch time clamped: " << clamped_count
+        << " ETF missed: " << missed_count << " ETF invalid: " << invalid_count << " send errors: " << error_count)
+}
+
+
+/*------------------------------------- Private -----------------------------------------*/
+/*
+*
+*/
+int TxTimeSender::egress_interface(int socket_fd, std::string& interface_name)
+{
+    struct sockaddr_in local_address;
+    socklen_t local_length = sizeof(local_address);
+    if (getsockname(socket_fd, reinterpret_cast<struct sockaddr*>(&local_address), &local_length) < 0
+        || local_address.sin_family != AF_INET || local_address.sin_addr.s_addr == htonl(INADDR_ANY))
+    {
+        return 0;
+    }
+
+    struct ifaddrs* interfaces = nullptr;
+    if (getifaddrs(&interfaces) < 0)
+    {
+        return 0;
+    }
+
+    int interface_index = 0;
+    for (struct ifaddrs* entry = interfaces; entry != nullptr; entry = entry->ifa_next)
+    {
+        if (entry->ifa_addr != nullptr && entry->ifa_addr->sa_family == AF_INET
+            && reinterpret_cast<struct sockaddr_in*>(entry->ifa_addr)->sin_addr.s_addr == local_address.sin_addr.s_addr)
+        {
+            interface_name = entry->ifa_name;
+            interface_index = static_cast<int>(if_nametoindex(entry->ifa_name));
+            break;
+        }
+    }
+    freeifaddrs(interfaces);
+    return interface_index;
+}
+
+
+/*
+*
+*/
+int TxTimeSender::etf_qdisc_present(int interface_index)
+{
+    int netlink_fd = socket(AF_NETLINK, SOCK_RAW, NETLINK_ROUTE);
+    if (netlink_fd < 0)
+    {
+        return -1;
+    }
+
+    struct
+    {
+        struct nlmsghdr header;
+        struct tcmsg qdisc;
+    } request;
+    memset(&request, 0, sizeof(request));
+    request.header.nlmsg_len = NLMSG_LENGTH(sizeof(struct tcmsg));
+    request.header.nlmsg_type = RTM_GETQDISC;
+    request.header.nlmsg_flags = NLM_F_REQUEST | NLM_F_DUMP;
+    request.qdisc.tcm_family = AF_UNSPEC;
+    request.qdisc.tcm_ifindex = interface_index;
+
+    if (::send(netlink_fd, &request, request.header.nlmsg_len, 0) < 0)
+    {
+        close(netlink_fd);
+        return -1;
+    }
+
+    // The dump lists the qdiscs of all interfaces, children of mqprio or taprio included
+    int present = 0;
+    bool done = false;
+    std::vector<char> buffer(32768);
+    while (!done)
+    {
+        ssize_t received = recv(netlink_fd, buffer.data(), buffer.size(), 0);
+        if (received <= 0)
+        {
+            present = -1;
+            break;
+        }
+
+        int remaining = static_cast<int>(received);
+        for (struct nlmsghdr* header = reinterpret_cast<struct nlmsghdr*>(buffer.data()); NLMSG_OK(header, remaining); header = NLMSG_NEXT(header, remaining))
+        {
+            if (header->nlmsg_type == NLMSG_DONE)
+            {
+                done = true;
+                break;
+            }
+            if (header->nlmsg_type == NLMSG_ERROR)
+            {
+                present = -1;
+                done = true;
+                break;
+            }
+
+            struct tcmsg* qdisc = reinterpret_cast<struct tcmsg*>(NLMSG_DATA(header));
+            if (qdisc->tcm_ifindex != interface_index)
+            {
+                continue;
+            }
+            int attribute_length = static_cast<int>(header->nlmsg_len - NLMSG_LENGTH(sizeof(struct tcmsg)));
+            for (struct rtattr* attribute = reinterpret_cast<struct rtattr*>(reinterpret_cast<char*>(qdisc) + NLMSG_ALIGN(sizeof(struct tcmsg)));
+                RTA_OK(attribute, attribute_length); attribute = RTA_NEXT(attribute, attribute_length))
+            {
+                if (attribute->rta_type == TCA_KIND && strcmp(static_cast<const char*>(RTA_DATA(attribute)), "etf") == 0)
+                {
+                    present = 1;
+                }
+            }
+        }
+    }
+
+    close(netlink_fd);
+    return present;
+}